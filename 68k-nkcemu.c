@@ -64,6 +64,14 @@
 #include "promer.h"
 #include "sound.h"
 #include "uhr.h"
+#include "mem.h"
+#include "bus.h"
+#include "sched.h"
+#include "throttle.h"
+#include "idle.h"
+#include "lockstep.h"
+#include "irq.h"
+#include "input.h"
 
 /* Read/write macros */
 #define READ_BYTE_68K(BASE, ADDR) (BASE)[ADDR]
@@ -90,9 +98,13 @@ extern flo2 g_flo2;
 extern cas g_cas;
 extern col256 g_col;
 extern gdp64 g_gdp;
+extern gui g_gui;
 extern cent g_cent;
 extern ser g_ser;
 extern promer g_promer;
+extern mem g_mem;
+extern idle g_idle;
+extern lockstep g_lockstep;
 
 int g_start_gp_ram = 0x0E0000;
 
@@ -102,6 +114,36 @@ int g_guiWindowId;
 
 int g_extraSlice = 0;
 
+long long g_frameNanos = 1000000000 / 60;  /* Refresh period of the host display */
+struct timespec g_lastFrame;                /* Last time the GDP64 page was presented */
+struct timespec g_lastPoll;                 /* Last time the events were handled */
+long long g_lastDraw;                       /* Cycle at which the windows were last drawn */
+int g_pollActive;                           /* Polls left at the short period after an input */
+long long g_pollPeriod;                     /* Cycles between two polls */
+
+#define POLL_MICROS        10000            /* SDL events are handled every 10 ms */
+#define POLL_ACTIVE_MICROS 2000             /* and every 2 ms while keys, mouse or joysticks are used */
+#define POLL_ACTIVE_COUNT  250              /* for 0.5 s after the last input */
+
+#define UI_DELAY_MS        2                /* the main thread looks for events and frames every 2 ms */
+
+/*
+ * The main thread owns the SDL windows, it reads the events and presents the
+ * frames. The emulation thread runs the CPU and the devices, handles the
+ * events passed on through the input ring (see input.c) and publishes the
+ * frames through triple buffers (see frame.c). The front panel state they
+ * share is guarded by lock.
+ */
+typedef struct {
+    SDL_mutex *lock;
+    bool drawPanel;                         /* front panel has to be drawn */
+    bool showSpeed;                         /* new speed for the window title */
+    double mhz;
+    bool turbo;
+} ui;
+
+ui g_ui;
+
 /* Prototypes */
 // void exit_error(char *fmt, ...);
 
@@ -125,7 +167,7 @@ void int_controller_clear(unsigned int value);
 // void nkc_reset();
 
 /* Data */
-unsigned int g_quit = 0; /* 1 if we want to quit */
+SDL_atomic_t g_quit;     /* 1 if we want to quit */
 unsigned int g_nmi = 0;  /* 1 if nmi pending */
 
 int g_trace = 0;
@@ -139,9 +181,6 @@ unsigned char g_ram[MAX_RAM + 1];   /* RAM */
 
 unsigned int g_fc; /* Current function code from CPU */
 
-struct timeval oldtime;
-struct timeval oldtime2;
-struct timeval akttime;
 
 /* -------------------------------------------------------------------- */
 /* Helper fuunctions                                                    */
@@ -164,6 +203,7 @@ void termination_handler(int signum)
     flo2_close_drives();
     saveConfig("./config.yaml");
 
+    bus_log_stats();
     log_info( "Final PC=%08x", m68k_get_reg(NULL, M68K_REG_PC));
 
     exit(0);
@@ -211,7 +251,7 @@ void trace()
     g_traceFunc = false;
 
     if (pc > 0xFFFF00)
-        termination_handler(0);
+        SDL_AtomicSet(&g_quit, 1);
 }
 
 void nkc_reset(void)
@@ -255,30 +295,170 @@ void init_windows(bool windowed)
     SDL_RaiseWindow(g_gdp.window);
 }
 
-void handle_event()
+/* Register the I/O ports of the cards without a window. GDP64 and COL256 register in their init. */
+void init_devices()
+{
+    bank_init();
+    key_init();
+    mouse_init();
+    flo2_init();
+    cas_init();
+    ioe_init();
+    cent_init();
+    ser_init();
+    promer_init();
+    uhr_init();
+    sound_init();
+
+    bus_register(COLOR_A0, NULL, bus_null_out);         // Colors used by GRUND, ignored
+    bus_register(COLOR_A1, NULL, bus_null_out);
+    bus_register(UNKNOWN, bus_null_in, bus_null_out);   // used during memory scan, will ignore
+}
+
+/* Pass an event on to the emulation thread, runs on the main thread */
+static void ui_post(SDL_Event *event)
+{
+    if (!input_push(event) && event->type == SDL_USEREVENT)
+        SDL_free(event->user.data1);
+}
+
+/* Pass the clipboard text on to the keyboard, runs on the main thread */
+static void ui_paste()
 {
     SDL_Event event;
-    /* first read Key if available */
-    while (SDL_PollEvent(&event))
+
+    if (SDL_HasClipboardText() != SDL_TRUE)
+        return;
+    memset(&event, 0, sizeof(event));
+    event.type = SDL_USEREVENT;
+    event.user.data1 = SDL_GetClipboardText();
+    ui_post(&event);
+}
+
+/* Handle an SDL event on the main thread, everything besides the windows is done by the emulation thread */
+static void ui_event(SDL_Event *event)
+{
+    if (event->type == SDL_QUIT)
     {
-        if (event.type == SDL_QUIT)
+        SDL_AtomicSet(&g_quit, 1);
+        return;
+    }
+
+    if (event->type == SDL_WINDOWEVENT)
+    {
+        if (event->window.event == SDL_WINDOWEVENT_CLOSE)
         {
-            SDL_Quit();
-            termination_handler(0);
+            SDL_AtomicSet(&g_quit, 1);
+            return;
         }
+    }
+    if (event->window.windowID == g_gdpWindowId)
+    {
+        gdp64_event(event);
+        if (g_gdp.isGuiScreen)
+            gui_window_event(event);
+    }
+    if (event->window.windowID == g_guiWindowId)
+        gui_window_event(event);
+
+    // the clipboard can only be read here, it goes ahead of the Insert key
+    if (event->type == SDL_KEYDOWN && event->key.keysym.sym == SDLK_INSERT && !g_gdp.isGuiScreen)
+        ui_paste();
+    ui_post(event);
+}
+
+/* Set the speed shown in the window title by the main thread */
+static void ui_show_speed(double mhz, bool turbo)
+{
+    SDL_LockMutex(g_ui.lock);
+    g_ui.mhz = mhz;
+    g_ui.turbo = turbo;
+    g_ui.showSpeed = true;
+    SDL_UnlockMutex(g_ui.lock);
+}
 
-        if (event.type == SDL_WINDOWEVENT)
+/* Request a new picture of the front panel from the main thread */
+static void ui_draw_panel()
+{
+    SDL_LockMutex(g_ui.lock);
+    g_ui.drawPanel = true;
+    SDL_UnlockMutex(g_ui.lock);
+}
+
+/* Main thread: read the SDL events and present the frames until we quit */
+static void ui_run()
+{
+    SDL_Event event;
+
+    while (SDL_AtomicGet(&g_quit) == 0)
+    {
+        while (SDL_PollEvent(&event))
+            ui_event(&event);
+        if (SDL_AtomicSet(&g_gui.paste, 0) != 0)
+            ui_paste();
+        if (SDL_AtomicSet(&g_gui.raiseGdp, 0) != 0)
+            SDL_RaiseWindow(g_gdp.window);
+
+        gdp64_show();
+        col_show();
+
+        SDL_LockMutex(g_ui.lock);
+        if (g_ui.drawPanel)
         {
-            if (event.window.event == SDL_WINDOWEVENT_CLOSE)
-            {
-                SDL_Quit();
-                termination_handler(0);
-            }
+            gui_draw();
+            g_ui.drawPanel = false;
         }
-        if (event.window.windowID == g_gdpWindowId)
+        if (g_ui.showSpeed)
         {
-            gdp64_event(&event);
+            gdp64_show_speed(g_ui.mhz, g_ui.turbo);
+            g_ui.showSpeed = false;
+        }
+        SDL_UnlockMutex(g_ui.lock);
+
+        SDL_Delay(UI_DELAY_MS);
+    }
+}
+
+/* The dialogs of the GUI screen change the file names shown on the front panel */
+static void handle_gui_event(SDL_Event *event)
+{
+    SDL_LockMutex(g_ui.lock);
+    gui_event(event);
+    SDL_UnlockMutex(g_ui.lock);
+}
+
+/* Handle the events passed on by the main thread, returns true if there was any input */
+bool handle_event()
+{
+    SDL_Event event;
+    bool input = false;
 
+    while (input_pop(&event))
+    {
+        switch (event.type)
+        {
+        case SDL_KEYDOWN:
+        case SDL_KEYUP:
+        case SDL_JOYAXISMOTION:
+        case SDL_JOYBUTTONDOWN:
+        case SDL_JOYBUTTONUP:
+            input = true;
+            break;
+        case SDL_MOUSEMOTION:
+        case SDL_MOUSEBUTTONDOWN:
+        case SDL_MOUSEBUTTONUP:
+            mouse_event_sdl(&event);
+            input = true;
+            break;
+        }
+
+        if (event.type == SDL_USEREVENT)
+        {
+            key_paste(event.user.data1);
+            continue;
+        }
+        if (event.window.windowID == g_gdpWindowId)
+        {
             if (event.type == SDL_KEYDOWN)
             {
                 /* first evaluate simulation keys */
@@ -295,9 +475,13 @@ void handle_event()
                 {
                     toggle_trace();
                 }
+                if (event.key.keysym.sym == SDLK_F5)
+                {
+                    toggle_turbo();
+                }
             }
             if (g_gdp.isGuiScreen)
-                gui_event(&event);
+                handle_gui_event(&event);
             else
                 key_event(&event);
             if (event.type == SDL_JOYAXISMOTION)
@@ -310,7 +494,7 @@ void handle_event()
             if (!g_gdp.isGuiScreen && event.type == SDL_KEYDOWN)
                 key_event(&event);
             else
-                gui_event(&event);
+                handle_gui_event(&event);
         }
         if( (event.type == SDL_JOYAXISMOTION) ||
             (event.type == SDL_JOYBUTTONDOWN) ||
@@ -319,482 +503,181 @@ void handle_event()
             ioe_event(&event);
         }
     }
+    return input;
 }
 
-/* RAM is hard coded here from 0-512kB, and 32kB after the system EPROMs.                 */
-/* For COL256 16kB memory is mapped to RAM from 0xCC000 to 0xD0000 or 0xEC000 to 0xF0000. */
-bool isRam(unsigned int address)
+/* -------------------------------------------------------------------- */
+/* Memory access through the page table, see mem.c                      */
+/* -------------------------------------------------------------------- */
+static inline unsigned int mem_read_byte(unsigned int address)
 {
-    if (g_bb.bb_enabled)
-        if (address < 0x8000)
-            return false;
-    if (address >= 0x0 && address < 0x80000) // Ram für CP/M (512 K)
-        return true;
-    if ((address >= g_config.col256RAMAddr) && (address < g_config.col256RAMAddr + 0x3FFF) && g_col.col_active) // Ram for Col256
-        return true;
-    if ((address >= g_start_gp_ram) && (address < g_start_gp_ram + 0x8000)) // Ram für das Grundprogramm
-        return true;
-    return false;
+    BYTE_68K *page = g_mem.read[MEM_PAGE(address)];
+
+    if (page != NULL)
+        return READ_BYTE_68K(page, address & MEM_PAGE_MASK);
+    return g_mem.handler[MEM_PAGE(address)]->read_byte(address);
 }
 
-/* Read data from RAM */
-unsigned int cpu_read_byte(unsigned int address)
+static inline unsigned int mem_read_word(unsigned int address)
 {
-    if( g_traceFunc == false )
-        g_extraSlice += g_config.numWaitStates;
-
-    // Read Memory from COL 256
-    if ((address >= g_config.col256RAMAddr) && (address <= g_config.col256RAMAddr + 0x3FFF) && g_col.col_active)
-        return col_getPixel(address);
+    BYTE_68K *page = g_mem.read[MEM_PAGE(address)];
 
-    if (address > 0xffff00)
+    if (page != NULL)
     {
-        switch (address)
-        {
-        case IOE_PORT_A:
-            return ioe_p30_in();
-        case IOE_PORT_B:
-            return ioe_p31_in();
-        case SOUND_ADR:
-        case SOUND_JADOS_ADR:
-            return sound_p40_in();
-        case SOUND_DATA:
-        case SOUND_JADOS_DATA:
-            return sound_p41_in();
-        case CENT_DAT:
-            return cent_p48_in();
-            return 0;
-        case CENT_STB:
-            return cent_p49_in();
-            return 0;
-        case KEY_DATA:
-            return key_p68_in();
-        case KEY_DIP:
-            return key_p69_in();
-        case GDP_PAGE:
-            return gdp64_p60_in();
-        case GDP_SCROLL:
-            return gdp64_p61_in();
-        case GDP_CMD:
-            return gdp64_p70_in();
-        case GDP_CMD + 1:
-            return gdp64_p71_in();
-        case GDP_CMD + 2:
-            return gdp64_p72_in();
-        case GDP_CMD + 3:
-            return gdp64_p73_in();
-        case GDP_CMD + 4:
-            return 0;
-        case GDP_CMD + 5:
-            return gdp64_p75_in();
-        case GDP_CMD + 6:
-            return 0;
-        case GDP_CMD + 7:
-            return gdp64_p77_in();
-        case GDP_CMD + 8:
-            return gdp64_p78_in();
-        case GDP_CMD + 9:
-            return gdp64_p79_in();
-        case GDP_CMD + 10:
-            return gdp64_p7A_in();
-        case GDP_CMD + 11:
-            return gdp64_p7B_in();
-        case GDP_CMD + 12:
-            return 0;
-        case GDP_CMD + 13:
-            return 0;
-        case GDP_CMD + 14:
-            return 0;
-        case GDP_CMD + 15:
-            return 0;
-        case PROM_DAT:
-            return promer_p80_in();
-        case PROM_A1:
-            return promer_p81_in();
-        case PROM_A2:
-            return promer_p82_in();
-        // case MAUS_HIX:
-        //     return mouse_p88_in();
-        case MAUS_LOX:
-            return mouse_p89_in();
-        case MAUS_HIY:
-            return mouse_p8A_in();
-        case MAUS_LOY:
-            return mouse_p8B_in();
-        case MAUS_UP:
-            return mouse_p8C_in();
-        case MAUS_DOWN:
-            return mouse_p8D_in();
-        case MAUS_RIGHT:
-            return mouse_p8E_in();
-        case MAUS_LEFT:
-            return mouse_p8F_in();
-        case FLO2_CMD:
-            return flo2_pC0_in();
-        case FLO2_TRACK:
-            return flo2_pC1_in();
-        case FLO2_SECT:
-            return flo2_pC2_in();
-        case FLO2_DATA:
-            return flo2_pC3_in();
-        case FLO2_ADDI:
-            return flo2_pC4_in();
-        case BANKBOOT:
-            log_debug("Reading BANKBOOT register %#010x", address);
-            return bank_pC8_in();
-        case CAS_CMD:
-            return cas_pCA_in();
-        case CAS_DATA:
-            return cas_pCB_in();
-        case COL_ADDR:
-        case COL_JADOS_ADDR:
-            return col_pCC_in();
-        case COL_DATA:
-        case COL_JADOS_DATA:
-            return col_pCD_in();
-        case COL_PAGE:
-        case COL_JADOS_PAGE:
-            return col_pCE_in();
-        case SER_DATA:
-            return ser_pF0_in();
-        case SER_STATUS:
-            return ser_pF1_in();
-        case SER_CMD:
-            return ser_pF2_in();
-        case SER_CNTL:
-            return ser_pF3_in();
-        case UHR_DATA:
-            return uhr_pFE_in();
-        case UNKNOWN:
-            return 0;
-        default:
-            log_debug("I/O byte read from UNKNOWN address %#010x", address);
-            break;
-        }
+        if ((address & MEM_PAGE_MASK) <= MEM_PAGE_SIZE - 2)
+            return READ_WORD_68K(page, address & MEM_PAGE_MASK);
+        return (mem_read_byte(address) << 8) | mem_read_byte(address + 1);
     }
+    return g_mem.handler[MEM_PAGE(address)]->read_word(address);
+}
 
-    if (g_bb.bb_enabled && address <= 0x2000)
-        return READ_BYTE_68K(g_rom, address);
-    else
-    {
-        if (address <= MAX_RAM)     // HINT: g_ram contains RAM and standard ROMs, g_rom only Bankboot rom
-            return READ_BYTE_68K(g_ram, address);
-        else
-            return 0xFF;
+static inline unsigned int mem_read_long(unsigned int address)
+{
+    BYTE_68K *page = g_mem.read[MEM_PAGE(address)];
 
+    if (page != NULL)
+    {
+        if ((address & MEM_PAGE_MASK) <= MEM_PAGE_SIZE - 4)
+            return READ_LONG_68K(page, address & MEM_PAGE_MASK);
+        return (mem_read_word(address) << 16) | mem_read_word(address + 2);
     }
+    return g_mem.handler[MEM_PAGE(address)]->read_long(address);
 }
 
-unsigned int cpu_read_word(unsigned int address)
+static inline void mem_write_byte(unsigned int address, unsigned int value)
 {
-    if( g_traceFunc == false )
-        g_extraSlice += (4 + (2 * g_config.numWaitStates));
+    BYTE_68K *page = g_mem.write[MEM_PAGE(address)];
 
-    if (g_bb.bb_enabled && address <= 0x2000)
-        return READ_WORD_68K(g_rom, address);
+    if (page != NULL)
+        WRITE_BYTE_68K(page, address & MEM_PAGE_MASK, value);
+    else
+        g_mem.handler[MEM_PAGE(address)]->write_byte(address, value);
+}
 
-    if (address > 0xffff00)
+static inline void mem_write_word(unsigned int address, unsigned int value)
+{
+    BYTE_68K *page = g_mem.write[MEM_PAGE(address)];
+
+    if (page == NULL)
+        g_mem.handler[MEM_PAGE(address)]->write_word(address, value);
+    else if ((address & MEM_PAGE_MASK) <= MEM_PAGE_SIZE - 2)
     {
-        switch (address)
-        {
-        case GDP_CMD + 8:
-            return gdp64_p78_in_word();
-        case GDP_CMD + 10:
-            return gdp64_p7A_in_word();
-        default:
-            log_debug("I/O word read from UNKNOWN address %#010x", address);
-            break;
-        }
+        WRITE_WORD_68K(page, address & MEM_PAGE_MASK, value);
+    }
+    else
+    {
+        mem_write_byte(address, value >> 8);
+        mem_write_byte(address + 1, value);
     }
+}
 
-    // Read Memory from COL 256
-    if ((address >= g_config.col256RAMAddr) && (address <= g_config.col256RAMAddr + 0x3FFF) && g_col.col_active)
-        return col_getWord(address);
+static inline void mem_write_long(unsigned int address, unsigned int value)
+{
+    BYTE_68K *page = g_mem.write[MEM_PAGE(address)];
 
-    if(address <= MAX_RAM)
-        return READ_WORD_68K(g_ram, address);
+    if (page == NULL)
+        g_mem.handler[MEM_PAGE(address)]->write_long(address, value);
+    else if ((address & MEM_PAGE_MASK) <= MEM_PAGE_SIZE - 4)
+    {
+        WRITE_LONG_68K(page, address & MEM_PAGE_MASK, value);
+    }
     else
-        return 0xFFFF;
+    {
+        mem_write_word(address, value >> 16);
+        mem_write_word(address + 2, value);
+    }
 }
 
-unsigned int cpu_read_long(unsigned int address)
+/* Read data from RAM */
+unsigned int cpu_read_byte(unsigned int address)
 {
     if( g_traceFunc == false )
-        g_extraSlice += (8 + (4 * g_config.numWaitStates));
+        g_extraSlice += g_config.numWaitStates;
+    if (g_lockstep.mode == LOCKSTEP_REFERENCE)
+        return lockstep_read(address, 1);
+    if (g_lockstep.mode == LOCKSTEP_FAST)
+        lockstep_access(address, 1);
 
-    if (g_bb.bb_enabled && address <= 0x2000)
-        return READ_LONG_68K(g_rom, address);
+    return mem_read_byte(address);
+}
 
-    if (address > 0xffff00)
-    {
-        switch (address)
-        {
-        default:
-            log_debug("I/O long read from UNKNOWN address %#010x", address);
-            break;
-        }
-    }
+unsigned int cpu_read_word(unsigned int address)
+{
+    if( g_traceFunc == false )
+        g_extraSlice += (4 + (2 * g_config.numWaitStates));
+    if (g_lockstep.mode == LOCKSTEP_REFERENCE)
+        return lockstep_read(address, 2);
+    if (g_lockstep.mode == LOCKSTEP_FAST)
+        lockstep_access(address, 2);
 
-    // Read Memory from COL 256
-    if ((address >= g_config.col256RAMAddr) && (address <= g_config.col256RAMAddr + 0x3FFF) && g_col.col_active)
-        return col_getLong(address);
+    return mem_read_word(address);
+}
 
-    // if(address >= 0x000064 && address <= 0x00007C) {
-    //     log_debug("Reading 68000 interrupt vector %08X,  %08X", address, READ_LONG_68K(g_ram, address));
-    // }
+unsigned int cpu_read_long(unsigned int address)
+{
+    if( g_traceFunc == false )
+        g_extraSlice += (8 + (4 * g_config.numWaitStates));
+    if (g_lockstep.mode == LOCKSTEP_REFERENCE)
+        return lockstep_read(address, 4);
+    if (g_lockstep.mode == LOCKSTEP_FAST)
+        lockstep_access(address, 4);
 
-    if(address <= MAX_RAM)
-        return READ_LONG_68K(g_ram, address);
-    else
-        return 0xFFFFFFFF;
+    return mem_read_long(address);
 }
 
 /* Write data to RAM or a device */
+/* Hash of the written addresses and values for the idle loop detection */
+static inline void idle_write(unsigned int address, unsigned int value)
+{
+    g_idle.writeHash = (g_idle.writeHash * 31 + address) * 31 + value;
+}
+
 void cpu_write_byte(unsigned int address, unsigned int value)
 {
     if( g_traceFunc == false )
         g_extraSlice += g_config.numWaitStates;
-
-    // Set Pixel in COL256 memory
-    if ((address >= g_config.col256RAMAddr) && (address <= g_config.col256RAMAddr + 0x3FFF) && g_col.col_active)
-        col_setPixel(address, value & 0xff);
-
-    if (address > 0xffff00)
+    if (g_lockstep.mode == LOCKSTEP_REFERENCE)
     {
-        switch (address)
-        {
-        case IOE_PORT_A:
-            ioe_p30_out(value & 0xff);
-            return;
-        case IOE_PORT_B:
-            ioe_p31_out(value & 0xff);
-            return;
-        case SOUND_ADR:
-        case SOUND_JADOS_ADR:
-            sound_p40_out(value & 0xff);
-            return;
-        case SOUND_DATA:
-        case SOUND_JADOS_DATA:
-            sound_p41_out(value & 0xff);
-            return;
-        case CENT_DAT:
-            cent_p48_out(value & 0xff);
-            return;
-        case CENT_STB:
-            cent_p49_out(value & 0xff);
-            return;
-        case KEY_DATA:
-            key_p68_out(value & 0xff);
-            return;
-        case COLOR_A0:
-        case COLOR_A1:
-            return;
-        case KEY_DIP:
-            key_p69_out(value & 0xff);
-            return;
-        case GDP_PAGE:
-            gdp64_p60_out(value & 0xff);
-            return;
-        case GDP_SCROLL:
-            gdp64_p61_out(value & 0xff);
-            return;
-        case GDP_CMD:               // Status register
-            gdp64_p70_out(value & 0xff);
-            return;
-        case GDP_CMD + 1:           // CTRL1 register
-            gdp64_p71_out(value & 0xff);
-            return;
-        case GDP_CMD + 2:           // CTRL2 register
-            gdp64_p72_out(value & 0xff);
-            return;
-        case GDP_CMD + 3:           // CSIZE register
-            gdp64_p73_out(value & 0xff);
-            return;
-        case GDP_CMD + 4:           // NOT USED
-            return;
-        case GDP_CMD + 5:           // DELTAX register
-            gdp64_p75_out(value & 0xff);
-            return;
-        case GDP_CMD + 6:           // NOT USED
-            return;
-        case GDP_CMD + 7:           // DELTAY register
-            gdp64_p77_out(value & 0xff);
-            return;
-        case GDP_CMD + 8:           // X register MSB
-            gdp64_p78_out(value & 0xff);
-            return;
-        case GDP_CMD + 9:           // X register LSB
-            gdp64_p79_out(value & 0xff);
-            return;
-        case GDP_CMD + 10:          // Y register MSB
-            gdp64_p7A_out(value & 0xff);
-            return;
-        case GDP_CMD + 11:          // Y register LSB
-            gdp64_p7B_out(value & 0xff);
-            return;
-        case GDP_CMD + 12:          // X-Lghtpen
-        case GDP_CMD + 13:          // Y-Lightpen
-        case GDP_CMD + 14:          // NOT USED
-        case GDP_CMD + 15:          // NOT USED
-            return;
-        case PROM_DAT:
-            promer_p80_out(value & 0xff);
-            return;
-        case PROM_A1:
-            promer_p81_out(value & 0xff);
-            return;
-        case PROM_A2:
-            promer_p82_out(value & 0xff);
-            return;
-        case MAUS_HIX:
-            mouse_p88_out(value & 0xff);
-            return;
-        case MAUS_LOX:
-            mouse_p89_out(value & 0xff);
-            return;
-        case MAUS_HIY:
-            mouse_p8A_out(value & 0xff);
-            return;
-        case MAUS_LOY:
-            mouse_p8B_out(value & 0xff);
-            return;
-        // case MAUS_UP:
-        //     mouse_p8C_out(value & 0xff);
-        //     return;
-        case MAUS_DOWN:
-            mouse_p8D_out(value & 0xff);
-            return;
-        case MAUS_RIGHT:
-            mouse_p8E_out(value & 0xff);
-            return;
-        // case MAUS_LEFT:
-        //     mouse_p8F_out(value & 0xff);
-        //     return;
-        case FLO2_CMD:
-            flo2_pC0_out(value & 0xff);
-            return;
-        case FLO2_TRACK:
-            flo2_pC1_out(value & 0xff);
-            return;
-        case FLO2_SECT:
-            flo2_pC2_out(value & 0xff);
-            return;
-        case FLO2_DATA:
-            flo2_pC3_out(value & 0xff);
-            return;
-        case FLO2_ADDI:
-            flo2_pC4_out(value & 0xff);
-            return;
-        case BANKBOOT:
-            bank_pC8_out(value & 0xff);
-            return;
-        case CAS_CMD:
-            cas_pCA_out(value & 0xff);
-            return;
-        case CAS_DATA:
-            cas_pCB_out(value & 0xff);
-            return;
-        case COL_ADDR:
-        case COL_JADOS_ADDR:
-            col_pCC_out(value & 0xff);
-            return;
-        case COL_DATA:
-        case COL_JADOS_DATA:
-            col_pCD_out(value & 0xff);
-            return;
-        case COL_PAGE:
-        case COL_JADOS_PAGE:
-            col_pCE_out(value & 0xff);
-            return;
-        case SER_DATA:
-            ser_pF0_out(value & 0xff);
-            return;
-        case SER_STATUS:
-            ser_pF1_out(value & 0xff);
-            return; 
-        case SER_CMD:
-            ser_pF2_out(value & 0xff);
-            return;
-        case SER_CNTL:  
-            ser_pF3_out(value & 0xff);
-            return;
-        case UHR_DATA:
-            uhr_pFE_out(value & 0xff);
-            return;
-        case UNKNOWN:
-            return;
-        default:
-            log_debug("I/O byte write to UNKNOWN address %#010x = %04x", address, value);
-            break;
-        }
+        lockstep_write_reference(address, 1, value);
+        return;
     }
+    idle_write(address, value);
 
-    if (isRam(address))
-    {
-        WRITE_BYTE_68K(g_ram, address, value);
-    }
+    mem_write_byte(address, value);
+    if (g_lockstep.mode != LOCKSTEP_OFF)
+        lockstep_written(address, 1, value);
 }
 
 void cpu_write_word(unsigned int address, unsigned int value)
 {
     if( g_traceFunc == false )
         g_extraSlice += (4 + (2 * g_config.numWaitStates));
-
-    if (address > 0xffff00)
+    if (g_lockstep.mode == LOCKSTEP_REFERENCE)
     {
-        switch (address)
-        {
-        case GDP_CMD+2:             // X register
-            gdp64_p72_out_word(value);
-            return;
-        case GDP_CMD+8:             // X register
-            gdp64_p78_out_word(value);
-            return;
-        case GDP_CMD+10:            // Y register
-            gdp64_p7A_out_word(value);
-            return;
-        default:
-            log_info("I/O word write to UNKNOWN address %#010x = %06x", address, value);
-            break;
-        }
+        lockstep_write_reference(address, 2, value);
+        return;
     }
+    idle_write(address, value);
 
-    if (isRam(address))
-    {
-        // Set Word in COL256 memory
-
-        if ((address >= g_config.col256RAMAddr) && (address <= g_config.col256RAMAddr + 0x3FFF) && g_col.col_active)
-            col_setWord(address, value);
-
-        WRITE_WORD_68K(g_ram, address, value);
-    }
+    mem_write_word(address, value);
+    if (g_lockstep.mode != LOCKSTEP_OFF)
+        lockstep_written(address, 2, value);
 }
 
 void cpu_write_long(unsigned int address, unsigned int value)
 {
     if( g_traceFunc == false )
         g_extraSlice += (8 + (4 * g_config.numWaitStates));
-
-    if (address > 0xffff00)
+    if (g_lockstep.mode == LOCKSTEP_REFERENCE)
     {
-        switch (address)
-        {
-        default:
-            log_debug("I/O long write to UNKNOWN address %#010x = %08x", address, value);
-            break;
-        }
+        lockstep_write_reference(address, 4, value);
+        return;
     }
+    idle_write(address, value);
 
-    if (isRam(address))
-    {
-        // Set Word in COL256 memory
-        if ((address >= g_config.col256RAMAddr) && (address <= g_config.col256RAMAddr + 0x3FFF) && g_col.col_active)
-            col_setLong(address, value);
-        else
-            WRITE_LONG_68K(g_ram, address, value);
-    }
-    else
-        return;
+    mem_write_long(address, value);
+    if (g_lockstep.mode != LOCKSTEP_OFF)
+        lockstep_written(address, 4, value);
 }
 
 /* Called when the CPU pulses the RESET line */
@@ -822,6 +705,58 @@ void cpu_set_fc(unsigned int fc)
     g_fc = fc;
 }
 
+/* Called by the CPU before it caches the instructions of a page */
+const unsigned char *cpu_block_page(unsigned int address)
+{
+    return g_config.blockCache ? mem_protect_code(address) : NULL;
+}
+
+/* Charge the words an instruction replayed from the cache read without cpu_read_word() */
+void cpu_fetch_skipped(unsigned int words)
+{
+    if( g_traceFunc == false )
+        g_extraSlice += words * (4 + (2 * g_config.numWaitStates));
+}
+
+/* Wait states of a data access of size bytes, as charged by cpu_read_byte() and friends */
+static inline unsigned int access_waits(unsigned int size)
+{
+    if (size == 1)
+        return g_config.numWaitStates;
+    if (size == 2)
+        return 4 + (2 * g_config.numWaitStates);
+    return 8 + (4 * g_config.numWaitStates);
+}
+
+/* Run count iterations of a copy loop of the CPU at once, returns 0 if it has to run as usual */
+int cpu_block_copy(unsigned int dst, unsigned int src, unsigned int size, unsigned int count, unsigned int *last)
+{
+    unsigned int address = dst + (count - 1) * size;
+
+    if (!mem_copy(dst, src, size * count))
+        return 0;
+    if( g_traceFunc == false )
+        g_extraSlice += 2 * count * access_waits(size);
+    *last = size == 1 ? mem_read_byte(address) : size == 2 ? mem_read_word(address) : mem_read_long(address);
+    idle_write(dst, count);
+    if (g_lockstep.mode != LOCKSTEP_OFF)
+        lockstep_block_written(dst, size, count);
+    return 1;
+}
+
+/* Run count iterations of a fill loop of the CPU at once, returns 0 if it has to run as usual */
+int cpu_block_fill(unsigned int dst, unsigned int value, unsigned int size, unsigned int count)
+{
+    if (!mem_fill(dst, value, size, count))
+        return 0;
+    if( g_traceFunc == false )
+        g_extraSlice += count * access_waits(size);
+    idle_write(dst, count);
+    if (g_lockstep.mode != LOCKSTEP_OFF)
+        lockstep_block_written(dst, size, count);
+    return 1;
+}
+
 unsigned int m68k_read_disassembler_16(unsigned int address)
 {
     return cpu_read_word(address);
@@ -881,47 +816,83 @@ void list(int start, int end)
     }
 }
 
-void cpu_instr_callback(int pc)
+/*
+ * In turbo mode the emulated VSYNC comes much faster than the host display
+ * can show it, so frames and event handling are limited to its refresh rate.
+ */
+static bool frame_due(struct timespec *last)
 {
-    int diff, diff2;
+    struct timespec now;
 
-    gettimeofday(&akttime, NULL);
-    diff = nkc_get_diff_micros(&oldtime, &akttime);
-    diff2 = nkc_get_diff_micros(&oldtime2, &akttime);
-    if (diff >= 20000)
-    {
-        gdp64_set_vsync(1);
-        //    gettimeofday(&akttime, NULL);
-        gettimeofday(&oldtime, NULL);
-        if(g_config.setINT == TRUE && g_config.setNMI == TRUE && g_nmi == 0 ) {
-            m68k_set_irq(M68K_IRQ_7);
-            g_nmi = 1;
-        }
-        if(g_config.setINT == TRUE && g_config.setNMI == FALSE) {
-            m68k_set_irq(M68K_IRQ_5);
-        }
+    if (g_config.simSpeed != 0)
+        return true;
+    clock_gettime( CLOCK_MONOTONIC, &now);
+    if (nkc_get_diff_nanos(last, &now) < g_frameNanos)
+        return false;
+    *last = now;
+    return true;
+}
+
+/* End of the VSYNC pulse, 1472 us after it started */
+static void vsync_end()
+{
+    gdp64_set_vsync(0);
+    g_nmi = 0;
+    if(g_config.setINT == TRUE && g_config.setNMI == FALSE)
+        irq_set(0);
+}
+
+/* Start of the VSYNC pulse, every 20 ms */
+static void vsync_start()
+{
+    gdp64_set_vsync(1);
+    if (frame_due(&g_lastFrame))
+        gdp64_present();
+    if(g_config.setINT == TRUE && g_config.setNMI == TRUE && g_nmi == 0 ) {
+        irq_set(M68K_IRQ_7);
+        g_nmi = 1;
     }
-    else if (diff >= 1472 )        // 1472000 ns
-    {
-        gdp64_set_vsync(0);
-        g_nmi = 0;
-        if(g_config.setINT == TRUE && g_config.setNMI == FALSE)
-            m68k_set_irq(0);
+    // As long as we are in the VSYNC period, the lower level interrupt is set
+    if(g_config.setINT == TRUE && g_config.setNMI == FALSE) {
+        irq_set(M68K_IRQ_5);
     }
-    else    	            // As long as we are in the VSYNC period, the lower level interrupt is set
+    sched_add(SCHED_VSYNC_END, sched_cycles(1472), vsync_end);      // 1472000 ns
+}
+
+// Process events, more often while there is input, and draw the windows every 10 ms
+static void poll_events()
+{
+    if (!frame_due(&g_lastPoll))
+        return;
+    if (handle_event())
+        g_pollActive = POLL_ACTIVE_COUNT;
+    if (sched_now() - g_lastDraw >= sched_cycles(POLL_MICROS))
     {
-        if(g_config.setINT == TRUE && g_config.setNMI == FALSE)
-            m68k_set_irq(M68K_IRQ_5);
+        g_lastDraw = sched_now();
+        ui_draw_panel();
+        col_draw();
     }
+    if (g_pollActive > 0)
+        g_pollActive--;
 
-    // Process events but only every 10 ms
-    if (diff2 >= 10000)
+    long long period = sched_cycles(g_pollActive > 0 ? POLL_ACTIVE_MICROS : POLL_MICROS);
+    if (period != g_pollPeriod)
     {
-        handle_event();
-        gui_draw();
-        col_draw();
-        gettimeofday(&oldtime2, NULL);
+        g_pollPeriod = period;
+        sched_periodic(SCHED_POLL, period, poll_events);
+    }
+}
+
+void toggle_turbo()
+{
+    if( g_config.simSpeed == 0) {
+        g_config.simSpeed = 1;
+        throttle_init();        // Start throttling from now on
+    } else {
+        g_config.simSpeed = 0;
     }
+    log_info("Turbo mode %s", g_config.simSpeed == 0 ? "on" : "off");
+    return;
 }
 
 void toggle_trace()
@@ -933,52 +904,19 @@ void toggle_trace()
     return;
 }
 
-/* The main loop */
-int main(int argc, char **argv)
+/* The emulation thread, runs the CPU and the devices until we quit */
+static int emulate(void *data)
 {
-    putchar('\n');
-    puts("NDR-Klein-Computer 68K Simulator V0.9");
-    puts("=====================================");
-    puts("based on 68000 emulator 'Musashi'");
-    puts("by Martin Merck");
-    putchar('\n');
-    fflush(stdout);
-    g_bb.bb_enabled = true;
-
-    readConfig("./config.yaml");
-    init_windows(true);
-
-    cas_setFile(g_config.casFile);
-    cent_setFile(g_config.listFile);
-    promer_setFile(g_config.promFile);
-
-    load_roms();
-
-    // nkc
-    m68k_init();
-    m68k_set_cpu_type(M68K_CPU_TYPE_68000);
-
-    m68k_pulse_reset();
-    cpu_pulse_reset();
-    //nmi_device_reset();
-    gettimeofday(&oldtime, NULL);
-    gettimeofday(&oldtime2, NULL);
-    gettimeofday(&akttime, NULL);
-
-    struct timeval starttime;
-    struct timeval endtime;
-
     struct timespec start;
     struct timespec end;
     long long simNanos = 0;
     long long realNanos = 0;
+    long long titleSimNanos = 0;
+    long long titleRealNanos = 0;
 
-    struct timespec res;
-
-    long long extraNanos = 0;
-
-    clock_gettime( CLOCK_REALTIME, &start);
-    while (true)
+    clock_gettime( CLOCK_MONOTONIC, &start);
+    throttle_init();
+    while (SDL_AtomicGet(&g_quit) == 0)
     {
         int slices;
 
@@ -988,46 +926,47 @@ int main(int argc, char **argv)
             SDL_Delay(100);
         }
 
-        //    m68k_execute(g_trace ? 1 : 1000); // execute 10,000 MC68000 instructions
         if (!g_gdp.isGuiScreen) // Stop Simulation if GUI screen
         {
             if( g_trace == true)
             {
-                slices = m68k_execute(1); // execute 1 MC68000 instructions
+                slices = sched_execute(1); // execute 1 MC68000 instructions
             } else {
-                slices = m68k_execute(10000); // execute 10,000 MC68000 cpu cylcles ()
+                // run up to the next device event, throttled in short slices to keep the pace
+                slices = sched_execute(sched_slice(sched_cycles(g_config.simSpeed != 0 ? SCHED_SLICE_MICROS
+                                                                                         : SCHED_TURBO_MICROS)));
             }
 
-            long long motorolaNanos = (slices + g_extraSlice) * (1000 / g_config.cpuSpeed);
-            g_extraSlice = 0;
+            long long motorolaNanos = slices * (1000 / g_config.cpuSpeed);
             realNanos += motorolaNanos;
-            clock_gettime( CLOCK_REALTIME, &end);
-            long long elapsedNanos = nkc_get_diff_nanos(&start, &end);
+            titleRealNanos += motorolaNanos;
+            if(g_config.simSpeed != 0)
+                throttle_wait(motorolaNanos);
 
-            if(elapsedNanos > motorolaNanos)
-            {
-                extraNanos += elapsedNanos - motorolaNanos;
-            }
-            else
-            {
-                if(g_config.simSpeed != 0) {
-                    long long sleepNanos = motorolaNanos - elapsedNanos - extraNanos;
-                    if( sleepNanos < 0) {
-                        extraNanos += sleepNanos;
-                    } else {
-                        nkc_sleep_nanos(sleepNanos);
-                        extraNanos = 0;
-                    }
-                }
-            }
-            clock_gettime( CLOCK_REALTIME, &end);
-            elapsedNanos = nkc_get_diff_nanos(&start, &end);
-            clock_gettime( CLOCK_REALTIME, &start);
+            clock_gettime( CLOCK_MONOTONIC, &end);
+            long long elapsedNanos = nkc_get_diff_nanos(&start, &end);
             simNanos += elapsedNanos;
+            titleSimNanos += elapsedNanos;
+            start = end;
         }
         else
         {
-            cpu_instr_callback(0); /// but call callback to handle screen and events
+            // Blink the cursor and show the GUI screen
+            gdp64_set_vsync(1);
+            gdp64_present();
+            poll_events(); /// but handle screen and events
+            ui_draw_panel();        // the emulated time stands still, draw at the host pace
+            col_draw();
+            SDL_Delay(20);
+            clock_gettime( CLOCK_MONOTONIC, &start);
+        }
+
+        if( titleSimNanos > 1000000000 )
+        {
+            ui_show_speed((double) titleRealNanos / (double) titleSimNanos * g_config.cpuSpeed,
+                          g_config.simSpeed == 0);
+            titleRealNanos = 0;
+            titleSimNanos = 0;
         }
 
         if( simNanos > 10000000000 )
@@ -1037,7 +976,72 @@ int main(int argc, char **argv)
             simNanos = 0;
 
             log_info("Simulated CPU Speed (MHz): %4.2lf",speed * g_config.cpuSpeed);
+            throttle_log_stats();
+            idle_log_stats();
+            irq_log_stats();
+            input_log_stats();
+            gdp64_log_stats();
+            lockstep_log_stats();
         }
     }
     return 0;
 }
+
+/* The main thread */
+int main(int argc, char **argv)
+{
+    putchar('\n');
+    puts("NDR-Klein-Computer 68K Simulator V0.9");
+    puts("=====================================");
+    puts("based on 68000 emulator 'Musashi'");
+    puts("by Martin Merck");
+    putchar('\n');
+    fflush(stdout);
+    g_bb.bb_enabled = true;
+
+    readConfig("./config.yaml");
+    if (g_config.deterministic)
+        log_info("Deterministic mode, device time is derived from the emulated CPU cycles");
+    init_windows(true);
+    init_devices();
+
+    SDL_DisplayMode mode;
+    if (SDL_GetCurrentDisplayMode(SDL_GetWindowDisplayIndex(g_gdp.window), &mode) == 0 && mode.refresh_rate > 0)
+        g_frameNanos = 1000000000LL / mode.refresh_rate;
+
+    cas_setFile(g_config.casFile);
+    cent_setFile(g_config.listFile);
+    promer_setFile(g_config.promFile);
+
+    load_roms();
+    mem_init(bus_handler());
+
+    // nkc
+    m68k_init();
+    m68k_set_cpu_type(M68K_CPU_TYPE_68000);
+    m68k_set_jit_threshold(g_config.blockCache && g_config.jit ? g_config.jitThreshold : 0);
+    if (g_config.lockstep)
+        lockstep_init();
+
+    m68k_pulse_reset();
+    cpu_pulse_reset();
+    //nmi_device_reset();
+    sched_init();
+    idle_init();
+    irq_init();
+    input_init();
+    sched_periodic(SCHED_VSYNC, sched_cycles(20000), vsync_start);
+    g_pollPeriod = sched_cycles(POLL_MICROS);
+    sched_periodic(SCHED_POLL, g_pollPeriod, poll_events);
+
+    g_ui.lock = SDL_CreateMutex();
+    SDL_Thread *emulation = g_ui.lock != NULL ? SDL_CreateThread(emulate, "emulation", NULL) : NULL;
+    if (emulation == NULL)
+        exit_error("Can't start the emulation thread. Error: %s", SDL_GetError());
+    ui_run();
+
+    SDL_WaitThread(emulation, NULL);
+    SDL_Quit();
+    termination_handler(0);
+    return 0;
+}
@@ -98,8 +98,12 @@ extern "C"
     void cpu_write_long(unsigned int address, unsigned int value);
     void cpu_pulse_reset(void);
     void cpu_set_fc(unsigned int fc);
-    void cpu_instr_callback(int pc);
+    const unsigned char *cpu_block_page(unsigned int address);
+    void cpu_fetch_skipped(unsigned int words);
+    int cpu_block_copy(unsigned int dst, unsigned int src, unsigned int size, unsigned int count, unsigned int *last);
+    int cpu_block_fill(unsigned int dst, unsigned int value, unsigned int size, unsigned int count);
     void toggle_trace();
+    void toggle_turbo();
 
 #ifdef __cplusplus
 }
@@ -331,6 +331,26 @@ int m68k_cycles_remaining(void);        /* Number of cycles left */
 void m68k_modify_timeslice(int cycles); /* Modify cycles left */
 void m68k_end_timeslice(void);          /* End timeslice now */
 
+/* Invalidate the cached instruction traces of the code page containing
+ * address, or of all pages.  You must enable M68K_BLOCK_CACHE in m68kconf.h.
+ * The host calls m68k_block_invalidate() when a page it allowed to be cached
+ * is written and m68k_block_flush() when the memory map changes.
+ */
+void m68k_block_invalidate(unsigned int address);
+void m68k_block_flush(void);
+
+/* Compile traces to host code once they were replayed threshold times,
+ * 0 turns the compiler off.  Only available on x86-64 hosts with M68K_JIT
+ * enabled in m68kconf.h, otherwise the call is ignored.
+ */
+void m68k_set_jit_threshold(unsigned int threshold);
+
+/* Run the reference interpreter after every replayed trace and hand both
+ * results to the host for comparison.  You must enable M68K_LOCKSTEP in
+ * m68kconf.h.  This is a debugging aid and much slower than the interpreter.
+ */
+void m68k_set_lockstep(int enable);
+
 /* Set the IPL0-IPL2 pins on the CPU (IRQ).
  * A transition from < 7 to 7 will cause a non-maskable interrupt (NMI).
  * Setting IRQ to 0 will clear an interrupt request.
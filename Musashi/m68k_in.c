@@ -115,6 +115,9 @@ void m68ki_build_opcode_table(void);
 extern void (*m68ki_instruction_jump_table[0x10000])(void); /* opcode handler jump table */
 extern unsigned char m68ki_cycles[][0x10000];
 
+/* Fused handler of an instruction followed by another one or NULL */
+void (*m68ki_fusion_handler(unsigned int first, unsigned int second))(void);
+
 
 /* ======================================================================== */
 /* ============================== END OF FILE ============================= */
@@ -136,6 +139,8 @@ M68KMAKE_TABLE_HEADER
 
 #define NUM_CPU_TYPES 5
 
+#if !M68K_COMPACT_DISPATCH
+
 void  (*m68ki_instruction_jump_table[0x10000])(void); /* opcode handler jump table */
 unsigned char m68ki_cycles[NUM_CPU_TYPES][0x10000]; /* Cycles used by CPU type */
 
@@ -268,6 +273,56 @@ void m68ki_build_opcode_table(void)
 		ostruct++;
 	}
 }
+#else
+/* The compact tables below are generated complete */
+void m68ki_build_opcode_table(void)
+{
+}
+#endif /* !M68K_COMPACT_DISPATCH */
+
+
+
+XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+M68KMAKE_FUSION_HEADER
+
+/* ======================================================================== */
+/* ============================= FUSED PAIRS ============================== */
+/* ======================================================================== */
+
+/* A handler running two instructions, used by the trace cache */
+typedef struct
+{
+	void (*first_handler)(void);         /* handler of the first instruction */
+	void (*second_handler)(void);        /* handler of the instruction after it */
+	void (*fused_handler)(void);         /* handler running both */
+} fusion_handler_struct;
+
+
+/* Fused handler table */
+static const fusion_handler_struct m68k_fusion_handler_table[] =
+{
+/*   first                         second                         fused */
+
+
+
+XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+M68KMAKE_FUSION_FOOTER
+
+	{0, 0, 0}
+};
+
+
+/* Look up the fused handler of two instructions */
+void (*m68ki_fusion_handler(unsigned int first, unsigned int second))(void)
+{
+	const fusion_handler_struct *fstruct;
+
+	for(fstruct = m68k_fusion_handler_table; fstruct->fused_handler != NULL; fstruct++)
+		if(m68ki_opcode_handler(first) == fstruct->first_handler &&
+		   m68ki_opcode_handler(second) == fstruct->second_handler)
+			return fstruct->fused_handler;
+	return NULL;
+}
 
 
 /* ======================================================================== */
@@ -898,6 +953,62 @@ unpk      16  mm    .     1000...110001...  ..........  . . U U U   .   .  13  1
 
 
 
+XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+M68KMAKE_FUSION_BODY
+
+The following table lists pairs of opcode handlers, by their generated name
+without the m68k_op_ prefix, which get a fused handler.  When the trace cache
+records the second instruction right after the first one, both are replayed
+through the fused handler: one dispatch, and the condition codes set by the
+first instruction are still in registers when the second one tests them.
+
+The first handler must not change the program flow.  The second one runs only
+if the first one left cycles in the time slice and the page was not written,
+so the CPU does exactly what two separate handlers would have done.
+
+The pairs come from a profile of the handler pairs run while the
+Grundprogramm boots CP/M and lists a directory, and from the usual compiler
+and assembler idioms for tests, compares and copy loops.
+
+first               second
+==================  ==============
+M68KMAKE_FUSION_START
+btst_8_s_aw         beq_8
+btst_8_s_aw         bne_8
+tst_8_d             bmi_8
+tst_8_d             bpl_8
+tst_8_d             beq_8
+tst_8_d             bne_8
+tst_16_d            beq_8
+tst_16_d            bne_8
+tst_32_d            beq_8
+tst_32_d            bne_8
+tst_8_di            beq_8
+tst_8_di            bne_8
+tst_8_di            bne_16
+cmp_8_i             beq_8
+cmp_8_i             bne_8
+cmp_8_i             bne_16
+cmp_16_d            beq_8
+cmp_16_d            bne_8
+cmp_32_d            beq_8
+cmp_32_d            bne_8
+cmpi_8_d            beq_8
+cmpi_8_d            bne_8
+cmpi_8_di           beq_8
+cmpi_8_di           bne_8
+move_8_d_aw         tst_8_d
+move_8_pi_pi        dbf_16
+move_16_pi_pi       dbf_16
+move_32_pi_pi       dbf_16
+clr_8_di            clr_16_d
+clr_16_d            rts_32
+clr_32_d            rts_32
+tst_16_d            rts_32
+subq_8_di           rts_32
+
+
+
 XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 M68KMAKE_OPCODE_HANDLER_BODY
 
@@ -1073,12 +1184,9 @@ M68KMAKE_OP(add, 8, er, d)
 	uint dst = MASK_OUT_ABOVE_8(*r_dst);
 	uint res = src + dst;
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_V = VFLAG_ADD_8(src, dst, res);
-	FLAG_X = FLAG_C = CFLAG_8(res);
-	FLAG_Z = MASK_OUT_ABOVE_8(res);
+	m68ki_flags_add_8(src, dst, res);
 
-	*r_dst = MASK_OUT_BELOW_8(*r_dst) | FLAG_Z;
+	*r_dst = MASK_OUT_BELOW_8(*r_dst) | MASK_OUT_ABOVE_8(res);
 }
 
 
@@ -1089,12 +1197,9 @@ M68KMAKE_OP(add, 8, er, .)
 	uint dst = MASK_OUT_ABOVE_8(*r_dst);
 	uint res = src + dst;
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_V = VFLAG_ADD_8(src, dst, res);
-	FLAG_X = FLAG_C = CFLAG_8(res);
-	FLAG_Z = MASK_OUT_ABOVE_8(res);
+	m68ki_flags_add_8(src, dst, res);
 
-	*r_dst = MASK_OUT_BELOW_8(*r_dst) | FLAG_Z;
+	*r_dst = MASK_OUT_BELOW_8(*r_dst) | MASK_OUT_ABOVE_8(res);
 }
 
 
@@ -1105,12 +1210,9 @@ M68KMAKE_OP(add, 16, er, d)
 	uint dst = MASK_OUT_ABOVE_16(*r_dst);
 	uint res = src + dst;
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_V = VFLAG_ADD_16(src, dst, res);
-	FLAG_X = FLAG_C = CFLAG_16(res);
-	FLAG_Z = MASK_OUT_ABOVE_16(res);
+	m68ki_flags_add_16(src, dst, res);
 
-	*r_dst = MASK_OUT_BELOW_16(*r_dst) | FLAG_Z;
+	*r_dst = MASK_OUT_BELOW_16(*r_dst) | MASK_OUT_ABOVE_16(res);
 }
 
 
@@ -1121,12 +1223,9 @@ M68KMAKE_OP(add, 16, er, a)
 	uint dst = MASK_OUT_ABOVE_16(*r_dst);
 	uint res = src + dst;
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_V = VFLAG_ADD_16(src, dst, res);
-	FLAG_X = FLAG_C = CFLAG_16(res);
-	FLAG_Z = MASK_OUT_ABOVE_16(res);
+	m68ki_flags_add_16(src, dst, res);
 
-	*r_dst = MASK_OUT_BELOW_16(*r_dst) | FLAG_Z;
+	*r_dst = MASK_OUT_BELOW_16(*r_dst) | MASK_OUT_ABOVE_16(res);
 }
 
 
@@ -1137,12 +1236,9 @@ M68KMAKE_OP(add, 16, er, .)
 	uint dst = MASK_OUT_ABOVE_16(*r_dst);
 	uint res = src + dst;
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_V = VFLAG_ADD_16(src, dst, res);
-	FLAG_X = FLAG_C = CFLAG_16(res);
-	FLAG_Z = MASK_OUT_ABOVE_16(res);
+	m68ki_flags_add_16(src, dst, res);
 
-	*r_dst = MASK_OUT_BELOW_16(*r_dst) | FLAG_Z;
+	*r_dst = MASK_OUT_BELOW_16(*r_dst) | MASK_OUT_ABOVE_16(res);
 }
 
 
@@ -1153,12 +1249,9 @@ M68KMAKE_OP(add, 32, er, d)
 	uint dst = *r_dst;
 	uint res = src + dst;
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_V = VFLAG_ADD_32(src, dst, res);
-	FLAG_X = FLAG_C = CFLAG_ADD_32(src, dst, res);
-	FLAG_Z = MASK_OUT_ABOVE_32(res);
+	m68ki_flags_add_32(src, dst, res);
 
-	*r_dst = FLAG_Z;
+	*r_dst = MASK_OUT_ABOVE_32(res);
 }
 
 
@@ -1169,12 +1262,9 @@ M68KMAKE_OP(add, 32, er, a)
 	uint dst = *r_dst;
 	uint res = src + dst;
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_V = VFLAG_ADD_32(src, dst, res);
-	FLAG_X = FLAG_C = CFLAG_ADD_32(src, dst, res);
-	FLAG_Z = MASK_OUT_ABOVE_32(res);
+	m68ki_flags_add_32(src, dst, res);
 
-	*r_dst = FLAG_Z;
+	*r_dst = MASK_OUT_ABOVE_32(res);
 }
 
 
@@ -1185,12 +1275,9 @@ M68KMAKE_OP(add, 32, er, .)
 	uint dst = *r_dst;
 	uint res = src + dst;
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_V = VFLAG_ADD_32(src, dst, res);
-	FLAG_X = FLAG_C = CFLAG_ADD_32(src, dst, res);
-	FLAG_Z = MASK_OUT_ABOVE_32(res);
+	m68ki_flags_add_32(src, dst, res);
 
-	*r_dst = FLAG_Z;
+	*r_dst = MASK_OUT_ABOVE_32(res);
 }
 
 
@@ -1201,12 +1288,9 @@ M68KMAKE_OP(add, 8, re, .)
 	uint dst = m68ki_read_8(ea);
 	uint res = src + dst;
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_V = VFLAG_ADD_8(src, dst, res);
-	FLAG_X = FLAG_C = CFLAG_8(res);
-	FLAG_Z = MASK_OUT_ABOVE_8(res);
+	m68ki_flags_add_8(src, dst, res);
 
-	m68ki_write_8(ea, FLAG_Z);
+	m68ki_write_8(ea, MASK_OUT_ABOVE_8(res));
 }
 
 
@@ -1217,12 +1301,9 @@ M68KMAKE_OP(add, 16, re, .)
 	uint dst = m68ki_read_16(ea);
 	uint res = src + dst;
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_V = VFLAG_ADD_16(src, dst, res);
-	FLAG_X = FLAG_C = CFLAG_16(res);
-	FLAG_Z = MASK_OUT_ABOVE_16(res);
+	m68ki_flags_add_16(src, dst, res);
 
-	m68ki_write_16(ea, FLAG_Z);
+	m68ki_write_16(ea, MASK_OUT_ABOVE_16(res));
 }
 
 
@@ -1233,12 +1314,9 @@ M68KMAKE_OP(add, 32, re, .)
 	uint dst = m68ki_read_32(ea);
 	uint res = src + dst;
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_V = VFLAG_ADD_32(src, dst, res);
-	FLAG_X = FLAG_C = CFLAG_ADD_32(src, dst, res);
-	FLAG_Z = MASK_OUT_ABOVE_32(res);
+	m68ki_flags_add_32(src, dst, res);
 
-	m68ki_write_32(ea, FLAG_Z);
+	m68ki_write_32(ea, MASK_OUT_ABOVE_32(res));
 }
 
 
@@ -1299,12 +1377,9 @@ M68KMAKE_OP(addi, 8, ., d)
 	uint dst = MASK_OUT_ABOVE_8(*r_dst);
 	uint res = src + dst;
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_V = VFLAG_ADD_8(src, dst, res);
-	FLAG_X = FLAG_C = CFLAG_8(res);
-	FLAG_Z = MASK_OUT_ABOVE_8(res);
+	m68ki_flags_add_8(src, dst, res);
 
-	*r_dst = MASK_OUT_BELOW_8(*r_dst) | FLAG_Z;
+	*r_dst = MASK_OUT_BELOW_8(*r_dst) | MASK_OUT_ABOVE_8(res);
 }
 
 
@@ -1315,12 +1390,9 @@ M68KMAKE_OP(addi, 8, ., .)
 	uint dst = m68ki_read_8(ea);
 	uint res = src + dst;
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_V = VFLAG_ADD_8(src, dst, res);
-	FLAG_X = FLAG_C = CFLAG_8(res);
-	FLAG_Z = MASK_OUT_ABOVE_8(res);
+	m68ki_flags_add_8(src, dst, res);
 
-	m68ki_write_8(ea, FLAG_Z);
+	m68ki_write_8(ea, MASK_OUT_ABOVE_8(res));
 }
 
 
@@ -1331,12 +1403,9 @@ M68KMAKE_OP(addi, 16, ., d)
 	uint dst = MASK_OUT_ABOVE_16(*r_dst);
 	uint res = src + dst;
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_V = VFLAG_ADD_16(src, dst, res);
-	FLAG_X = FLAG_C = CFLAG_16(res);
-	FLAG_Z = MASK_OUT_ABOVE_16(res);
+	m68ki_flags_add_16(src, dst, res);
 
-	*r_dst = MASK_OUT_BELOW_16(*r_dst) | FLAG_Z;
+	*r_dst = MASK_OUT_BELOW_16(*r_dst) | MASK_OUT_ABOVE_16(res);
 }
 
 
@@ -1347,12 +1416,9 @@ M68KMAKE_OP(addi, 16, ., .)
 	uint dst = m68ki_read_16(ea);
 	uint res = src + dst;
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_V = VFLAG_ADD_16(src, dst, res);
-	FLAG_X = FLAG_C = CFLAG_16(res);
-	FLAG_Z = MASK_OUT_ABOVE_16(res);
+	m68ki_flags_add_16(src, dst, res);
 
-	m68ki_write_16(ea, FLAG_Z);
+	m68ki_write_16(ea, MASK_OUT_ABOVE_16(res));
 }
 
 
@@ -1363,12 +1429,9 @@ M68KMAKE_OP(addi, 32, ., d)
 	uint dst = *r_dst;
 	uint res = src + dst;
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_V = VFLAG_ADD_32(src, dst, res);
-	FLAG_X = FLAG_C = CFLAG_ADD_32(src, dst, res);
-	FLAG_Z = MASK_OUT_ABOVE_32(res);
+	m68ki_flags_add_32(src, dst, res);
 
-	*r_dst = FLAG_Z;
+	*r_dst = MASK_OUT_ABOVE_32(res);
 }
 
 
@@ -1379,12 +1442,9 @@ M68KMAKE_OP(addi, 32, ., .)
 	uint dst = m68ki_read_32(ea);
 	uint res = src + dst;
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_V = VFLAG_ADD_32(src, dst, res);
-	FLAG_X = FLAG_C = CFLAG_ADD_32(src, dst, res);
-	FLAG_Z = MASK_OUT_ABOVE_32(res);
+	m68ki_flags_add_32(src, dst, res);
 
-	m68ki_write_32(ea, FLAG_Z);
+	m68ki_write_32(ea, MASK_OUT_ABOVE_32(res));
 }
 
 
@@ -1395,12 +1455,9 @@ M68KMAKE_OP(addq, 8, ., d)
 	uint dst = MASK_OUT_ABOVE_8(*r_dst);
 	uint res = src + dst;
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_V = VFLAG_ADD_8(src, dst, res);
-	FLAG_X = FLAG_C = CFLAG_8(res);
-	FLAG_Z = MASK_OUT_ABOVE_8(res);
+	m68ki_flags_add_8(src, dst, res);
 
-	*r_dst = MASK_OUT_BELOW_8(*r_dst) | FLAG_Z;
+	*r_dst = MASK_OUT_BELOW_8(*r_dst) | MASK_OUT_ABOVE_8(res);
 }
 
 
@@ -1411,12 +1468,9 @@ M68KMAKE_OP(addq, 8, ., .)
 	uint dst = m68ki_read_8(ea);
 	uint res = src + dst;
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_V = VFLAG_ADD_8(src, dst, res);
-	FLAG_X = FLAG_C = CFLAG_8(res);
-	FLAG_Z = MASK_OUT_ABOVE_8(res);
+	m68ki_flags_add_8(src, dst, res);
 
-	m68ki_write_8(ea, FLAG_Z);
+	m68ki_write_8(ea, MASK_OUT_ABOVE_8(res));
 }
 
 
@@ -1427,12 +1481,9 @@ M68KMAKE_OP(addq, 16, ., d)
 	uint dst = MASK_OUT_ABOVE_16(*r_dst);
 	uint res = src + dst;
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_V = VFLAG_ADD_16(src, dst, res);
-	FLAG_X = FLAG_C = CFLAG_16(res);
-	FLAG_Z = MASK_OUT_ABOVE_16(res);
+	m68ki_flags_add_16(src, dst, res);
 
-	*r_dst = MASK_OUT_BELOW_16(*r_dst) | FLAG_Z;
+	*r_dst = MASK_OUT_BELOW_16(*r_dst) | MASK_OUT_ABOVE_16(res);
 }
 
 
@@ -1451,12 +1502,9 @@ M68KMAKE_OP(addq, 16, ., .)
 	uint dst = m68ki_read_16(ea);
 	uint res = src + dst;
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_V = VFLAG_ADD_16(src, dst, res);
-	FLAG_X = FLAG_C = CFLAG_16(res);
-	FLAG_Z = MASK_OUT_ABOVE_16(res);
+	m68ki_flags_add_16(src, dst, res);
 
-	m68ki_write_16(ea, FLAG_Z);
+	m68ki_write_16(ea, MASK_OUT_ABOVE_16(res));
 }
 
 
@@ -1467,12 +1515,9 @@ M68KMAKE_OP(addq, 32, ., d)
 	uint dst = *r_dst;
 	uint res = src + dst;
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_V = VFLAG_ADD_32(src, dst, res);
-	FLAG_X = FLAG_C = CFLAG_ADD_32(src, dst, res);
-	FLAG_Z = MASK_OUT_ABOVE_32(res);
+	m68ki_flags_add_32(src, dst, res);
 
-	*r_dst = FLAG_Z;
+	*r_dst = MASK_OUT_ABOVE_32(res);
 }
 
 
@@ -1492,12 +1537,9 @@ M68KMAKE_OP(addq, 32, ., .)
 	uint res = src + dst;
 
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_V = VFLAG_ADD_32(src, dst, res);
-	FLAG_X = FLAG_C = CFLAG_ADD_32(src, dst, res);
-	FLAG_Z = MASK_OUT_ABOVE_32(res);
+	m68ki_flags_add_32(src, dst, res);
 
-	m68ki_write_32(ea, FLAG_Z);
+	m68ki_write_32(ea, MASK_OUT_ABOVE_32(res));
 }
 
 
@@ -1756,10 +1798,7 @@ M68KMAKE_OP(and, 32, re, .)
 	uint ea = M68KMAKE_GET_EA_AY_32;
 	uint res = DX & m68ki_read_32(ea);
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 
 	m68ki_write_32(ea, res);
 }
@@ -1781,10 +1820,7 @@ M68KMAKE_OP(andi, 8, ., .)
 	uint ea = M68KMAKE_GET_EA_AY_8;
 	uint res = src & m68ki_read_8(ea);
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_8(res);
 
 	m68ki_write_8(ea, res);
 }
@@ -1806,10 +1842,7 @@ M68KMAKE_OP(andi, 16, ., .)
 	uint ea = M68KMAKE_GET_EA_AY_16;
 	uint res = src & m68ki_read_16(ea);
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 
 	m68ki_write_16(ea, res);
 }
@@ -1831,10 +1864,7 @@ M68KMAKE_OP(andi, 32, ., .)
 	uint ea = M68KMAKE_GET_EA_AY_32;
 	uint res = src & m68ki_read_32(ea);
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 
 	m68ki_write_32(ea, res);
 }
@@ -1970,10 +2000,7 @@ M68KMAKE_OP(asr, 8, r, .)
 		return;
 	}
 
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_N = NFLAG_8(src);
-	FLAG_Z = src;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_8(src);
 }
 
 
@@ -2022,10 +2049,7 @@ M68KMAKE_OP(asr, 16, r, .)
 		return;
 	}
 
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_N = NFLAG_16(src);
-	FLAG_Z = src;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_16(src);
 }
 
 
@@ -2074,10 +2098,7 @@ M68KMAKE_OP(asr, 32, r, .)
 		return;
 	}
 
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_N = NFLAG_32(src);
-	FLAG_Z = src;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_32(src);
 }
 
 
@@ -2189,10 +2210,7 @@ M68KMAKE_OP(asl, 8, r, .)
 		return;
 	}
 
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_N = NFLAG_8(src);
-	FLAG_Z = src;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_8(src);
 }
 
 
@@ -2226,10 +2244,7 @@ M68KMAKE_OP(asl, 16, r, .)
 		return;
 	}
 
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_N = NFLAG_16(src);
-	FLAG_Z = src;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_16(src);
 }
 
 
@@ -2263,10 +2278,7 @@ M68KMAKE_OP(asl, 32, r, .)
 		return;
 	}
 
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_N = NFLAG_32(src);
-	FLAG_Z = src;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_32(src);
 }
 
 
@@ -3863,10 +3875,7 @@ M68KMAKE_OP(cmp, 8, ., d)
 	uint dst = MASK_OUT_ABOVE_8(DX);
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = MASK_OUT_ABOVE_8(res);
-	FLAG_V = VFLAG_SUB_8(src, dst, res);
-	FLAG_C = CFLAG_8(res);
+	m68ki_flags_cmp_8(src, dst, res);
 }
 
 
@@ -3876,10 +3885,7 @@ M68KMAKE_OP(cmp, 8, ., .)
 	uint dst = MASK_OUT_ABOVE_8(DX);
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = MASK_OUT_ABOVE_8(res);
-	FLAG_V = VFLAG_SUB_8(src, dst, res);
-	FLAG_C = CFLAG_8(res);
+	m68ki_flags_cmp_8(src, dst, res);
 }
 
 
@@ -3889,10 +3895,7 @@ M68KMAKE_OP(cmp, 16, ., d)
 	uint dst = MASK_OUT_ABOVE_16(DX);
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = MASK_OUT_ABOVE_16(res);
-	FLAG_V = VFLAG_SUB_16(src, dst, res);
-	FLAG_C = CFLAG_16(res);
+	m68ki_flags_cmp_16(src, dst, res);
 }
 
 
@@ -3902,10 +3905,7 @@ M68KMAKE_OP(cmp, 16, ., a)
 	uint dst = MASK_OUT_ABOVE_16(DX);
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = MASK_OUT_ABOVE_16(res);
-	FLAG_V = VFLAG_SUB_16(src, dst, res);
-	FLAG_C = CFLAG_16(res);
+	m68ki_flags_cmp_16(src, dst, res);
 }
 
 
@@ -3915,10 +3915,7 @@ M68KMAKE_OP(cmp, 16, ., .)
 	uint dst = MASK_OUT_ABOVE_16(DX);
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = MASK_OUT_ABOVE_16(res);
-	FLAG_V = VFLAG_SUB_16(src, dst, res);
-	FLAG_C = CFLAG_16(res);
+	m68ki_flags_cmp_16(src, dst, res);
 }
 
 
@@ -3928,10 +3925,7 @@ M68KMAKE_OP(cmp, 32, ., d)
 	uint dst = DX;
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = MASK_OUT_ABOVE_32(res);
-	FLAG_V = VFLAG_SUB_32(src, dst, res);
-	FLAG_C = CFLAG_SUB_32(src, dst, res);
+	m68ki_flags_cmp_32(src, dst, res);
 }
 
 
@@ -3941,10 +3935,7 @@ M68KMAKE_OP(cmp, 32, ., a)
 	uint dst = DX;
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = MASK_OUT_ABOVE_32(res);
-	FLAG_V = VFLAG_SUB_32(src, dst, res);
-	FLAG_C = CFLAG_SUB_32(src, dst, res);
+	m68ki_flags_cmp_32(src, dst, res);
 }
 
 
@@ -3954,10 +3945,7 @@ M68KMAKE_OP(cmp, 32, ., .)
 	uint dst = DX;
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = MASK_OUT_ABOVE_32(res);
-	FLAG_V = VFLAG_SUB_32(src, dst, res);
-	FLAG_C = CFLAG_SUB_32(src, dst, res);
+	m68ki_flags_cmp_32(src, dst, res);
 }
 
 
@@ -3967,10 +3955,7 @@ M68KMAKE_OP(cmpa, 16, ., d)
 	uint dst = AX;
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = MASK_OUT_ABOVE_32(res);
-	FLAG_V = VFLAG_SUB_32(src, dst, res);
-	FLAG_C = CFLAG_SUB_32(src, dst, res);
+	m68ki_flags_cmp_32(src, dst, res);
 }
 
 
@@ -3980,10 +3965,7 @@ M68KMAKE_OP(cmpa, 16, ., a)
 	uint dst = AX;
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = MASK_OUT_ABOVE_32(res);
-	FLAG_V = VFLAG_SUB_32(src, dst, res);
-	FLAG_C = CFLAG_SUB_32(src, dst, res);
+	m68ki_flags_cmp_32(src, dst, res);
 }
 
 
@@ -3993,10 +3975,7 @@ M68KMAKE_OP(cmpa, 16, ., .)
 	uint dst = AX;
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = MASK_OUT_ABOVE_32(res);
-	FLAG_V = VFLAG_SUB_32(src, dst, res);
-	FLAG_C = CFLAG_SUB_32(src, dst, res);
+	m68ki_flags_cmp_32(src, dst, res);
 }
 
 
@@ -4006,10 +3985,7 @@ M68KMAKE_OP(cmpa, 32, ., d)
 	uint dst = AX;
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = MASK_OUT_ABOVE_32(res);
-	FLAG_V = VFLAG_SUB_32(src, dst, res);
-	FLAG_C = CFLAG_SUB_32(src, dst, res);
+	m68ki_flags_cmp_32(src, dst, res);
 }
 
 
@@ -4019,10 +3995,7 @@ M68KMAKE_OP(cmpa, 32, ., a)
 	uint dst = AX;
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = MASK_OUT_ABOVE_32(res);
-	FLAG_V = VFLAG_SUB_32(src, dst, res);
-	FLAG_C = CFLAG_SUB_32(src, dst, res);
+	m68ki_flags_cmp_32(src, dst, res);
 }
 
 
@@ -4032,10 +4005,7 @@ M68KMAKE_OP(cmpa, 32, ., .)
 	uint dst = AX;
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = MASK_OUT_ABOVE_32(res);
-	FLAG_V = VFLAG_SUB_32(src, dst, res);
-	FLAG_C = CFLAG_SUB_32(src, dst, res);
+	m68ki_flags_cmp_32(src, dst, res);
 }
 
 
@@ -4045,10 +4015,7 @@ M68KMAKE_OP(cmpi, 8, ., d)
 	uint dst = MASK_OUT_ABOVE_8(DY);
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = MASK_OUT_ABOVE_8(res);
-	FLAG_V = VFLAG_SUB_8(src, dst, res);
-	FLAG_C = CFLAG_8(res);
+	m68ki_flags_cmp_8(src, dst, res);
 }
 
 
@@ -4058,10 +4025,7 @@ M68KMAKE_OP(cmpi, 8, ., .)
 	uint dst = M68KMAKE_GET_OPER_AY_8;
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = MASK_OUT_ABOVE_8(res);
-	FLAG_V = VFLAG_SUB_8(src, dst, res);
-	FLAG_C = CFLAG_8(res);
+	m68ki_flags_cmp_8(src, dst, res);
 }
 
 
@@ -4073,10 +4037,7 @@ M68KMAKE_OP(cmpi, 8, ., pcdi)
 		uint dst = OPER_PCDI_8();
 		uint res = dst - src;
 
-		FLAG_N = NFLAG_8(res);
-		FLAG_Z = MASK_OUT_ABOVE_8(res);
-		FLAG_V = VFLAG_SUB_8(src, dst, res);
-		FLAG_C = CFLAG_8(res);
+		m68ki_flags_cmp_8(src, dst, res);
 		return;
 	}
 	m68ki_exception_illegal();
@@ -4091,10 +4052,7 @@ M68KMAKE_OP(cmpi, 8, ., pcix)
 		uint dst = OPER_PCIX_8();
 		uint res = dst - src;
 
-		FLAG_N = NFLAG_8(res);
-		FLAG_Z = MASK_OUT_ABOVE_8(res);
-		FLAG_V = VFLAG_SUB_8(src, dst, res);
-		FLAG_C = CFLAG_8(res);
+		m68ki_flags_cmp_8(src, dst, res);
 		return;
 	}
 	m68ki_exception_illegal();
@@ -4107,10 +4065,7 @@ M68KMAKE_OP(cmpi, 16, ., d)
 	uint dst = MASK_OUT_ABOVE_16(DY);
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = MASK_OUT_ABOVE_16(res);
-	FLAG_V = VFLAG_SUB_16(src, dst, res);
-	FLAG_C = CFLAG_16(res);
+	m68ki_flags_cmp_16(src, dst, res);
 }
 
 
@@ -4120,10 +4075,7 @@ M68KMAKE_OP(cmpi, 16, ., .)
 	uint dst = M68KMAKE_GET_OPER_AY_16;
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = MASK_OUT_ABOVE_16(res);
-	FLAG_V = VFLAG_SUB_16(src, dst, res);
-	FLAG_C = CFLAG_16(res);
+	m68ki_flags_cmp_16(src, dst, res);
 }
 
 
@@ -4135,10 +4087,7 @@ M68KMAKE_OP(cmpi, 16, ., pcdi)
 		uint dst = OPER_PCDI_16();
 		uint res = dst - src;
 
-		FLAG_N = NFLAG_16(res);
-		FLAG_Z = MASK_OUT_ABOVE_16(res);
-		FLAG_V = VFLAG_SUB_16(src, dst, res);
-		FLAG_C = CFLAG_16(res);
+		m68ki_flags_cmp_16(src, dst, res);
 		return;
 	}
 	m68ki_exception_illegal();
@@ -4153,10 +4102,7 @@ M68KMAKE_OP(cmpi, 16, ., pcix)
 		uint dst = OPER_PCIX_16();
 		uint res = dst - src;
 
-		FLAG_N = NFLAG_16(res);
-		FLAG_Z = MASK_OUT_ABOVE_16(res);
-		FLAG_V = VFLAG_SUB_16(src, dst, res);
-		FLAG_C = CFLAG_16(res);
+		m68ki_flags_cmp_16(src, dst, res);
 		return;
 	}
 	m68ki_exception_illegal();
@@ -4170,10 +4116,7 @@ M68KMAKE_OP(cmpi, 32, ., d)
 	uint res = dst - src;
 
 	m68ki_cmpild_callback(src, REG_IR & 7);		   /* auto-disable (see m68kcpu.h) */
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = MASK_OUT_ABOVE_32(res);
-	FLAG_V = VFLAG_SUB_32(src, dst, res);
-	FLAG_C = CFLAG_SUB_32(src, dst, res);
+	m68ki_flags_cmp_32(src, dst, res);
 }
 
 
@@ -4183,10 +4126,7 @@ M68KMAKE_OP(cmpi, 32, ., .)
 	uint dst = M68KMAKE_GET_OPER_AY_32;
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = MASK_OUT_ABOVE_32(res);
-	FLAG_V = VFLAG_SUB_32(src, dst, res);
-	FLAG_C = CFLAG_SUB_32(src, dst, res);
+	m68ki_flags_cmp_32(src, dst, res);
 }
 
 
@@ -4198,10 +4138,7 @@ M68KMAKE_OP(cmpi, 32, ., pcdi)
 		uint dst = OPER_PCDI_32();
 		uint res = dst - src;
 
-		FLAG_N = NFLAG_32(res);
-		FLAG_Z = MASK_OUT_ABOVE_32(res);
-		FLAG_V = VFLAG_SUB_32(src, dst, res);
-		FLAG_C = CFLAG_SUB_32(src, dst, res);
+		m68ki_flags_cmp_32(src, dst, res);
 		return;
 	}
 	m68ki_exception_illegal();
@@ -4216,10 +4153,7 @@ M68KMAKE_OP(cmpi, 32, ., pcix)
 		uint dst = OPER_PCIX_32();
 		uint res = dst - src;
 
-		FLAG_N = NFLAG_32(res);
-		FLAG_Z = MASK_OUT_ABOVE_32(res);
-		FLAG_V = VFLAG_SUB_32(src, dst, res);
-		FLAG_C = CFLAG_SUB_32(src, dst, res);
+		m68ki_flags_cmp_32(src, dst, res);
 		return;
 	}
 	m68ki_exception_illegal();
@@ -4232,10 +4166,7 @@ M68KMAKE_OP(cmpm, 8, ., ax7)
 	uint dst = OPER_A7_PI_8();
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = MASK_OUT_ABOVE_8(res);
-	FLAG_V = VFLAG_SUB_8(src, dst, res);
-	FLAG_C = CFLAG_8(res);
+	m68ki_flags_cmp_8(src, dst, res);
 }
 
 
@@ -4245,10 +4176,7 @@ M68KMAKE_OP(cmpm, 8, ., ay7)
 	uint dst = OPER_AX_PI_8();
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = MASK_OUT_ABOVE_8(res);
-	FLAG_V = VFLAG_SUB_8(src, dst, res);
-	FLAG_C = CFLAG_8(res);
+	m68ki_flags_cmp_8(src, dst, res);
 }
 
 
@@ -4258,10 +4186,7 @@ M68KMAKE_OP(cmpm, 8, ., axy7)
 	uint dst = OPER_A7_PI_8();
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = MASK_OUT_ABOVE_8(res);
-	FLAG_V = VFLAG_SUB_8(src, dst, res);
-	FLAG_C = CFLAG_8(res);
+	m68ki_flags_cmp_8(src, dst, res);
 }
 
 
@@ -4271,10 +4196,7 @@ M68KMAKE_OP(cmpm, 8, ., .)
 	uint dst = OPER_AX_PI_8();
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = MASK_OUT_ABOVE_8(res);
-	FLAG_V = VFLAG_SUB_8(src, dst, res);
-	FLAG_C = CFLAG_8(res);
+	m68ki_flags_cmp_8(src, dst, res);
 }
 
 
@@ -4284,10 +4206,7 @@ M68KMAKE_OP(cmpm, 16, ., .)
 	uint dst = OPER_AX_PI_16();
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = MASK_OUT_ABOVE_16(res);
-	FLAG_V = VFLAG_SUB_16(src, dst, res);
-	FLAG_C = CFLAG_16(res);
+	m68ki_flags_cmp_16(src, dst, res);
 }
 
 
@@ -4297,10 +4216,7 @@ M68KMAKE_OP(cmpm, 32, ., .)
 	uint dst = OPER_AX_PI_32();
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = MASK_OUT_ABOVE_32(res);
-	FLAG_V = VFLAG_SUB_32(src, dst, res);
-	FLAG_C = CFLAG_SUB_32(src, dst, res);
+	m68ki_flags_cmp_32(src, dst, res);
 }
 
 
@@ -4446,10 +4362,7 @@ M68KMAKE_OP(divs, 16, ., d)
 
 		if(quotient == MAKE_INT_16(quotient))
 		{
-			FLAG_Z = quotient;
-			FLAG_N = NFLAG_16(quotient);
-			FLAG_V = VFLAG_CLEAR;
-			FLAG_C = CFLAG_CLEAR;
+			m68ki_flags_logic_16(quotient);
 			*r_dst = MASK_OUT_ABOVE_32(MASK_OUT_ABOVE_16(quotient) | (remainder << 16));
 			return;
 		}
@@ -4484,10 +4397,7 @@ M68KMAKE_OP(divs, 16, ., .)
 
 		if(quotient == MAKE_INT_16(quotient))
 		{
-			FLAG_Z = quotient;
-			FLAG_N = NFLAG_16(quotient);
-			FLAG_V = VFLAG_CLEAR;
-			FLAG_C = CFLAG_CLEAR;
+			m68ki_flags_logic_16(quotient);
 			*r_dst = MASK_OUT_ABOVE_32(MASK_OUT_ABOVE_16(quotient) | (remainder << 16));
 			return;
 		}
@@ -4510,10 +4420,7 @@ M68KMAKE_OP(divu, 16, ., d)
 
 		if(quotient < 0x10000)
 		{
-			FLAG_Z = quotient;
-			FLAG_N = NFLAG_16(quotient);
-			FLAG_V = VFLAG_CLEAR;
-			FLAG_C = CFLAG_CLEAR;
+			m68ki_flags_logic_16(quotient);
 			*r_dst = MASK_OUT_ABOVE_32(MASK_OUT_ABOVE_16(quotient) | (remainder << 16));
 			return;
 		}
@@ -4536,10 +4443,7 @@ M68KMAKE_OP(divu, 16, ., .)
 
 		if(quotient < 0x10000)
 		{
-			FLAG_Z = quotient;
-			FLAG_N = NFLAG_16(quotient);
-			FLAG_V = VFLAG_CLEAR;
-			FLAG_C = CFLAG_CLEAR;
+			m68ki_flags_logic_16(quotient);
 			*r_dst = MASK_OUT_ABOVE_32(MASK_OUT_ABOVE_16(quotient) | (remainder << 16));
 			return;
 		}
@@ -4609,10 +4513,7 @@ M68KMAKE_OP(divl, 32, ., d)
 			REG_D[word2 & 7] = remainder;
 			REG_D[(word2 >> 12) & 7] = quotient;
 
-			FLAG_N = NFLAG_32(quotient);
-			FLAG_Z = quotient;
-			FLAG_V = VFLAG_CLEAR;
-			FLAG_C = CFLAG_CLEAR;
+			m68ki_flags_logic_32(quotient);
 			return;
 		}
 		m68ki_exception_trap(EXCEPTION_ZERO_DIVIDE);
@@ -4716,10 +4617,7 @@ M68KMAKE_OP(divl, 32, ., d)
 				REG_D[word2 & 7] = remainder;
 				REG_D[(word2 >> 12) & 7] = quotient;
 
-				FLAG_N = NFLAG_32(quotient);
-				FLAG_Z = quotient;
-				FLAG_V = VFLAG_CLEAR;
-				FLAG_C = CFLAG_CLEAR;
+				m68ki_flags_logic_32(quotient);
 				return;
 			}
 
@@ -4746,10 +4644,7 @@ M68KMAKE_OP(divl, 32, ., d)
 				quotient = REG_D[(word2 >> 12) & 7] = MASK_OUT_ABOVE_32(dividend_lo) / MASK_OUT_ABOVE_32(divisor);
 			}
 
-			FLAG_N = NFLAG_32(quotient);
-			FLAG_Z = quotient;
-			FLAG_V = VFLAG_CLEAR;
-			FLAG_C = CFLAG_CLEAR;
+			m68ki_flags_logic_32(quotient);
 			return;
 		}
 		m68ki_exception_trap(EXCEPTION_ZERO_DIVIDE);
@@ -4820,10 +4715,7 @@ M68KMAKE_OP(divl, 32, ., .)
 			REG_D[word2 & 7] = remainder;
 			REG_D[(word2 >> 12) & 7] = quotient;
 
-			FLAG_N = NFLAG_32(quotient);
-			FLAG_Z = quotient;
-			FLAG_V = VFLAG_CLEAR;
-			FLAG_C = CFLAG_CLEAR;
+			m68ki_flags_logic_32(quotient);
 			return;
 		}
 		m68ki_exception_trap(EXCEPTION_ZERO_DIVIDE);
@@ -4927,10 +4819,7 @@ M68KMAKE_OP(divl, 32, ., .)
 				REG_D[word2 & 7] = remainder;
 				REG_D[(word2 >> 12) & 7] = quotient;
 
-				FLAG_N = NFLAG_32(quotient);
-				FLAG_Z = quotient;
-				FLAG_V = VFLAG_CLEAR;
-				FLAG_C = CFLAG_CLEAR;
+				m68ki_flags_logic_32(quotient);
 				return;
 			}
 
@@ -4957,10 +4846,7 @@ M68KMAKE_OP(divl, 32, ., .)
 				quotient = REG_D[(word2 >> 12) & 7] = MASK_OUT_ABOVE_32(dividend_lo) / MASK_OUT_ABOVE_32(divisor);
 			}
 
-			FLAG_N = NFLAG_32(quotient);
-			FLAG_Z = quotient;
-			FLAG_V = VFLAG_CLEAR;
-			FLAG_C = CFLAG_CLEAR;
+			m68ki_flags_logic_32(quotient);
 			return;
 		}
 		m68ki_exception_trap(EXCEPTION_ZERO_DIVIDE);
@@ -4976,10 +4862,7 @@ M68KMAKE_OP(eor, 8, ., d)
 {
 	uint res = MASK_OUT_ABOVE_8(DY ^= MASK_OUT_ABOVE_8(DX));
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_8(res);
 }
 
 
@@ -4990,10 +4873,7 @@ M68KMAKE_OP(eor, 8, ., .)
 
 	m68ki_write_8(ea, res);
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_8(res);
 }
 
 
@@ -5001,10 +4881,7 @@ M68KMAKE_OP(eor, 16, ., d)
 {
 	uint res = MASK_OUT_ABOVE_16(DY ^= MASK_OUT_ABOVE_16(DX));
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -5015,10 +4892,7 @@ M68KMAKE_OP(eor, 16, ., .)
 
 	m68ki_write_16(ea, res);
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -5026,10 +4900,7 @@ M68KMAKE_OP(eor, 32, ., d)
 {
 	uint res = DY ^= DX;
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -5040,10 +4911,7 @@ M68KMAKE_OP(eor, 32, ., .)
 
 	m68ki_write_32(ea, res);
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -5051,10 +4919,7 @@ M68KMAKE_OP(eori, 8, ., d)
 {
 	uint res = MASK_OUT_ABOVE_8(DY ^= OPER_I_8());
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_8(res);
 }
 
 
@@ -5066,10 +4931,7 @@ M68KMAKE_OP(eori, 8, ., .)
 
 	m68ki_write_8(ea, res);
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_8(res);
 }
 
 
@@ -5077,10 +4939,7 @@ M68KMAKE_OP(eori, 16, ., d)
 {
 	uint res = MASK_OUT_ABOVE_16(DY ^= OPER_I_16());
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -5092,10 +4951,7 @@ M68KMAKE_OP(eori, 16, ., .)
 
 	m68ki_write_16(ea, res);
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -5103,10 +4959,7 @@ M68KMAKE_OP(eori, 32, ., d)
 {
 	uint res = DY ^= OPER_I_32();
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -5118,10 +4971,7 @@ M68KMAKE_OP(eori, 32, ., .)
 
 	m68ki_write_32(ea, res);
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -5380,10 +5230,7 @@ M68KMAKE_OP(lsr, 8, r, .)
 		return;
 	}
 
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_N = NFLAG_8(src);
-	FLAG_Z = src;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_8(src);
 }
 
 
@@ -5417,10 +5264,7 @@ M68KMAKE_OP(lsr, 16, r, .)
 		return;
 	}
 
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_N = NFLAG_16(src);
-	FLAG_Z = src;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_16(src);
 }
 
 
@@ -5453,10 +5297,7 @@ M68KMAKE_OP(lsr, 32, r, .)
 		return;
 	}
 
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_N = NFLAG_32(src);
-	FLAG_Z = src;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_32(src);
 }
 
 
@@ -5562,10 +5403,7 @@ M68KMAKE_OP(lsl, 8, r, .)
 		return;
 	}
 
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_N = NFLAG_8(src);
-	FLAG_Z = src;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_8(src);
 }
 
 
@@ -5599,10 +5437,7 @@ M68KMAKE_OP(lsl, 16, r, .)
 		return;
 	}
 
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_N = NFLAG_16(src);
-	FLAG_Z = src;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_16(src);
 }
 
 
@@ -5635,10 +5470,7 @@ M68KMAKE_OP(lsl, 32, r, .)
 		return;
 	}
 
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_N = NFLAG_32(src);
-	FLAG_Z = src;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_32(src);
 }
 
 
@@ -5664,10 +5496,7 @@ M68KMAKE_OP(move, 8, d, d)
 
 	*r_dst = MASK_OUT_BELOW_8(*r_dst) | res;
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_8(res);
 }
 
 
@@ -5678,10 +5507,7 @@ M68KMAKE_OP(move, 8, d, .)
 
 	*r_dst = MASK_OUT_BELOW_8(*r_dst) | res;
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_8(res);
 }
 
 
@@ -5692,10 +5518,7 @@ M68KMAKE_OP(move, 8, ai, d)
 
 	m68ki_write_8(ea, res);
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_8(res);
 }
 
 
@@ -5706,10 +5529,7 @@ M68KMAKE_OP(move, 8, ai, .)
 
 	m68ki_write_8(ea, res);
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_8(res);
 }
 
 
@@ -5720,10 +5540,7 @@ M68KMAKE_OP(move, 8, pi7, d)
 
 	m68ki_write_8(ea, res);
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_8(res);
 }
 
 
@@ -5734,10 +5551,7 @@ M68KMAKE_OP(move, 8, pi, d)
 
 	m68ki_write_8(ea, res);
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_8(res);
 }
 
 
@@ -5748,10 +5562,7 @@ M68KMAKE_OP(move, 8, pi7, .)
 
 	m68ki_write_8(ea, res);
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_8(res);
 }
 
 
@@ -5762,10 +5573,7 @@ M68KMAKE_OP(move, 8, pi, .)
 
 	m68ki_write_8(ea, res);
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_8(res);
 }
 
 
@@ -5776,10 +5584,7 @@ M68KMAKE_OP(move, 8, pd7, d)
 
 	m68ki_write_8(ea, res);
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_8(res);
 }
 
 
@@ -5790,10 +5595,7 @@ M68KMAKE_OP(move, 8, pd, d)
 
 	m68ki_write_8(ea, res);
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_8(res);
 }
 
 
@@ -5804,10 +5606,7 @@ M68KMAKE_OP(move, 8, pd7, .)
 
 	m68ki_write_8(ea, res);
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_8(res);
 }
 
 
@@ -5818,10 +5617,7 @@ M68KMAKE_OP(move, 8, pd, .)
 
 	m68ki_write_8(ea, res);
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_8(res);
 }
 
 
@@ -5832,10 +5628,7 @@ M68KMAKE_OP(move, 8, di, d)
 
 	m68ki_write_8(ea, res);
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_8(res);
 }
 
 
@@ -5846,10 +5639,7 @@ M68KMAKE_OP(move, 8, di, .)
 
 	m68ki_write_8(ea, res);
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_8(res);
 }
 
 
@@ -5860,10 +5650,7 @@ M68KMAKE_OP(move, 8, ix, d)
 
 	m68ki_write_8(ea, res);
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_8(res);
 }
 
 
@@ -5874,10 +5661,7 @@ M68KMAKE_OP(move, 8, ix, .)
 
 	m68ki_write_8(ea, res);
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_8(res);
 }
 
 
@@ -5888,10 +5672,7 @@ M68KMAKE_OP(move, 8, aw, d)
 
 	m68ki_write_8(ea, res);
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_8(res);
 }
 
 
@@ -5902,10 +5683,7 @@ M68KMAKE_OP(move, 8, aw, .)
 
 	m68ki_write_8(ea, res);
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_8(res);
 }
 
 
@@ -5916,10 +5694,7 @@ M68KMAKE_OP(move, 8, al, d)
 
 	m68ki_write_8(ea, res);
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_8(res);
 }
 
 
@@ -5930,10 +5705,7 @@ M68KMAKE_OP(move, 8, al, .)
 
 	m68ki_write_8(ea, res);
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_8(res);
 }
 
 
@@ -5944,10 +5716,7 @@ M68KMAKE_OP(move, 16, d, d)
 
 	*r_dst = MASK_OUT_BELOW_16(*r_dst) | res;
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -5958,10 +5727,7 @@ M68KMAKE_OP(move, 16, d, a)
 
 	*r_dst = MASK_OUT_BELOW_16(*r_dst) | res;
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -5972,10 +5738,7 @@ M68KMAKE_OP(move, 16, d, .)
 
 	*r_dst = MASK_OUT_BELOW_16(*r_dst) | res;
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -5986,10 +5749,7 @@ M68KMAKE_OP(move, 16, ai, d)
 
 	m68ki_write_16(ea, res);
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -6000,10 +5760,7 @@ M68KMAKE_OP(move, 16, ai, a)
 
 	m68ki_write_16(ea, res);
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -6014,10 +5771,7 @@ M68KMAKE_OP(move, 16, ai, .)
 
 	m68ki_write_16(ea, res);
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -6028,10 +5782,7 @@ M68KMAKE_OP(move, 16, pi, d)
 
 	m68ki_write_16(ea, res);
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -6042,10 +5793,7 @@ M68KMAKE_OP(move, 16, pi, a)
 
 	m68ki_write_16(ea, res);
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -6056,10 +5804,7 @@ M68KMAKE_OP(move, 16, pi, .)
 
 	m68ki_write_16(ea, res);
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -6070,10 +5815,7 @@ M68KMAKE_OP(move, 16, pd, d)
 
 	m68ki_write_16(ea, res);
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -6084,10 +5826,7 @@ M68KMAKE_OP(move, 16, pd, a)
 
 	m68ki_write_16(ea, res);
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -6098,10 +5837,7 @@ M68KMAKE_OP(move, 16, pd, .)
 
 	m68ki_write_16(ea, res);
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -6112,10 +5848,7 @@ M68KMAKE_OP(move, 16, di, d)
 
 	m68ki_write_16(ea, res);
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -6126,10 +5859,7 @@ M68KMAKE_OP(move, 16, di, a)
 
 	m68ki_write_16(ea, res);
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -6140,10 +5870,7 @@ M68KMAKE_OP(move, 16, di, .)
 
 	m68ki_write_16(ea, res);
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -6154,10 +5881,7 @@ M68KMAKE_OP(move, 16, ix, d)
 
 	m68ki_write_16(ea, res);
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -6168,10 +5892,7 @@ M68KMAKE_OP(move, 16, ix, a)
 
 	m68ki_write_16(ea, res);
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -6182,10 +5903,7 @@ M68KMAKE_OP(move, 16, ix, .)
 
 	m68ki_write_16(ea, res);
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -6196,10 +5914,7 @@ M68KMAKE_OP(move, 16, aw, d)
 
 	m68ki_write_16(ea, res);
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -6210,10 +5925,7 @@ M68KMAKE_OP(move, 16, aw, a)
 
 	m68ki_write_16(ea, res);
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -6224,10 +5936,7 @@ M68KMAKE_OP(move, 16, aw, .)
 
 	m68ki_write_16(ea, res);
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -6238,10 +5947,7 @@ M68KMAKE_OP(move, 16, al, d)
 
 	m68ki_write_16(ea, res);
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -6252,10 +5958,7 @@ M68KMAKE_OP(move, 16, al, a)
 
 	m68ki_write_16(ea, res);
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -6266,10 +5969,7 @@ M68KMAKE_OP(move, 16, al, .)
 
 	m68ki_write_16(ea, res);
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -6280,10 +5980,7 @@ M68KMAKE_OP(move, 32, d, d)
 
 	*r_dst = res;
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -6294,10 +5991,7 @@ M68KMAKE_OP(move, 32, d, a)
 
 	*r_dst = res;
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -6308,10 +6002,7 @@ M68KMAKE_OP(move, 32, d, .)
 
 	*r_dst = res;
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -6322,10 +6013,7 @@ M68KMAKE_OP(move, 32, ai, d)
 
 	m68ki_write_32(ea, res);
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -6336,10 +6024,7 @@ M68KMAKE_OP(move, 32, ai, a)
 
 	m68ki_write_32(ea, res);
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -6350,10 +6035,7 @@ M68KMAKE_OP(move, 32, ai, .)
 
 	m68ki_write_32(ea, res);
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -6364,10 +6046,7 @@ M68KMAKE_OP(move, 32, pi, d)
 
 	m68ki_write_32(ea, res);
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -6378,10 +6057,7 @@ M68KMAKE_OP(move, 32, pi, a)
 
 	m68ki_write_32(ea, res);
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -6392,10 +6068,7 @@ M68KMAKE_OP(move, 32, pi, .)
 
 	m68ki_write_32(ea, res);
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -6407,10 +6080,7 @@ M68KMAKE_OP(move, 32, pd, d)
 	m68ki_write_16(ea+2, res & 0xFFFF );
 	m68ki_write_16(ea, (res >> 16) & 0xFFFF );
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -6422,10 +6092,7 @@ M68KMAKE_OP(move, 32, pd, a)
 	m68ki_write_16(ea+2, res & 0xFFFF );
 	m68ki_write_16(ea, (res >> 16) & 0xFFFF );
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -6437,10 +6104,7 @@ M68KMAKE_OP(move, 32, pd, .)
 	m68ki_write_16(ea+2, res & 0xFFFF );
 	m68ki_write_16(ea, (res >> 16) & 0xFFFF );
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -6451,10 +6115,7 @@ M68KMAKE_OP(move, 32, di, d)
 
 	m68ki_write_32(ea, res);
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -6465,10 +6126,7 @@ M68KMAKE_OP(move, 32, di, a)
 
 	m68ki_write_32(ea, res);
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -6479,10 +6137,7 @@ M68KMAKE_OP(move, 32, di, .)
 
 	m68ki_write_32(ea, res);
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -6493,10 +6148,7 @@ M68KMAKE_OP(move, 32, ix, d)
 
 	m68ki_write_32(ea, res);
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -6507,10 +6159,7 @@ M68KMAKE_OP(move, 32, ix, a)
 
 	m68ki_write_32(ea, res);
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -6521,10 +6170,7 @@ M68KMAKE_OP(move, 32, ix, .)
 
 	m68ki_write_32(ea, res);
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -6535,10 +6181,7 @@ M68KMAKE_OP(move, 32, aw, d)
 
 	m68ki_write_32(ea, res);
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -6549,10 +6192,7 @@ M68KMAKE_OP(move, 32, aw, a)
 
 	m68ki_write_32(ea, res);
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -6563,10 +6203,7 @@ M68KMAKE_OP(move, 32, aw, .)
 
 	m68ki_write_32(ea, res);
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -6577,10 +6214,7 @@ M68KMAKE_OP(move, 32, al, d)
 
 	m68ki_write_32(ea, res);
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -6591,10 +6225,7 @@ M68KMAKE_OP(move, 32, al, a)
 
 	m68ki_write_32(ea, res);
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -6605,10 +6236,7 @@ M68KMAKE_OP(move, 32, al, .)
 
 	m68ki_write_32(ea, res);
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -7414,10 +7042,7 @@ M68KMAKE_OP(moveq, 32, ., .)
 {
 	uint res = DX = MAKE_INT_8(MASK_OUT_ABOVE_8(REG_IR));
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -7444,10 +7069,7 @@ M68KMAKE_OP(muls, 16, ., d)
 
 	*r_dst = res;
 
-	FLAG_Z = res;
-	FLAG_N = NFLAG_32(res);
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -7458,10 +7080,7 @@ M68KMAKE_OP(muls, 16, ., .)
 
 	*r_dst = res;
 
-	FLAG_Z = res;
-	FLAG_N = NFLAG_32(res);
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -7472,10 +7091,7 @@ M68KMAKE_OP(mulu, 16, ., d)
 
 	*r_dst = res;
 
-	FLAG_Z = res;
-	FLAG_N = NFLAG_32(res);
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -7486,10 +7102,7 @@ M68KMAKE_OP(mulu, 16, ., .)
 
 	*r_dst = res;
 
-	FLAG_Z = res;
-	FLAG_N = NFLAG_32(res);
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -8006,10 +7619,7 @@ M68KMAKE_OP(not, 8, ., d)
 
 	*r_dst = MASK_OUT_BELOW_8(*r_dst) | res;
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_8(res);
 }
 
 
@@ -8020,10 +7630,7 @@ M68KMAKE_OP(not, 8, ., .)
 
 	m68ki_write_8(ea, res);
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_8(res);
 }
 
 
@@ -8034,10 +7641,7 @@ M68KMAKE_OP(not, 16, ., d)
 
 	*r_dst = MASK_OUT_BELOW_16(*r_dst) | res;
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -8048,10 +7652,7 @@ M68KMAKE_OP(not, 16, ., .)
 
 	m68ki_write_16(ea, res);
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -8060,10 +7661,7 @@ M68KMAKE_OP(not, 32, ., d)
 	uint* r_dst = &DY;
 	uint res = *r_dst = MASK_OUT_ABOVE_32(~*r_dst);
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -8074,21 +7672,15 @@ M68KMAKE_OP(not, 32, ., .)
 
 	m68ki_write_32(ea, res);
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
 M68KMAKE_OP(or, 8, er, d)
-{
-	uint res = MASK_OUT_ABOVE_8((DX |= MASK_OUT_ABOVE_8(DY)));
-
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+{
+	uint res = MASK_OUT_ABOVE_8((DX |= MASK_OUT_ABOVE_8(DY)));
+
+	m68ki_flags_logic_8(res);
 }
 
 
@@ -8096,10 +7688,7 @@ M68KMAKE_OP(or, 8, er, .)
 {
 	uint res = MASK_OUT_ABOVE_8((DX |= M68KMAKE_GET_OPER_AY_8));
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_8(res);
 }
 
 
@@ -8107,10 +7696,7 @@ M68KMAKE_OP(or, 16, er, d)
 {
 	uint res = MASK_OUT_ABOVE_16((DX |= MASK_OUT_ABOVE_16(DY)));
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -8118,10 +7704,7 @@ M68KMAKE_OP(or, 16, er, .)
 {
 	uint res = MASK_OUT_ABOVE_16((DX |= M68KMAKE_GET_OPER_AY_16));
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -8129,10 +7712,7 @@ M68KMAKE_OP(or, 32, er, d)
 {
 	uint res = DX |= DY;
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -8140,10 +7720,7 @@ M68KMAKE_OP(or, 32, er, .)
 {
 	uint res = DX |= M68KMAKE_GET_OPER_AY_32;
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -8154,10 +7731,7 @@ M68KMAKE_OP(or, 8, re, .)
 
 	m68ki_write_8(ea, res);
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_8(res);
 }
 
 
@@ -8168,10 +7742,7 @@ M68KMAKE_OP(or, 16, re, .)
 
 	m68ki_write_16(ea, res);
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -8182,10 +7753,7 @@ M68KMAKE_OP(or, 32, re, .)
 
 	m68ki_write_32(ea, res);
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -8193,10 +7761,7 @@ M68KMAKE_OP(ori, 8, ., d)
 {
 	uint res = MASK_OUT_ABOVE_8((DY |= OPER_I_8()));
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_8(res);
 }
 
 
@@ -8208,10 +7773,7 @@ M68KMAKE_OP(ori, 8, ., .)
 
 	m68ki_write_8(ea, res);
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_8(res);
 }
 
 
@@ -8219,10 +7781,7 @@ M68KMAKE_OP(ori, 16, ., d)
 {
 	uint res = MASK_OUT_ABOVE_16(DY |= OPER_I_16());
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -8234,10 +7793,7 @@ M68KMAKE_OP(ori, 16, ., .)
 
 	m68ki_write_16(ea, res);
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -8245,10 +7801,7 @@ M68KMAKE_OP(ori, 32, ., d)
 {
 	uint res = DY |= OPER_I_32();
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -8260,10 +7813,7 @@ M68KMAKE_OP(ori, 32, ., .)
 
 	m68ki_write_32(ea, res);
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -8487,10 +8037,7 @@ M68KMAKE_OP(ror, 8, r, .)
 		return;
 	}
 
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_N = NFLAG_8(src);
-	FLAG_Z = src;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_8(src);
 }
 
 
@@ -8514,10 +8061,7 @@ M68KMAKE_OP(ror, 16, r, .)
 		return;
 	}
 
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_N = NFLAG_16(src);
-	FLAG_Z = src;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_16(src);
 }
 
 
@@ -8541,10 +8085,7 @@ M68KMAKE_OP(ror, 32, r, .)
 		return;
 	}
 
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_N = NFLAG_32(src);
-	FLAG_Z = src;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_32(src);
 }
 
 
@@ -8649,10 +8190,7 @@ M68KMAKE_OP(rol, 8, r, .)
 		return;
 	}
 
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_N = NFLAG_8(src);
-	FLAG_Z = src;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_8(src);
 }
 
 
@@ -8684,10 +8222,7 @@ M68KMAKE_OP(rol, 16, r, .)
 		return;
 	}
 
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_N = NFLAG_16(src);
-	FLAG_Z = src;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_16(src);
 }
 
 
@@ -8712,10 +8247,7 @@ M68KMAKE_OP(rol, 32, r, .)
 		return;
 	}
 
-	FLAG_C = CFLAG_CLEAR;
-	FLAG_N = NFLAG_32(src);
-	FLAG_Z = src;
-	FLAG_V = VFLAG_CLEAR;
+	m68ki_flags_logic_32(src);
 }
 
 
@@ -9519,8 +9051,8 @@ M68KMAKE_OP(stop, 0, ., .)
 		m68ki_trace_t0();			   /* auto-disable (see m68kcpu.h) */
 		CPU_STOPPED |= STOP_LEVEL_STOP;
 		m68ki_set_sr(new_sr);
-		if(m68ki_remaining_cycles >= CYC_INSTRUCTION[REG_IR])
-			m68ki_remaining_cycles = CYC_INSTRUCTION[REG_IR];
+		if(m68ki_remaining_cycles >= m68ki_opcode_cycles(REG_IR))
+			m68ki_remaining_cycles = m68ki_opcode_cycles(REG_IR);
 		else
 			USE_ALL_CYCLES();
 		return;
@@ -9536,12 +9068,9 @@ M68KMAKE_OP(sub, 8, er, d)
 	uint dst = MASK_OUT_ABOVE_8(*r_dst);
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_X = FLAG_C = CFLAG_8(res);
-	FLAG_V = VFLAG_SUB_8(src, dst, res);
-	FLAG_Z = MASK_OUT_ABOVE_8(res);
+	m68ki_flags_sub_8(src, dst, res);
 
-	*r_dst = MASK_OUT_BELOW_8(*r_dst) | FLAG_Z;
+	*r_dst = MASK_OUT_BELOW_8(*r_dst) | MASK_OUT_ABOVE_8(res);
 }
 
 
@@ -9552,12 +9081,9 @@ M68KMAKE_OP(sub, 8, er, .)
 	uint dst = MASK_OUT_ABOVE_8(*r_dst);
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_X = FLAG_C = CFLAG_8(res);
-	FLAG_V = VFLAG_SUB_8(src, dst, res);
-	FLAG_Z = MASK_OUT_ABOVE_8(res);
+	m68ki_flags_sub_8(src, dst, res);
 
-	*r_dst = MASK_OUT_BELOW_8(*r_dst) | FLAG_Z;
+	*r_dst = MASK_OUT_BELOW_8(*r_dst) | MASK_OUT_ABOVE_8(res);
 }
 
 
@@ -9568,12 +9094,9 @@ M68KMAKE_OP(sub, 16, er, d)
 	uint dst = MASK_OUT_ABOVE_16(*r_dst);
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_X = FLAG_C = CFLAG_16(res);
-	FLAG_V = VFLAG_SUB_16(src, dst, res);
-	FLAG_Z = MASK_OUT_ABOVE_16(res);
+	m68ki_flags_sub_16(src, dst, res);
 
-	*r_dst = MASK_OUT_BELOW_16(*r_dst) | FLAG_Z;
+	*r_dst = MASK_OUT_BELOW_16(*r_dst) | MASK_OUT_ABOVE_16(res);
 }
 
 
@@ -9584,12 +9107,9 @@ M68KMAKE_OP(sub, 16, er, a)
 	uint dst = MASK_OUT_ABOVE_16(*r_dst);
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_X = FLAG_C = CFLAG_16(res);
-	FLAG_V = VFLAG_SUB_16(src, dst, res);
-	FLAG_Z = MASK_OUT_ABOVE_16(res);
+	m68ki_flags_sub_16(src, dst, res);
 
-	*r_dst = MASK_OUT_BELOW_16(*r_dst) | FLAG_Z;
+	*r_dst = MASK_OUT_BELOW_16(*r_dst) | MASK_OUT_ABOVE_16(res);
 }
 
 
@@ -9600,12 +9120,9 @@ M68KMAKE_OP(sub, 16, er, .)
 	uint dst = MASK_OUT_ABOVE_16(*r_dst);
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_X = FLAG_C = CFLAG_16(res);
-	FLAG_V = VFLAG_SUB_16(src, dst, res);
-	FLAG_Z = MASK_OUT_ABOVE_16(res);
+	m68ki_flags_sub_16(src, dst, res);
 
-	*r_dst = MASK_OUT_BELOW_16(*r_dst) | FLAG_Z;
+	*r_dst = MASK_OUT_BELOW_16(*r_dst) | MASK_OUT_ABOVE_16(res);
 }
 
 
@@ -9616,12 +9133,9 @@ M68KMAKE_OP(sub, 32, er, d)
 	uint dst = *r_dst;
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_X = FLAG_C = CFLAG_SUB_32(src, dst, res);
-	FLAG_V = VFLAG_SUB_32(src, dst, res);
-	FLAG_Z = MASK_OUT_ABOVE_32(res);
+	m68ki_flags_sub_32(src, dst, res);
 
-	*r_dst = FLAG_Z;
+	*r_dst = MASK_OUT_ABOVE_32(res);
 }
 
 
@@ -9632,12 +9146,9 @@ M68KMAKE_OP(sub, 32, er, a)
 	uint dst = *r_dst;
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_X = FLAG_C = CFLAG_SUB_32(src, dst, res);
-	FLAG_V = VFLAG_SUB_32(src, dst, res);
-	FLAG_Z = MASK_OUT_ABOVE_32(res);
+	m68ki_flags_sub_32(src, dst, res);
 
-	*r_dst = FLAG_Z;
+	*r_dst = MASK_OUT_ABOVE_32(res);
 }
 
 
@@ -9648,12 +9159,9 @@ M68KMAKE_OP(sub, 32, er, .)
 	uint dst = *r_dst;
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_X = FLAG_C = CFLAG_SUB_32(src, dst, res);
-	FLAG_V = VFLAG_SUB_32(src, dst, res);
-	FLAG_Z = MASK_OUT_ABOVE_32(res);
+	m68ki_flags_sub_32(src, dst, res);
 
-	*r_dst = FLAG_Z;
+	*r_dst = MASK_OUT_ABOVE_32(res);
 }
 
 
@@ -9664,12 +9172,9 @@ M68KMAKE_OP(sub, 8, re, .)
 	uint dst = m68ki_read_8(ea);
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = MASK_OUT_ABOVE_8(res);
-	FLAG_X = FLAG_C = CFLAG_8(res);
-	FLAG_V = VFLAG_SUB_8(src, dst, res);
+	m68ki_flags_sub_8(src, dst, res);
 
-	m68ki_write_8(ea, FLAG_Z);
+	m68ki_write_8(ea, MASK_OUT_ABOVE_8(res));
 }
 
 
@@ -9680,12 +9185,9 @@ M68KMAKE_OP(sub, 16, re, .)
 	uint dst = m68ki_read_16(ea);
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = MASK_OUT_ABOVE_16(res);
-	FLAG_X = FLAG_C = CFLAG_16(res);
-	FLAG_V = VFLAG_SUB_16(src, dst, res);
+	m68ki_flags_sub_16(src, dst, res);
 
-	m68ki_write_16(ea, FLAG_Z);
+	m68ki_write_16(ea, MASK_OUT_ABOVE_16(res));
 }
 
 
@@ -9696,12 +9198,9 @@ M68KMAKE_OP(sub, 32, re, .)
 	uint dst = m68ki_read_32(ea);
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = MASK_OUT_ABOVE_32(res);
-	FLAG_X = FLAG_C = CFLAG_SUB_32(src, dst, res);
-	FLAG_V = VFLAG_SUB_32(src, dst, res);
+	m68ki_flags_sub_32(src, dst, res);
 
-	m68ki_write_32(ea, FLAG_Z);
+	m68ki_write_32(ea, MASK_OUT_ABOVE_32(res));
 }
 
 
@@ -9762,12 +9261,9 @@ M68KMAKE_OP(subi, 8, ., d)
 	uint dst = MASK_OUT_ABOVE_8(*r_dst);
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = MASK_OUT_ABOVE_8(res);
-	FLAG_X = FLAG_C = CFLAG_8(res);
-	FLAG_V = VFLAG_SUB_8(src, dst, res);
+	m68ki_flags_sub_8(src, dst, res);
 
-	*r_dst = MASK_OUT_BELOW_8(*r_dst) | FLAG_Z;
+	*r_dst = MASK_OUT_BELOW_8(*r_dst) | MASK_OUT_ABOVE_8(res);
 }
 
 
@@ -9778,12 +9274,9 @@ M68KMAKE_OP(subi, 8, ., .)
 	uint dst = m68ki_read_8(ea);
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = MASK_OUT_ABOVE_8(res);
-	FLAG_X = FLAG_C = CFLAG_8(res);
-	FLAG_V = VFLAG_SUB_8(src, dst, res);
+	m68ki_flags_sub_8(src, dst, res);
 
-	m68ki_write_8(ea, FLAG_Z);
+	m68ki_write_8(ea, MASK_OUT_ABOVE_8(res));
 }
 
 
@@ -9794,12 +9287,9 @@ M68KMAKE_OP(subi, 16, ., d)
 	uint dst = MASK_OUT_ABOVE_16(*r_dst);
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = MASK_OUT_ABOVE_16(res);
-	FLAG_X = FLAG_C = CFLAG_16(res);
-	FLAG_V = VFLAG_SUB_16(src, dst, res);
+	m68ki_flags_sub_16(src, dst, res);
 
-	*r_dst = MASK_OUT_BELOW_16(*r_dst) | FLAG_Z;
+	*r_dst = MASK_OUT_BELOW_16(*r_dst) | MASK_OUT_ABOVE_16(res);
 }
 
 
@@ -9810,12 +9300,9 @@ M68KMAKE_OP(subi, 16, ., .)
 	uint dst = m68ki_read_16(ea);
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = MASK_OUT_ABOVE_16(res);
-	FLAG_X = FLAG_C = CFLAG_16(res);
-	FLAG_V = VFLAG_SUB_16(src, dst, res);
+	m68ki_flags_sub_16(src, dst, res);
 
-	m68ki_write_16(ea, FLAG_Z);
+	m68ki_write_16(ea, MASK_OUT_ABOVE_16(res));
 }
 
 
@@ -9826,12 +9313,9 @@ M68KMAKE_OP(subi, 32, ., d)
 	uint dst = *r_dst;
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = MASK_OUT_ABOVE_32(res);
-	FLAG_X = FLAG_C = CFLAG_SUB_32(src, dst, res);
-	FLAG_V = VFLAG_SUB_32(src, dst, res);
+	m68ki_flags_sub_32(src, dst, res);
 
-	*r_dst = FLAG_Z;
+	*r_dst = MASK_OUT_ABOVE_32(res);
 }
 
 
@@ -9842,12 +9326,9 @@ M68KMAKE_OP(subi, 32, ., .)
 	uint dst = m68ki_read_32(ea);
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = MASK_OUT_ABOVE_32(res);
-	FLAG_X = FLAG_C = CFLAG_SUB_32(src, dst, res);
-	FLAG_V = VFLAG_SUB_32(src, dst, res);
+	m68ki_flags_sub_32(src, dst, res);
 
-	m68ki_write_32(ea, FLAG_Z);
+	m68ki_write_32(ea, MASK_OUT_ABOVE_32(res));
 }
 
 
@@ -9858,12 +9339,9 @@ M68KMAKE_OP(subq, 8, ., d)
 	uint dst = MASK_OUT_ABOVE_8(*r_dst);
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = MASK_OUT_ABOVE_8(res);
-	FLAG_X = FLAG_C = CFLAG_8(res);
-	FLAG_V = VFLAG_SUB_8(src, dst, res);
+	m68ki_flags_sub_8(src, dst, res);
 
-	*r_dst = MASK_OUT_BELOW_8(*r_dst) | FLAG_Z;
+	*r_dst = MASK_OUT_BELOW_8(*r_dst) | MASK_OUT_ABOVE_8(res);
 }
 
 
@@ -9874,12 +9352,9 @@ M68KMAKE_OP(subq, 8, ., .)
 	uint dst = m68ki_read_8(ea);
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = MASK_OUT_ABOVE_8(res);
-	FLAG_X = FLAG_C = CFLAG_8(res);
-	FLAG_V = VFLAG_SUB_8(src, dst, res);
+	m68ki_flags_sub_8(src, dst, res);
 
-	m68ki_write_8(ea, FLAG_Z);
+	m68ki_write_8(ea, MASK_OUT_ABOVE_8(res));
 }
 
 
@@ -9890,12 +9365,9 @@ M68KMAKE_OP(subq, 16, ., d)
 	uint dst = MASK_OUT_ABOVE_16(*r_dst);
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = MASK_OUT_ABOVE_16(res);
-	FLAG_X = FLAG_C = CFLAG_16(res);
-	FLAG_V = VFLAG_SUB_16(src, dst, res);
+	m68ki_flags_sub_16(src, dst, res);
 
-	*r_dst = MASK_OUT_BELOW_16(*r_dst) | FLAG_Z;
+	*r_dst = MASK_OUT_BELOW_16(*r_dst) | MASK_OUT_ABOVE_16(res);
 }
 
 
@@ -9914,12 +9386,9 @@ M68KMAKE_OP(subq, 16, ., .)
 	uint dst = m68ki_read_16(ea);
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = MASK_OUT_ABOVE_16(res);
-	FLAG_X = FLAG_C = CFLAG_16(res);
-	FLAG_V = VFLAG_SUB_16(src, dst, res);
+	m68ki_flags_sub_16(src, dst, res);
 
-	m68ki_write_16(ea, FLAG_Z);
+	m68ki_write_16(ea, MASK_OUT_ABOVE_16(res));
 }
 
 
@@ -9930,12 +9399,9 @@ M68KMAKE_OP(subq, 32, ., d)
 	uint dst = *r_dst;
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = MASK_OUT_ABOVE_32(res);
-	FLAG_X = FLAG_C = CFLAG_SUB_32(src, dst, res);
-	FLAG_V = VFLAG_SUB_32(src, dst, res);
+	m68ki_flags_sub_32(src, dst, res);
 
-	*r_dst = FLAG_Z;
+	*r_dst = MASK_OUT_ABOVE_32(res);
 }
 
 
@@ -9954,12 +9420,9 @@ M68KMAKE_OP(subq, 32, ., .)
 	uint dst = m68ki_read_32(ea);
 	uint res = dst - src;
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = MASK_OUT_ABOVE_32(res);
-	FLAG_X = FLAG_C = CFLAG_SUB_32(src, dst, res);
-	FLAG_V = VFLAG_SUB_32(src, dst, res);
+	m68ki_flags_sub_32(src, dst, res);
 
-	m68ki_write_32(ea, FLAG_Z);
+	m68ki_write_32(ea, MASK_OUT_ABOVE_32(res));
 }
 
 
@@ -10157,10 +9620,7 @@ M68KMAKE_OP(tas, 8, ., .)
 	uint dst = m68ki_read_8(ea);
 	uint allow_writeback;
 
-	FLAG_Z = dst;
-	FLAG_N = NFLAG_8(dst);
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_8(dst);
 
 	/* The Genesis/Megadrive games Gargoyles and Ex-Mutants need the TAS writeback
        disabled in order to function properly.  Some Amiga software may also rely
@@ -10305,10 +9765,7 @@ M68KMAKE_OP(tst, 8, ., d)
 {
 	uint res = MASK_OUT_ABOVE_8(DY);
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_8(res);
 }
 
 
@@ -10316,10 +9773,7 @@ M68KMAKE_OP(tst, 8, ., .)
 {
 	uint res = M68KMAKE_GET_OPER_AY_8;
 
-	FLAG_N = NFLAG_8(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_8(res);
 }
 
 
@@ -10329,10 +9783,7 @@ M68KMAKE_OP(tst, 8, ., pcdi)
 	{
 		uint res = OPER_PCDI_8();
 
-		FLAG_N = NFLAG_8(res);
-		FLAG_Z = res;
-		FLAG_V = VFLAG_CLEAR;
-		FLAG_C = CFLAG_CLEAR;
+		m68ki_flags_logic_8(res);
 		return;
 	}
 	m68ki_exception_illegal();
@@ -10345,10 +9796,7 @@ M68KMAKE_OP(tst, 8, ., pcix)
 	{
 		uint res = OPER_PCIX_8();
 
-		FLAG_N = NFLAG_8(res);
-		FLAG_Z = res;
-		FLAG_V = VFLAG_CLEAR;
-		FLAG_C = CFLAG_CLEAR;
+		m68ki_flags_logic_8(res);
 		return;
 	}
 	m68ki_exception_illegal();
@@ -10361,10 +9809,7 @@ M68KMAKE_OP(tst, 8, ., i)
 	{
 		uint res = OPER_I_8();
 
-		FLAG_N = NFLAG_8(res);
-		FLAG_Z = res;
-		FLAG_V = VFLAG_CLEAR;
-		FLAG_C = CFLAG_CLEAR;
+		m68ki_flags_logic_8(res);
 		return;
 	}
 	m68ki_exception_illegal();
@@ -10375,10 +9820,7 @@ M68KMAKE_OP(tst, 16, ., d)
 {
 	uint res = MASK_OUT_ABOVE_16(DY);
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -10388,10 +9830,7 @@ M68KMAKE_OP(tst, 16, ., a)
 	{
 		uint res = MAKE_INT_16(AY);
 
-		FLAG_N = NFLAG_16(res);
-		FLAG_Z = res;
-		FLAG_V = VFLAG_CLEAR;
-		FLAG_C = CFLAG_CLEAR;
+		m68ki_flags_logic_16(res);
 		return;
 	}
 	m68ki_exception_illegal();
@@ -10402,10 +9841,7 @@ M68KMAKE_OP(tst, 16, ., .)
 {
 	uint res = M68KMAKE_GET_OPER_AY_16;
 
-	FLAG_N = NFLAG_16(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_16(res);
 }
 
 
@@ -10415,10 +9851,7 @@ M68KMAKE_OP(tst, 16, ., pcdi)
 	{
 		uint res = OPER_PCDI_16();
 
-		FLAG_N = NFLAG_16(res);
-		FLAG_Z = res;
-		FLAG_V = VFLAG_CLEAR;
-		FLAG_C = CFLAG_CLEAR;
+		m68ki_flags_logic_16(res);
 		return;
 	}
 	m68ki_exception_illegal();
@@ -10431,10 +9864,7 @@ M68KMAKE_OP(tst, 16, ., pcix)
 	{
 		uint res = OPER_PCIX_16();
 
-		FLAG_N = NFLAG_16(res);
-		FLAG_Z = res;
-		FLAG_V = VFLAG_CLEAR;
-		FLAG_C = CFLAG_CLEAR;
+		m68ki_flags_logic_16(res);
 		return;
 	}
 	m68ki_exception_illegal();
@@ -10447,10 +9877,7 @@ M68KMAKE_OP(tst, 16, ., i)
 	{
 		uint res = OPER_I_16();
 
-		FLAG_N = NFLAG_16(res);
-		FLAG_Z = res;
-		FLAG_V = VFLAG_CLEAR;
-		FLAG_C = CFLAG_CLEAR;
+		m68ki_flags_logic_16(res);
 		return;
 	}
 	m68ki_exception_illegal();
@@ -10461,10 +9888,7 @@ M68KMAKE_OP(tst, 32, ., d)
 {
 	uint res = DY;
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -10474,10 +9898,7 @@ M68KMAKE_OP(tst, 32, ., a)
 	{
 		uint res = AY;
 
-		FLAG_N = NFLAG_32(res);
-		FLAG_Z = res;
-		FLAG_V = VFLAG_CLEAR;
-		FLAG_C = CFLAG_CLEAR;
+		m68ki_flags_logic_32(res);
 		return;
 	}
 	m68ki_exception_illegal();
@@ -10488,10 +9909,7 @@ M68KMAKE_OP(tst, 32, ., .)
 {
 	uint res = M68KMAKE_GET_OPER_AY_32;
 
-	FLAG_N = NFLAG_32(res);
-	FLAG_Z = res;
-	FLAG_V = VFLAG_CLEAR;
-	FLAG_C = CFLAG_CLEAR;
+	m68ki_flags_logic_32(res);
 }
 
 
@@ -10501,10 +9919,7 @@ M68KMAKE_OP(tst, 32, ., pcdi)
 	{
 		uint res = OPER_PCDI_32();
 
-		FLAG_N = NFLAG_32(res);
-		FLAG_Z = res;
-		FLAG_V = VFLAG_CLEAR;
-		FLAG_C = CFLAG_CLEAR;
+		m68ki_flags_logic_32(res);
 		return;
 	}
 	m68ki_exception_illegal();
@@ -10517,10 +9932,7 @@ M68KMAKE_OP(tst, 32, ., pcix)
 	{
 		uint res = OPER_PCIX_32();
 
-		FLAG_N = NFLAG_32(res);
-		FLAG_Z = res;
-		FLAG_V = VFLAG_CLEAR;
-		FLAG_C = CFLAG_CLEAR;
+		m68ki_flags_logic_32(res);
 		return;
 	}
 	m68ki_exception_illegal();
@@ -10533,10 +9945,7 @@ M68KMAKE_OP(tst, 32, ., i)
 	{
 		uint res = OPER_I_32();
 
-		FLAG_N = NFLAG_32(res);
-		FLAG_Z = res;
-		FLAG_V = VFLAG_CLEAR;
-		FLAG_C = CFLAG_CLEAR;
+		m68ki_flags_logic_32(res);
 		return;
 	}
 	m68ki_exception_illegal();
@@ -41,13 +41,22 @@
 extern void m68040_fpu_op0(void);
 extern void m68040_fpu_op1(void);
 extern void m68881_mmu_ops(void);
-extern unsigned char m68ki_cycles[][0x10000];
 extern void (*m68ki_instruction_jump_table[0x10000])(void); /* opcode handler jump table */
 extern void m68ki_build_opcode_table(void);
 
 #include "m68kops.h"
 #include "m68kcpu.h"
 
+#if M68K_68000_ONLY && (M68K_EMULATE_010 || M68K_EMULATE_EC020 || M68K_EMULATE_020 || M68K_EMULATE_030 || M68K_EMULATE_040)
+#error "M68K_68000_ONLY needs the other CPU variants turned off"
+#endif
+#if defined(M68KOPS_CPU_ONLY) && (M68KOPS_CPU_ONLY != 0 || M68K_EMULATE_010 || M68K_EMULATE_EC020 || M68K_EMULATE_020 || M68K_EMULATE_030 || M68K_EMULATE_040)
+#error "m68kops.c lacks the handlers of the emulated CPU variants, run m68kmake without a CPU"
+#endif
+#if M68K_COMPACT_DISPATCH && (!M68K_68000_ONLY || !defined(M68KOPS_CPU_ONLY))
+#error "M68K_COMPACT_DISPATCH needs M68K_68000_ONLY and m68kops.c generated for 000"
+#endif
+
 #include "m68kfpu.c"
 #include "m68kmmu.h" // uses some functions from m68kfpu.c which are static !
 
@@ -92,7 +101,9 @@ uint    m68ki_aerr_address;
 uint    m68ki_aerr_write_mode;
 uint    m68ki_aerr_fc;
 
+#if M68K_EMULATE_BUS_ERROR
 jmp_buf m68ki_bus_error_jmp_buf;
+#endif
 
 /* Used by shift & rotate instructions */
 const uint8 m68ki_shift_8_table[65] =
@@ -609,6 +620,92 @@ static void default_instr_hook_callback(unsigned int pc)
 	#endif
 #endif /* M68K_EMULATE_ADDRESS_ERROR */
 
+#if M68K_LAZY_FLAGS
+/* Bits of a pending result that make up Z and N, by M68KI_FLAGS_xx */
+const uint m68ki_flags_z_mask[] =
+{
+	0,
+	0xffffffff, 0xffffffff, 0xffffffff,
+	0xff, 0xffff, 0xffffffff,
+	0xff, 0xffff, 0xffffffff
+};
+
+const uint m68ki_flags_n_mask[] =
+{
+	0,
+	0x80, 0x8000, 0x80000000,
+	0x80, 0x8000, 0x80000000,
+	0x80, 0x8000, 0x80000000
+};
+
+/* Compute N, Z, V and C the way the eager core does for the recorded operation */
+void m68ki_flags_resolve(m68ki_cpu_core* cpu)
+{
+	uint src = cpu->flag_src;
+	uint dst = cpu->flag_dst;
+	uint res = cpu->flag_res;
+
+	switch(cpu->flag_op)
+	{
+		case M68KI_FLAGS_LOGIC_8:
+			cpu->n_flag = NFLAG_8(res);
+			cpu->not_z_flag = res;
+			cpu->v_flag = VFLAG_CLEAR;
+			cpu->c_flag = CFLAG_CLEAR;
+			break;
+		case M68KI_FLAGS_LOGIC_16:
+			cpu->n_flag = NFLAG_16(res);
+			cpu->not_z_flag = res;
+			cpu->v_flag = VFLAG_CLEAR;
+			cpu->c_flag = CFLAG_CLEAR;
+			break;
+		case M68KI_FLAGS_LOGIC_32:
+			cpu->n_flag = NFLAG_32(res);
+			cpu->not_z_flag = res;
+			cpu->v_flag = VFLAG_CLEAR;
+			cpu->c_flag = CFLAG_CLEAR;
+			break;
+		case M68KI_FLAGS_ADD_8:
+			cpu->n_flag = NFLAG_8(res);
+			cpu->not_z_flag = MASK_OUT_ABOVE_8(res);
+			cpu->v_flag = VFLAG_ADD_8(src, dst, res);
+			cpu->c_flag = CFLAG_8(res);
+			break;
+		case M68KI_FLAGS_ADD_16:
+			cpu->n_flag = NFLAG_16(res);
+			cpu->not_z_flag = MASK_OUT_ABOVE_16(res);
+			cpu->v_flag = VFLAG_ADD_16(src, dst, res);
+			cpu->c_flag = CFLAG_16(res);
+			break;
+		case M68KI_FLAGS_ADD_32:
+			cpu->n_flag = NFLAG_32(res);
+			cpu->not_z_flag = MASK_OUT_ABOVE_32(res);
+			cpu->v_flag = VFLAG_ADD_32(src, dst, res);
+			cpu->c_flag = CFLAG_ADD_32(src, dst, res);
+			break;
+		case M68KI_FLAGS_SUB_8:
+			cpu->n_flag = NFLAG_8(res);
+			cpu->not_z_flag = MASK_OUT_ABOVE_8(res);
+			cpu->v_flag = VFLAG_SUB_8(src, dst, res);
+			cpu->c_flag = CFLAG_8(res);
+			break;
+		case M68KI_FLAGS_SUB_16:
+			cpu->n_flag = NFLAG_16(res);
+			cpu->not_z_flag = MASK_OUT_ABOVE_16(res);
+			cpu->v_flag = VFLAG_SUB_16(src, dst, res);
+			cpu->c_flag = CFLAG_16(res);
+			break;
+		case M68KI_FLAGS_SUB_32:
+			cpu->n_flag = NFLAG_32(res);
+			cpu->not_z_flag = MASK_OUT_ABOVE_32(res);
+			cpu->v_flag = VFLAG_SUB_32(src, dst, res);
+			cpu->c_flag = CFLAG_SUB_32(src, dst, res);
+			break;
+	}
+	cpu->flag_op = M68KI_FLAGS_EAGER;
+}
+#endif /* M68K_LAZY_FLAGS */
+
 /* ======================================================================== */
 /* ================================= API ================================== */
 /* ======================================================================== */
@@ -637,7 +734,11 @@ unsigned int m68k_get_reg(void* context, m68k_register_t regnum)
 		case M68K_REG_A6:	return cpu->dar[14];
 		case M68K_REG_A7:	return cpu->dar[15];
 		case M68K_REG_PC:	return MASK_OUT_ABOVE_32(cpu->pc);
-		case M68K_REG_SR:	return	cpu->t1_flag						|
+		case M68K_REG_SR:
+#if M68K_LAZY_FLAGS
+							m68ki_flags_resolve(cpu);
+#endif /* M68K_LAZY_FLAGS */
+							return	cpu->t1_flag						|
 									cpu->t0_flag						|
 									(cpu->s_flag << 11)					|
 									(cpu->m_flag << 11)					|
@@ -779,6 +880,19 @@ void m68k_set_instr_hook_callback(void  (*callback)(unsigned int pc))
 /* Set the CPU type. */
 void m68k_set_cpu_type(unsigned int cpu_type)
 {
+#if M68K_68000_ONLY
+	/* The CPU type and its tables are constants, the fields are only kept
+	 * for m68k_get_reg() and saved contexts.
+	 */
+	(void)cpu_type;
+	m68ki_cpu.cpu_type         = CPU_TYPE_000;
+	m68ki_cpu.address_mask     = CPU_ADDRESS_MASK;
+	m68ki_cpu.sr_mask          = CPU_SR_MASK;
+#if !M68K_COMPACT_DISPATCH
+	m68ki_cpu.cyc_instruction  = CYC_INSTRUCTION;
+#endif
+	m68ki_cpu.cyc_exception    = CYC_EXCEPTION;
+#else
 	switch(cpu_type)
 	{
 		case M68K_CPU_TYPE_68000:
@@ -939,8 +1053,401 @@ void m68k_set_cpu_type(unsigned int cpu_type)
 			HAS_PMMU	       = 1;
 			return;
 	}
+#endif /* M68K_68000_ONLY */
 }
 
+/* The compiler of hot traces needs the trace cache and an x86-64 host */
+#if M68K_BLOCK_CACHE && M68K_JIT && (defined(__x86_64__) || defined(_M_X64))
+#define M68KI_JIT 1
+#else
+#define M68KI_JIT 0
+#endif
+
+#if M68K_BLOCK_CACHE
+/* Trace cache.  A trace is the sequence of instructions run from a start PC
+ * within one code page, up to M68KI_BLOCK_LENGTH long.  It may follow taken
+ * branches: every replayed instruction still runs its handler and the replay
+ * stops as soon as the PC differs from the recorded one.  While replaying,
+ * operands are read straight from the host memory of the page.
+ */
+#define M68KI_BLOCK_BITS      12
+#define M68KI_BLOCK_COUNT     (1 << M68KI_BLOCK_BITS)
+#define M68KI_BLOCK_LENGTH    16
+#define M68KI_BLOCK_PAGE_MASK ((1 << M68K_BLOCK_PAGE_BITS) - 1)
+#define M68KI_BLOCK_PAGES     (0x1000000 >> M68K_BLOCK_PAGE_BITS)
+#define M68KI_BLOCK_THRASH    64 /* Invalidations until a page is no longer cached */
+#define M68KI_BLOCK_NO_BASE   1  /* Never matches a page address */
+
+typedef struct
+{
+	void (*handler)(void);
+	uint16 ir;
+	uint16 cycles;
+	uint next_pc;
+} m68ki_block_insn;
+
+typedef struct
+{
+	uint pc;
+	uint gen;
+	uint count;
+	uint hits;                 /* Replays of the trace */
+	void (*code)(void);        /* Compiled trace or NULL */
+	uint idiom;                /* Copy or fill loop at pc (body << 16 | dbf) or 0 */
+	m68ki_block_insn insn[M68KI_BLOCK_LENGTH];
+} m68ki_block;
+
+static m68ki_block m68ki_blocks[M68KI_BLOCK_COUNT];
+static uint m68ki_page_gen[M68KI_BLOCK_PAGES];
+static const uint8* m68ki_page_host[M68KI_BLOCK_PAGES]; /* NULL if the page is not cached */
+static uint8 m68ki_page_known[M68KI_BLOCK_PAGES];
+static uint8 m68ki_page_inval[M68KI_BLOCK_PAGES];
+
+uint m68ki_block_base = M68KI_BLOCK_NO_BASE;  /* Page whose operands are read from m68ki_block_host */
+const uint8* m68ki_block_host;
+uint m68ki_block_words;                        /* Words fetched by the replayed instruction */
+
+#if M68KI_JIT
+#include "m68kjit.c"
+#endif
+
+void m68k_block_invalidate(unsigned int address)
+{
+	uint page = (address & 0xffffff) >> M68K_BLOCK_PAGE_BITS;
+
+	m68ki_page_gen[page]++;
+	/* A fused handler must not start its second instruction */
+	if(((m68ki_block_base & 0xffffff) >> M68K_BLOCK_PAGE_BITS) == page)
+		m68ki_block_base = M68KI_BLOCK_NO_BASE;
+	if(m68ki_page_host[page] != NULL)
+	{
+		m68ki_page_host[page] = NULL;
+		m68ki_page_known[page] = ++m68ki_page_inval[page] >= M68KI_BLOCK_THRASH;
+	}
+}
+
+void m68k_block_flush(void)
+{
+	uint page;
+
+	for(page = 0; page < M68KI_BLOCK_PAGES; page++)
+	{
+		m68ki_page_gen[page]++;
+		m68ki_page_host[page] = NULL;
+		m68ki_page_known[page] = 0;
+		m68ki_page_inval[page] = 0;
+	}
+}
+
+/* Run one instruction the usual way */
+static inline void m68ki_block_step(void)
+{
+	REG_PPC = REG_PC;
+	m68ki_save_bus_error_regs(); /* auto-disable (see m68kcpu.h) */
+	REG_IR = m68ki_read_imm_16();
+	m68ki_opcode_handler(REG_IR)();
+	USE_CYCLES(m68ki_opcode_cycles(REG_IR));
+}
+
+#if M68K_BLOCK_IDIOM
+/* Returns the body and dbf opcodes if the code at pc is a two instruction
+ * copy or fill loop, otherwise 0:
+ *   move.s (Ay)+,(Ax)+ / move.s Dy,(Ax)+ / clr.s (Ax)+
+ *   dbf    Dn,<first>
+ */
+static uint m68ki_block_idiom(const uint8* host, uint pc)
+{
+	uint offset = pc & M68KI_BLOCK_PAGE_MASK;
+	uint ir;
+	uint dbf;
+	uint size;
+	uint dst;
+
+	if(offset > M68KI_BLOCK_PAGE_MASK + 1 - 6)
+		return 0;
+	ir = (host[offset] << 8) | host[offset + 1];
+	dbf = (host[offset + 2] << 8) | host[offset + 3];
+	if((dbf & 0xfff8) != 0x51c8 || ((host[offset + 4] << 8) | host[offset + 5]) != 0xfffc)
+		return 0;
+
+	dst = ir & 7;
+	if((ir & 0xff38) == 0x4218 && (ir & 0xc0) != 0xc0)
+		size = 1 << ((ir >> 6) & 3);
+	else if((ir & 0xc1f8) == 0x00d8 || (ir & 0xc1f8) == 0x00c0)
+	{
+		size = (ir & 0x3000) == 0x1000 ? 1 : (ir & 0x3000) == 0x3000 ? 2 : (ir & 0x3000) == 0x2000 ? 4 : 0;
+		dst = (ir >> 9) & 7;
+		if(size == 0)
+			return 0;
+		if((ir & 0x0038) == 0x0018 && ((ir & 7) == dst || (size == 1 && (ir & 7) == 7)))
+			return 0;
+		if((ir & 0x0038) == 0x0000 && (ir & 7) == (dbf & 7))
+			return 0;
+	}
+	else
+		return 0;
+	/* Byte accesses through A7 step by two */
+	if(size == 1 && dst == 7)
+		return 0;
+	return (ir << 16) | dbf;
+}
+
+/* Run the remaining iterations of the copy or fill loop of a trace at once,
+ * as many as the interpreter would run in the cycles left.  Returns 0 if the
+ * host refused them.
+ */
+static int m68ki_block_loop(m68ki_block *block)
+{
+	uint ir = block->idiom >> 16;
+	uint dbf = block->idiom & 0xffff;
+	uint* r_cnt = &REG_D[dbf & 7];
+	uint count = MASK_OUT_ABOVE_16(*r_cnt) + 1;
+	int body = m68ki_opcode_cycles(ir);
+	int taken = m68ki_opcode_cycles(dbf) + CYC_DBCC_F_NOEXP;
+	uint* r_dst;
+	uint size;
+	uint last;
+	uint n;
+
+	if(GET_CYCLES() <= body)
+		return 0;
+	n = (GET_CYCLES() - body - 1) / (body + taken) + 1;
+	if(n > count)
+		n = count;
+
+	if((ir & 0xff00) == 0x4200)
+	{
+		size = 1 << ((ir >> 6) & 3);
+		r_dst = &REG_A[ir & 7];
+		if(!m68ki_block_fill(ADDRESS_68K(*r_dst), 0, size, n))
+			return 0;
+		FLAG_N = NFLAG_CLEAR;
+		FLAG_Z = ZFLAG_SET;
+	}
+	else
+	{
+		size = (ir & 0x3000) == 0x1000 ? 1 : (ir & 0x3000) == 0x3000 ? 2 : 4;
+		r_dst = &REG_A[(ir >> 9) & 7];
+		if(ir & 0x0038)
+		{
+			uint* r_src = &REG_A[ir & 7];
+
+			if(!m68ki_block_copy(ADDRESS_68K(*r_dst), ADDRESS_68K(*r_src), size, n, &last))
+				return 0;
+			*r_src += n * size;
+		}
+		else
+		{
+			last = REG_D[ir & 7] & (0xffffffff >> (32 - 8 * size));
+			if(!m68ki_block_fill(ADDRESS_68K(*r_dst), last, size, n))
+				return 0;
+		}
+		FLAG_N = size == 1 ? NFLAG_8(last) : size == 2 ? NFLAG_16(last) : NFLAG_32(last);
+		FLAG_Z = last;
+	}
+	FLAG_V = VFLAG_CLEAR;
+	FLAG_C = CFLAG_CLEAR;
+	*r_dst += n * size;
+	*r_cnt = MASK_OUT_BELOW_16(*r_cnt) | MASK_OUT_ABOVE_16(count - 1 - n);
+
+	/* The state after the last dbf */
+	REG_PPC = REG_PC + 2;
+	REG_IR = dbf;
+	if(n == count)
+	{
+		REG_PC += 6;
+		USE_CYCLES(n * (body + taken) - taken + m68ki_opcode_cycles(dbf) + CYC_DBCC_F_EXP);
+		m68ki_block_fetch(3 * n - 1);
+	}
+	else
+	{
+		USE_CYCLES(n * (body + taken));
+		m68ki_block_fetch(3 * n);
+	}
+	return 1;
+}
+#endif /* M68K_BLOCK_IDIOM */
+
+/* Run a valid trace through its compiled code or the replay loop */
+static void m68ki_block_replay(m68ki_block *block, uint page)
+{
+	m68ki_block_insn *insn;
+	uint n;
+
+	m68ki_block_base = REG_PC & ~M68KI_BLOCK_PAGE_MASK;
+	m68ki_block_host = m68ki_page_host[page];
+#if M68K_BLOCK_IDIOM
+	if(block->idiom != 0 && m68ki_block_loop(block))
+	{
+		m68ki_block_base = M68KI_BLOCK_NO_BASE;
+		return;
+	}
+#endif
+#if M68KI_JIT
+	if(block->code != NULL)
+	{
+		block->code();
+		m68ki_block_base = M68KI_BLOCK_NO_BASE;
+		return;
+	}
+	if(m68ki_jit_threshold != 0 && ++block->hits >= m68ki_jit_threshold)
+		m68ki_jit_compile(block, page);
+#endif
+	for(n = 0, insn = block->insn; n < block->count; n++, insn++)
+	{
+		REG_PPC = REG_PC;
+		m68ki_save_bus_error_regs(); /* auto-disable (see m68kcpu.h) */
+		REG_IR = insn->ir;
+		REG_PC += 2;
+		m68ki_block_words = 1;
+		insn->handler();
+		m68ki_block_fetch(m68ki_block_words);
+		USE_CYCLES(insn->cycles);
+		if(REG_PC != insn->next_pc || GET_CYCLES() <= 0 || block->gen != m68ki_page_gen[page])
+			break;
+	}
+	m68ki_block_base = M68KI_BLOCK_NO_BASE;
+}
+
+#if M68K_LOCKSTEP
+static int m68ki_lockstep;      /* Verify every replayed trace */
+
+/* Run a trace, then run the interpreter from the same state while the host
+ * serves memory from its shadow copy, and let the host compare the results.
+ * The CPU continues with the state of the trace.
+ */
+static void m68ki_block_verify(m68ki_block *block, uint page)
+{
+	static m68ki_cpu_core before, fast, reference;
+	int before_cycles = GET_CYCLES();
+	int before_initial = m68ki_initial_cycles;
+	int fast_cycles;
+	int fast_initial;
+
+	m68k_get_context(&before);
+	m68ki_lockstep_begin();
+	m68ki_block_replay(block, page);
+	m68k_get_context(&fast);
+	fast_cycles = GET_CYCLES();
+	fast_initial = m68ki_initial_cycles;
+
+	if(!m68ki_lockstep_reference())
+	{
+		m68ki_lockstep_end(NULL, NULL, 0, 0);
+		return;
+	}
+	m68k_set_context(&before);
+	SET_CYCLES(before_cycles);
+	m68ki_initial_cycles = before_initial;
+	while(GET_CYCLES() > fast_cycles && !CPU_STOPPED)
+		m68ki_block_step();
+	m68k_get_context(&reference);
+	m68ki_lockstep_end(&fast, &reference, before_cycles - fast_cycles, before_cycles - GET_CYCLES());
+
+	m68k_set_context(&fast);
+	SET_CYCLES(fast_cycles);
+	m68ki_initial_cycles = fast_initial;
+}
+
+void m68k_set_lockstep(int enable)
+{
+	m68ki_lockstep = enable;
+}
+#endif /* M68K_LOCKSTEP */
+
+/* Replay the trace starting at the current PC, or record a new one */
+static void m68ki_block_run(void)
+{
+	m68ki_block *block = &m68ki_blocks[(REG_PC >> 1) & (M68KI_BLOCK_COUNT - 1)];
+	uint pc = ADDRESS_68K(REG_PC);
+	uint page = (pc & 0xffffff) >> M68K_BLOCK_PAGE_BITS;
+	m68ki_block_insn *insn;
+
+	m68ki_block_base = M68KI_BLOCK_NO_BASE;
+
+	if(block->pc == REG_PC && block->gen == m68ki_page_gen[page] && block->count != 0)
+	{
+#if M68K_LOCKSTEP
+		if(m68ki_lockstep)
+		{
+			m68ki_block_verify(block, page);
+			return;
+		}
+#endif
+		m68ki_block_replay(block, page);
+		return;
+	}
+
+	if(!m68ki_page_known[page])
+	{
+		m68ki_page_host[page] = (const uint8*)m68ki_block_page_host(pc & ~M68KI_BLOCK_PAGE_MASK);
+		m68ki_page_known[page] = 1;
+	}
+	if(m68ki_page_host[page] == NULL)
+	{
+		m68ki_block_step();
+		return;
+	}
+
+	/* The generation is taken first, so a write to the page while recording
+	 * leaves a trace that never matches.
+	 */
+	block->pc = REG_PC;
+	block->gen = m68ki_page_gen[page];
+	block->count = 0;
+	block->hits = 0;
+	block->code = NULL;
+#if M68K_BLOCK_IDIOM
+	block->idiom = m68ki_block_idiom(m68ki_page_host[page], pc);
+#endif
+	for(insn = block->insn; block->count < M68KI_BLOCK_LENGTH; insn++)
+	{
+		m68ki_block_step();
+		insn->handler = m68ki_opcode_handler(REG_IR);
+		insn->ir = REG_IR;
+		insn->cycles = m68ki_opcode_cycles(REG_IR);
+		insn->next_pc = REG_PC;
+		block->count++;
+#if M68K_FUSION
+		/* A listed pair is replayed through its fused handler */
+		if(block->count >= 2 && insn[-1].handler == m68ki_opcode_handler(insn[-1].ir))
+		{
+			void (*fused)(void) = m68ki_fusion_handler(insn[-1].ir, insn->ir);
+
+			if(fused != NULL)
+			{
+				insn--;
+				insn->handler = fused;
+				insn->next_pc = REG_PC;
+				block->count--;
+			}
+		}
+#endif /* M68K_FUSION */
+		if(GET_CYCLES() <= 0 || CPU_STOPPED || ((ADDRESS_68K(REG_PC) & 0xffffff) >> M68K_BLOCK_PAGE_BITS) != page)
+			break;
+#if M68K_BLOCK_IDIOM
+		/* A loop gets a trace of its own, so it can run at once */
+		if(REG_PC != block->pc && m68ki_page_host[page] != NULL && m68ki_block_idiom(m68ki_page_host[page], ADDRESS_68K(REG_PC)))
+			break;
+#endif
+	}
+}
+#endif /* M68K_BLOCK_CACHE */
+
+#if !M68KI_JIT
+void m68k_set_jit_threshold(unsigned int threshold)
+{
+	(void)threshold;
+}
+#endif
+
+#if !M68K_BLOCK_CACHE || !M68K_LOCKSTEP
+void m68k_set_lockstep(int enable)
+{
+	(void)enable;
+}
+#endif
+
 /* Execute some instructions until we use up num_cycles clock cycles */
 /* ASG: removed per-instruction interrupt checks */
 int m68k_execute(int num_cycles)
@@ -967,12 +1474,11 @@ int m68k_execute(int num_cycles)
 		/* Return point if we had an address error */
 		m68ki_set_address_error_trap(); /* auto-disable (see m68kcpu.h) */
 
-		m68ki_check_bus_error_trap();
+		m68ki_check_bus_error_trap(); /* auto-disable (see m68kcpu.h) */
 
 		/* Main loop.  Keep going until we run out of clock cycles */
 		do
 		{
-			int i;
 			/* Set tracing accodring to T1. (T0 is done inside instruction) */
 			m68ki_trace_t1(); /* auto-disable (see m68kcpu.h) */
 
@@ -982,18 +1488,21 @@ int m68k_execute(int num_cycles)
 			/* Call external hook to peek at CPU */
 			m68ki_instr_hook(REG_PC); /* auto-disable (see m68kcpu.h) */
 
+#if M68K_BLOCK_CACHE
+			/* Replay or record a trace of decoded instructions */
+			m68ki_block_run();
+#else
 			/* Record previous program counter */
 			REG_PPC = REG_PC;
 
 			/* Record previous D/A register state (in case of bus error) */
-			for (i = 15; i >= 0; i--){
-				REG_DA_SAVE[i] = REG_DA[i];
-			}
+			m68ki_save_bus_error_regs(); /* auto-disable (see m68kcpu.h) */
 
 			/* Read an instruction and call its handler */
 			REG_IR = m68ki_read_imm_16();
-			m68ki_instruction_jump_table[REG_IR]();
-			USE_CYCLES(CYC_INSTRUCTION[REG_IR]);
+			m68ki_opcode_handler(REG_IR)();
+			USE_CYCLES(m68ki_opcode_cycles(REG_IR));
+#endif /* M68K_BLOCK_CACHE */
 
 			/* Trace m68k_exception, if necessary */
 			m68ki_exception_if_trace(); /* auto-disable (see m68kcpu.h) */
@@ -1098,7 +1607,9 @@ void m68k_init(void)
 /* Trigger a Bus Error exception */
 void m68k_pulse_bus_error(void)
 {
+#if M68K_EMULATE_BUS_ERROR
 	m68ki_exception_bus_error();
+#endif
 }
 
 /* Pulse the RESET line on the CPU */
@@ -325,7 +325,11 @@ typedef uint32 uint64;
 /* ------------------------------ CPU Access ------------------------------ */
 
 /* Access the CPU registers */
+#if M68K_68000_ONLY
+#define CPU_TYPE         CPU_TYPE_000
+#else
 #define CPU_TYPE         m68ki_cpu.cpu_type
+#endif /* M68K_68000_ONLY */
 
 #define REG_DA           m68ki_cpu.dar /* easy access to data and address regs */
 #define REG_DA_SAVE           m68ki_cpu.dar_save
@@ -355,21 +359,48 @@ typedef uint32 uint64;
 #define FLAG_S           m68ki_cpu.s_flag
 #define FLAG_M           m68ki_cpu.m_flag
 #define FLAG_X           m68ki_cpu.x_flag
+#if M68K_LAZY_FLAGS
+/* N, Z, V and C may still be pending, see m68ki_flags_sync() */
+#define FLAG_N           (*m68ki_flags_sync(&m68ki_cpu.n_flag))
+#define FLAG_Z           (*m68ki_flags_sync(&m68ki_cpu.not_z_flag))
+#define FLAG_V           (*m68ki_flags_sync(&m68ki_cpu.v_flag))
+#define FLAG_C           (*m68ki_flags_sync(&m68ki_cpu.c_flag))
+#else
 #define FLAG_N           m68ki_cpu.n_flag
 #define FLAG_Z           m68ki_cpu.not_z_flag
 #define FLAG_V           m68ki_cpu.v_flag
 #define FLAG_C           m68ki_cpu.c_flag
+#endif /* M68K_LAZY_FLAGS */
 #define FLAG_INT_MASK    m68ki_cpu.int_mask
 
 #define CPU_INT_LEVEL    m68ki_cpu.int_level /* ASG: changed from CPU_INTS_PENDING */
 #define CPU_STOPPED      m68ki_cpu.stopped
 #define CPU_PREF_ADDR    m68ki_cpu.pref_addr
 #define CPU_PREF_DATA    m68ki_cpu.pref_data
-#define CPU_ADDRESS_MASK m68ki_cpu.address_mask
-#define CPU_SR_MASK      m68ki_cpu.sr_mask
 #define CPU_INSTR_MODE   m68ki_cpu.instr_mode
 #define CPU_RUN_MODE     m68ki_cpu.run_mode
 
+#if M68K_68000_ONLY
+/* The values m68k_set_cpu_type() would set for the 68000 */
+#define CPU_ADDRESS_MASK 0x00ffffff
+#define CPU_SR_MASK      0xa71f
+#if !M68K_COMPACT_DISPATCH
+#define CYC_INSTRUCTION  m68ki_cycles[0]
+#endif
+#define CYC_EXCEPTION    m68ki_exception_cycle_table[0]
+#define CYC_BCC_NOTAKE_B (-2)
+#define CYC_BCC_NOTAKE_W 2
+#define CYC_DBCC_F_NOEXP (-2)
+#define CYC_DBCC_F_EXP   2
+#define CYC_SCC_R_TRUE   2
+#define CYC_MOVEM_W      2
+#define CYC_MOVEM_L      3
+#define CYC_SHIFT        1
+#define CYC_RESET        132
+#define HAS_PMMU	 0
+#else
+#define CPU_ADDRESS_MASK m68ki_cpu.address_mask
+#define CPU_SR_MASK      m68ki_cpu.sr_mask
 #define CYC_INSTRUCTION  m68ki_cpu.cyc_instruction
 #define CYC_EXCEPTION    m68ki_cpu.cyc_exception
 #define CYC_BCC_NOTAKE_B m68ki_cpu.cyc_bcc_notake_b
@@ -382,6 +413,25 @@ typedef uint32 uint64;
 #define CYC_SHIFT        m68ki_cpu.cyc_shift
 #define CYC_RESET        m68ki_cpu.cyc_reset
 #define HAS_PMMU	 m68ki_cpu.has_pmmu
+#endif /* M68K_68000_ONLY */
+
+#if M68K_COMPACT_DISPATCH
+/* One of the distinct handler and cycle pairs generated by m68kmake */
+typedef struct
+{
+	void (*handler)(void);
+	int cycles;
+} m68ki_opcode_entry;
+
+extern const m68ki_opcode_entry m68ki_opcode_entries[];
+extern const uint16 m68ki_opcode_index[0x10000];
+
+#define m68ki_opcode_handler(IR) m68ki_opcode_entries[m68ki_opcode_index[IR]].handler
+#define m68ki_opcode_cycles(IR)  m68ki_opcode_entries[m68ki_opcode_index[IR]].cycles
+#else
+#define m68ki_opcode_handler(IR) m68ki_instruction_jump_table[IR]
+#define m68ki_opcode_cycles(IR)  CYC_INSTRUCTION[IR]
+#endif /* M68K_COMPACT_DISPATCH */
 #define PMMU_ENABLED	 m68ki_cpu.pmmu_enabled
 #define RESET_CYCLES	 m68ki_cpu.reset_cycles
 
@@ -551,6 +601,32 @@ typedef uint32 uint64;
 	#define m68ki_instr_hook(pc)
 #endif /* M68K_INSTRUCTION_HOOK */
 
+#if M68K_BLOCK_CACHE
+	#if M68K_BLOCK_CACHE == OPT_SPECIFY_HANDLER
+		#define m68ki_block_page_host(A) M68K_BLOCK_CACHE_CALLBACK(A)
+		#define m68ki_block_fetch(N) M68K_BLOCK_FETCH_CALLBACK(N)
+	#else
+		#define m68ki_block_page_host(A) NULL
+		#define m68ki_block_fetch(N)
+	#endif
+#endif /* M68K_BLOCK_CACHE */
+
+#if M68K_BLOCK_CACHE && M68K_BLOCK_IDIOM
+	#if M68K_BLOCK_IDIOM == OPT_SPECIFY_HANDLER
+		#define m68ki_block_copy(D, S, SIZE, N, LAST) M68K_BLOCK_COPY_CALLBACK(D, S, SIZE, N, LAST)
+		#define m68ki_block_fill(D, V, SIZE, N) M68K_BLOCK_FILL_CALLBACK(D, V, SIZE, N)
+	#else
+		#define m68ki_block_copy(D, S, SIZE, N, LAST) 0
+		#define m68ki_block_fill(D, V, SIZE, N) 0
+	#endif
+#endif /* M68K_BLOCK_CACHE && M68K_BLOCK_IDIOM */
+
+#if M68K_LOCKSTEP
+	#define m68ki_lockstep_begin() M68K_LOCKSTEP_BEGIN_CALLBACK()
+	#define m68ki_lockstep_reference() M68K_LOCKSTEP_REFERENCE_CALLBACK()
+	#define m68ki_lockstep_end(F, R, FC, RC) M68K_LOCKSTEP_END_CALLBACK(F, R, FC, RC)
+#endif /* M68K_LOCKSTEP */
+
 #if M68K_MONITOR_PC
 	#if M68K_MONITOR_PC == OPT_SPECIFY_HANDLER
 		#define m68ki_pc_changed(A) M68K_SET_PC_CALLBACK(ADDRESS_68K(A))
@@ -806,6 +882,52 @@ extern jmp_buf m68ki_aerr_trap;
 #define MFLAG_SET   2
 #define MFLAG_CLEAR 0
 
+/* N, Z, V and C of the add, sub, cmp and logic operations.  With
+ * M68K_LAZY_FLAGS only X is set here and the rest is recorded for
+ * m68ki_flags_resolve().
+ */
+#if M68K_LAZY_FLAGS
+enum
+{
+	M68KI_FLAGS_EAGER = 0,
+	M68KI_FLAGS_LOGIC_8,
+	M68KI_FLAGS_LOGIC_16,
+	M68KI_FLAGS_LOGIC_32,
+	M68KI_FLAGS_ADD_8,
+	M68KI_FLAGS_ADD_16,
+	M68KI_FLAGS_ADD_32,
+	M68KI_FLAGS_SUB_8,
+	M68KI_FLAGS_SUB_16,
+	M68KI_FLAGS_SUB_32
+};
+
+#define m68ki_flags_logic_8(R)        m68ki_flags_record_res(M68KI_FLAGS_LOGIC_8, R)
+#define m68ki_flags_logic_16(R)       m68ki_flags_record_res(M68KI_FLAGS_LOGIC_16, R)
+#define m68ki_flags_logic_32(R)       m68ki_flags_record_res(M68KI_FLAGS_LOGIC_32, R)
+#define m68ki_flags_add_8(S, D, R)    do {FLAG_X = CFLAG_8(R); m68ki_flags_record(M68KI_FLAGS_ADD_8, S, D, R);} while(0)
+#define m68ki_flags_add_16(S, D, R)   do {FLAG_X = CFLAG_16(R); m68ki_flags_record(M68KI_FLAGS_ADD_16, S, D, R);} while(0)
+#define m68ki_flags_add_32(S, D, R)   do {FLAG_X = CFLAG_ADD_32(S, D, R); m68ki_flags_record(M68KI_FLAGS_ADD_32, S, D, R);} while(0)
+#define m68ki_flags_sub_8(S, D, R)    do {FLAG_X = CFLAG_8(R); m68ki_flags_record(M68KI_FLAGS_SUB_8, S, D, R);} while(0)
+#define m68ki_flags_sub_16(S, D, R)   do {FLAG_X = CFLAG_16(R); m68ki_flags_record(M68KI_FLAGS_SUB_16, S, D, R);} while(0)
+#define m68ki_flags_sub_32(S, D, R)   do {FLAG_X = CFLAG_SUB_32(S, D, R); m68ki_flags_record(M68KI_FLAGS_SUB_32, S, D, R);} while(0)
+#define m68ki_flags_cmp_8(S, D, R)    m68ki_flags_record(M68KI_FLAGS_SUB_8, S, D, R)
+#define m68ki_flags_cmp_16(S, D, R)   m68ki_flags_record(M68KI_FLAGS_SUB_16, S, D, R)
+#define m68ki_flags_cmp_32(S, D, R)   m68ki_flags_record(M68KI_FLAGS_SUB_32, S, D, R)
+#else
+#define m68ki_flags_logic_8(R)        do {FLAG_N = NFLAG_8(R); FLAG_Z = R; FLAG_V = VFLAG_CLEAR; FLAG_C = CFLAG_CLEAR;} while(0)
+#define m68ki_flags_logic_16(R)       do {FLAG_N = NFLAG_16(R); FLAG_Z = R; FLAG_V = VFLAG_CLEAR; FLAG_C = CFLAG_CLEAR;} while(0)
+#define m68ki_flags_logic_32(R)       do {FLAG_N = NFLAG_32(R); FLAG_Z = R; FLAG_V = VFLAG_CLEAR; FLAG_C = CFLAG_CLEAR;} while(0)
+#define m68ki_flags_add_8(S, D, R)    do {FLAG_N = NFLAG_8(R); FLAG_V = VFLAG_ADD_8(S, D, R); FLAG_X = FLAG_C = CFLAG_8(R); FLAG_Z = MASK_OUT_ABOVE_8(R);} while(0)
+#define m68ki_flags_add_16(S, D, R)   do {FLAG_N = NFLAG_16(R); FLAG_V = VFLAG_ADD_16(S, D, R); FLAG_X = FLAG_C = CFLAG_16(R); FLAG_Z = MASK_OUT_ABOVE_16(R);} while(0)
+#define m68ki_flags_add_32(S, D, R)   do {FLAG_N = NFLAG_32(R); FLAG_V = VFLAG_ADD_32(S, D, R); FLAG_X = FLAG_C = CFLAG_ADD_32(S, D, R); FLAG_Z = MASK_OUT_ABOVE_32(R);} while(0)
+#define m68ki_flags_sub_8(S, D, R)    do {FLAG_N = NFLAG_8(R); FLAG_V = VFLAG_SUB_8(S, D, R); FLAG_X = FLAG_C = CFLAG_8(R); FLAG_Z = MASK_OUT_ABOVE_8(R);} while(0)
+#define m68ki_flags_sub_16(S, D, R)   do {FLAG_N = NFLAG_16(R); FLAG_V = VFLAG_SUB_16(S, D, R); FLAG_X = FLAG_C = CFLAG_16(R); FLAG_Z = MASK_OUT_ABOVE_16(R);} while(0)
+#define m68ki_flags_sub_32(S, D, R)   do {FLAG_N = NFLAG_32(R); FLAG_V = VFLAG_SUB_32(S, D, R); FLAG_X = FLAG_C = CFLAG_SUB_32(S, D, R); FLAG_Z = MASK_OUT_ABOVE_32(R);} while(0)
+#define m68ki_flags_cmp_8(S, D, R)    do {FLAG_N = NFLAG_8(R); FLAG_V = VFLAG_SUB_8(S, D, R); FLAG_C = CFLAG_8(R); FLAG_Z = MASK_OUT_ABOVE_8(R);} while(0)
+#define m68ki_flags_cmp_16(S, D, R)   do {FLAG_N = NFLAG_16(R); FLAG_V = VFLAG_SUB_16(S, D, R); FLAG_C = CFLAG_16(R); FLAG_Z = MASK_OUT_ABOVE_16(R);} while(0)
+#define m68ki_flags_cmp_32(S, D, R)   do {FLAG_N = NFLAG_32(R); FLAG_V = VFLAG_SUB_32(S, D, R); FLAG_C = CFLAG_SUB_32(S, D, R); FLAG_Z = MASK_OUT_ABOVE_32(R);} while(0)
+#endif /* M68K_LAZY_FLAGS */
+
 /* Turn flag values into 1 or 0 */
 #define XFLAG_AS_1() ((FLAG_X>>8)&1)
 #define NFLAG_AS_1() ((FLAG_N>>7)&1)
@@ -819,9 +941,17 @@ extern jmp_buf m68ki_aerr_trap;
 #define COND_CC() (!COND_CS())
 #define COND_VS() (FLAG_V&0x80)
 #define COND_VC() (!COND_VS())
+#if M68K_LAZY_FLAGS
+#define COND_NE() m68ki_flags_ne()
+#else
 #define COND_NE() FLAG_Z
+#endif /* M68K_LAZY_FLAGS */
 #define COND_EQ() (!COND_NE())
+#if M68K_LAZY_FLAGS
+#define COND_MI() m68ki_flags_mi()
+#else
 #define COND_MI() (FLAG_N&0x80)
+#endif /* M68K_LAZY_FLAGS */
 #define COND_PL() (!COND_MI())
 #define COND_LT() ((FLAG_N^FLAG_V)&0x80)
 #define COND_GE() (!COND_LT())
@@ -874,7 +1004,7 @@ extern jmp_buf m68ki_aerr_trap;
 #define USE_CYCLES(A)    m68ki_remaining_cycles -= (A)
 #define SET_CYCLES(A)    m68ki_remaining_cycles = A
 #define GET_CYCLES()     m68ki_remaining_cycles
-#define USE_ALL_CYCLES() m68ki_remaining_cycles %= CYC_INSTRUCTION[REG_IR]
+#define USE_ALL_CYCLES() m68ki_remaining_cycles %= m68ki_opcode_cycles(REG_IR)
 
 
 
@@ -951,6 +1081,12 @@ typedef struct
 	uint not_z_flag;   /* Zero, inverted for speedups */
 	uint v_flag;       /* Overflow */
 	uint c_flag;       /* Carry */
+#if M68K_LAZY_FLAGS
+	uint flag_op;      /* Operation N, Z, V and C are pending for, M68KI_FLAGS_EAGER if none */
+	uint flag_src;     /* Its operands and result */
+	uint flag_dst;
+	uint flag_res;
+#endif /* M68K_LAZY_FLAGS */
 	uint int_mask;     /* I0-I2 */
 	uint int_level;    /* State of interrupt pins IPL0-IPL2 -- ASG: changed from ints_pending */
 	uint stopped;      /* Stopped state */
@@ -1005,12 +1141,55 @@ typedef struct
 
 
 extern m68ki_cpu_core m68ki_cpu;
+#if M68K_LAZY_FLAGS
+extern const uint     m68ki_flags_z_mask[];
+extern const uint     m68ki_flags_n_mask[];
+void m68ki_flags_resolve(m68ki_cpu_core* cpu);
+
+/* Work out pending N, Z, V and C before one of them is read or changed */
+static inline uint* m68ki_flags_sync(uint* flag)
+{
+	if(m68ki_cpu.flag_op != M68KI_FLAGS_EAGER)
+		m68ki_flags_resolve(&m68ki_cpu);
+	return flag;
+}
+
+/* Z and N straight from the pending result, the conditions read them most */
+static inline uint m68ki_flags_ne(void)
+{
+	if(m68ki_cpu.flag_op != M68KI_FLAGS_EAGER)
+		return m68ki_cpu.flag_res & m68ki_flags_z_mask[m68ki_cpu.flag_op];
+	return m68ki_cpu.not_z_flag;
+}
+
+static inline uint m68ki_flags_mi(void)
+{
+	if(m68ki_cpu.flag_op != M68KI_FLAGS_EAGER)
+		return m68ki_cpu.flag_res & m68ki_flags_n_mask[m68ki_cpu.flag_op];
+	return m68ki_cpu.n_flag & NFLAG_SET;
+}
+
+static inline void m68ki_flags_record_res(uint op, uint res)
+{
+	m68ki_cpu.flag_op = op;
+	m68ki_cpu.flag_res = res;
+}
+
+static inline void m68ki_flags_record(uint op, uint src, uint dst, uint res)
+{
+	m68ki_cpu.flag_op = op;
+	m68ki_cpu.flag_src = src;
+	m68ki_cpu.flag_dst = dst;
+	m68ki_cpu.flag_res = res;
+}
+#endif /* M68K_LAZY_FLAGS */
 extern sint           m68ki_remaining_cycles;
 extern uint           m68ki_tracing;
 extern const uint8    m68ki_shift_8_table[];
 extern const uint16   m68ki_shift_16_table[];
 extern const uint     m68ki_shift_32_table[];
 extern const uint8    m68ki_exception_cycle_table[][256];
+extern unsigned char  m68ki_cycles[][0x10000];
 extern uint           m68ki_address_space;
 extern const uint8    m68ki_ea_idx_cycle_table[];
 
@@ -1018,6 +1197,12 @@ extern uint           m68ki_aerr_address;
 extern uint           m68ki_aerr_write_mode;
 extern uint           m68ki_aerr_fc;
 
+#if M68K_BLOCK_CACHE
+extern uint           m68ki_block_base;
+extern const uint8*   m68ki_block_host;
+extern uint           m68ki_block_words;
+#endif /* M68K_BLOCK_CACHE */
+
 /* Forward declarations to keep some of the macros happy */
 static inline uint m68ki_read_16_fc (uint address, uint fc);
 static inline uint m68ki_read_32_fc (uint address, uint fc);
@@ -1067,6 +1252,16 @@ static inline uint m68ki_read_imm_16(void)
 	return result;
 }
 #else
+#if M68K_BLOCK_CACHE
+	/* Operands of a replayed instruction come straight from the cached page */
+	if((REG_PC & ~((1 << M68K_BLOCK_PAGE_BITS) - 1)) == m68ki_block_base)
+	{
+		const uint8* p = m68ki_block_host + (REG_PC & ((1 << M68K_BLOCK_PAGE_BITS) - 1));
+		REG_PC += 2;
+		m68ki_block_words++;
+		return (p[0] << 8) | p[1];
+	}
+#endif /* M68K_BLOCK_CACHE */
 	REG_PC += 2;
 	return m68k_read_immediate_16(ADDRESS_68K(REG_PC-2));
 #endif /* M68K_EMULATE_PREFETCH */
@@ -1112,11 +1307,42 @@ static inline uint m68ki_read_imm_32(void)
 #else
 	m68ki_set_fc(FLAG_S | FUNCTION_CODE_USER_PROGRAM); /* auto-disable (see m68kcpu.h) */
 	m68ki_check_address_error(REG_PC, MODE_READ, FLAG_S | FUNCTION_CODE_USER_PROGRAM); /* auto-disable (see m68kcpu.h) */
+#if M68K_BLOCK_CACHE
+	if((REG_PC & ~((1 << M68K_BLOCK_PAGE_BITS) - 1)) == m68ki_block_base &&
+	   (REG_PC & ((1 << M68K_BLOCK_PAGE_BITS) - 1)) <= (1 << M68K_BLOCK_PAGE_BITS) - 4)
+	{
+		const uint8* p = m68ki_block_host + (REG_PC & ((1 << M68K_BLOCK_PAGE_BITS) - 1));
+		REG_PC += 4;
+		m68ki_block_words += 2;
+		return (p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+	}
+#endif /* M68K_BLOCK_CACHE */
 	REG_PC += 4;
 	return m68k_read_immediate_32(ADDRESS_68K(REG_PC-4));
 #endif /* M68K_EMULATE_PREFETCH */
 }
 
+/* The second instruction of a fused handler only runs where the replay loop
+ * would have started it: with cycles left after the first one and while the
+ * page is still replayed from host memory.  Its opcode comes from the page.
+ */
+#if M68K_BLOCK_CACHE && M68K_FUSION
+#define m68ki_fusion_continue() \
+	(GET_CYCLES() > m68ki_opcode_cycles(REG_IR) && \
+	 (REG_PC & ~((1 << M68K_BLOCK_PAGE_BITS) - 1)) == m68ki_block_base)
+
+static inline uint m68ki_fusion_fetch(void)
+{
+	const uint8* p = m68ki_block_host + (REG_PC & ((1 << M68K_BLOCK_PAGE_BITS) - 1));
+	REG_PC += 2;
+	m68ki_block_words++;
+	return (p[0] << 8) | p[1];
+}
+#else
+#define m68ki_fusion_continue() 0
+#define m68ki_fusion_fetch() m68ki_read_imm_16()
+#endif /* M68K_BLOCK_CACHE && M68K_FUSION */
+
 /* ------------------------- Top level read/write ------------------------- */
 
 /* Handles all memory accesses (except for immediate reads if they are
@@ -1847,7 +2073,7 @@ static inline void m68ki_exception_trap(uint vector)
 	m68ki_jump_vector(vector);
 
 	/* Use up some clock cycles and undo the instruction's cycles */
-	USE_CYCLES(CYC_EXCEPTION[vector] - CYC_INSTRUCTION[REG_IR]);
+	USE_CYCLES(CYC_EXCEPTION[vector] - m68ki_opcode_cycles(REG_IR));
 }
 
 /* Trap#n stacks a 0 frame but behaves like group2 otherwise */
@@ -1858,7 +2084,7 @@ static inline void m68ki_exception_trapN(uint vector)
 	m68ki_jump_vector(vector);
 
 	/* Use up some clock cycles and undo the instruction's cycles */
-	USE_CYCLES(CYC_EXCEPTION[vector] - CYC_INSTRUCTION[REG_IR]);
+	USE_CYCLES(CYC_EXCEPTION[vector] - m68ki_opcode_cycles(REG_IR));
 }
 
 /* Exception for trace mode */
@@ -1904,13 +2130,24 @@ static inline void m68ki_exception_privilege_violation(void)
 	m68ki_jump_vector(EXCEPTION_PRIVILEGE_VIOLATION);
 
 	/* Use up some clock cycles and undo the instruction's cycles */
-	USE_CYCLES(CYC_EXCEPTION[EXCEPTION_PRIVILEGE_VIOLATION] - CYC_INSTRUCTION[REG_IR]);
+	USE_CYCLES(CYC_EXCEPTION[EXCEPTION_PRIVILEGE_VIOLATION] - m68ki_opcode_cycles(REG_IR));
 }
 
+#if M68K_EMULATE_BUS_ERROR
 extern jmp_buf m68ki_bus_error_jmp_buf;
 
 #define m68ki_check_bus_error_trap() setjmp(m68ki_bus_error_jmp_buf)
 
+/* Save the registers for restarting the next instruction after a bus error */
+static inline void m68ki_save_bus_error_regs(void)
+{
+	int i;
+
+	for (i = 15; i >= 0; i--){
+		REG_DA_SAVE[i] = REG_DA[i];
+	}
+}
+
 /* Exception for bus error */
 static inline void m68ki_exception_bus_error(void)
 {
@@ -1929,7 +2166,7 @@ static inline void m68ki_exception_bus_error(void)
 	CPU_RUN_MODE = RUN_MODE_BERR_AERR_RESET_WSF;
 
 	/* Use up some clock cycles and undo the instruction's cycles */
-	USE_CYCLES(CYC_EXCEPTION[EXCEPTION_BUS_ERROR] - CYC_INSTRUCTION[REG_IR]);
+	USE_CYCLES(CYC_EXCEPTION[EXCEPTION_BUS_ERROR] - m68ki_opcode_cycles(REG_IR));
 
 	for (i = 15; i >= 0; i--){
 		REG_DA[i] = REG_DA_SAVE[i];
@@ -1946,6 +2183,10 @@ static inline void m68ki_exception_bus_error(void)
 
 	longjmp(m68ki_bus_error_jmp_buf, 1);
 }
+#else
+#define m68ki_check_bus_error_trap()
+#define m68ki_save_bus_error_regs()
+#endif /* M68K_EMULATE_BUS_ERROR */
 
 extern int cpu_log_enabled;
 
@@ -1964,7 +2205,7 @@ static inline void m68ki_exception_1010(void)
 	m68ki_jump_vector(EXCEPTION_1010);
 
 	/* Use up some clock cycles and undo the instruction's cycles */
-	USE_CYCLES(CYC_EXCEPTION[EXCEPTION_1010] - CYC_INSTRUCTION[REG_IR]);
+	USE_CYCLES(CYC_EXCEPTION[EXCEPTION_1010] - m68ki_opcode_cycles(REG_IR));
 }
 
 /* Exception for F-Line instructions */
@@ -1983,7 +2224,7 @@ static inline void m68ki_exception_1111(void)
 	m68ki_jump_vector(EXCEPTION_1111);
 
 	/* Use up some clock cycles and undo the instruction's cycles */
-	USE_CYCLES(CYC_EXCEPTION[EXCEPTION_1111] - CYC_INSTRUCTION[REG_IR]);
+	USE_CYCLES(CYC_EXCEPTION[EXCEPTION_1111] - m68ki_opcode_cycles(REG_IR));
 }
 
 #if M68K_ILLG_HAS_CALLBACK == OPT_SPECIFY_HANDLER
@@ -2014,7 +2255,7 @@ static inline void m68ki_exception_illegal(void)
 	m68ki_jump_vector(EXCEPTION_ILLEGAL_INSTRUCTION);
 
 	/* Use up some clock cycles and undo the instruction's cycles */
-	USE_CYCLES(CYC_EXCEPTION[EXCEPTION_ILLEGAL_INSTRUCTION] - CYC_INSTRUCTION[REG_IR]);
+	USE_CYCLES(CYC_EXCEPTION[EXCEPTION_ILLEGAL_INSTRUCTION] - m68ki_opcode_cycles(REG_IR));
 }
 
 /* Exception for format errror in RTE */
@@ -2025,7 +2266,7 @@ static inline void m68ki_exception_format_error(void)
 	m68ki_jump_vector(EXCEPTION_FORMAT_ERROR);
 
 	/* Use up some clock cycles and undo the instruction's cycles */
-	USE_CYCLES(CYC_EXCEPTION[EXCEPTION_FORMAT_ERROR] - CYC_INSTRUCTION[REG_IR]);
+	USE_CYCLES(CYC_EXCEPTION[EXCEPTION_FORMAT_ERROR] - m68ki_opcode_cycles(REG_IR));
 }
 
 /* Exception for address error */
@@ -0,0 +1,330 @@
+/*
+    m68kjit.c - x86-64 backend for the trace cache
+
+    Included by m68kcpu.c when M68K_JIT is enabled.  A trace that was replayed
+    m68ki_jit_threshold times is compiled to host code which does exactly what
+    the replay loop does: the dispatch, the bookkeeping and all checks are
+    unrolled with the recorded values as constants.  Only a few register moves
+    are emitted inline, all other instructions call their Musashi handler, so
+    memory accesses, rare instructions and exceptions never have to be known
+    here.  The code leaves as soon as the PC differs from the recorded one, the
+    cycles are used up or the page of the trace was written.
+*/
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define M68KI_JIT_SIZE     (4 << 20)  /* Size of the code buffer */
+#define M68KI_JIT_MAX_INSN 256        /* Upper bound of the code of one instruction */
+
+static uint8* m68ki_jit_code;         /* Executable code buffer, NULL until first use */
+static uint   m68ki_jit_used;
+static uint   m68ki_jit_threshold;    /* Replays until a trace is compiled, 0 = off */
+
+typedef struct
+{
+	uint8* p;
+	uint8* exits[M68KI_BLOCK_LENGTH * 3];
+	uint   num_exits;
+} m68ki_jit_emitter;
+
+static void m68ki_jit_byte(m68ki_jit_emitter* e, uint b)
+{
+	*e->p++ = (uint8)b;
+}
+
+static void m68ki_jit_bytes(m68ki_jit_emitter* e, const char* bytes, uint len)
+{
+	memcpy(e->p, bytes, len);
+	e->p += len;
+}
+
+static void m68ki_jit_32(m68ki_jit_emitter* e, uint value)
+{
+	memcpy(e->p, &value, 4);
+	e->p += 4;
+}
+
+/* mov rax, imm64 */
+static void m68ki_jit_rax(m68ki_jit_emitter* e, const void* ptr)
+{
+	uint64_t value = (uint64_t)(uintptr_t)ptr;
+
+	m68ki_jit_bytes(e, "\x48\xb8", 2);
+	memcpy(e->p, &value, 8);
+	e->p += 8;
+}
+
+/* mov rax, func ; call rax */
+static void m68ki_jit_call(m68ki_jit_emitter* e, void (*func)(void))
+{
+	m68ki_jit_rax(e, (const void*)func);
+	m68ki_jit_bytes(e, "\xff\xd0", 2);
+}
+
+/* mov dword [rbx + offset], imm32 with rbx = &m68ki_cpu */
+static void m68ki_jit_store_cpu(m68ki_jit_emitter* e, uint offset, uint value)
+{
+	m68ki_jit_bytes(e, "\xc7\x83", 2);
+	m68ki_jit_32(e, offset);
+	m68ki_jit_32(e, value);
+}
+
+/* j<cc> rel32 to the common exit, patched when the trace is complete */
+static void m68ki_jit_exit_if(m68ki_jit_emitter* e, uint cc)
+{
+	m68ki_jit_byte(e, 0x0f);
+	m68ki_jit_byte(e, cc);
+	e->exits[e->num_exits++] = e->p;
+	m68ki_jit_32(e, 0);
+}
+
+#define M68KI_JIT_JNE 0x85
+#define M68KI_JIT_JLE 0x8e
+
+static void m68ki_jit_flush(void)
+{
+	uint n;
+
+	for(n = 0; n < M68KI_BLOCK_COUNT; n++)
+		m68ki_blocks[n].code = NULL;
+	m68ki_jit_used = 0;
+}
+
+static int m68ki_jit_alloc(void)
+{
+#if defined(_WIN32)
+	m68ki_jit_code = VirtualAlloc(NULL, M68KI_JIT_SIZE, MEM_COMMIT | MEM_RESERVE, PAGE_EXECUTE_READWRITE);
+#else
+	m68ki_jit_code = mmap(NULL, M68KI_JIT_SIZE, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if(m68ki_jit_code == MAP_FAILED)
+		m68ki_jit_code = NULL;
+#endif
+	return m68ki_jit_code != NULL;
+}
+
+/* Charge the fetches of the compiled trace when it is left */
+static void m68ki_jit_charge(void)
+{
+	m68ki_block_fetch(m68ki_block_words);
+}
+
+#define M68KI_JIT_DAR(N)   (offsetof(m68ki_cpu_core, dar) + (N) * 4)
+#define M68KI_JIT_FLAG(F)  offsetof(m68ki_cpu_core, F)
+
+/* mov eax, [rbx + offset] */
+static void m68ki_jit_load_eax(m68ki_jit_emitter* e, uint offset)
+{
+	m68ki_jit_bytes(e, "\x8b\x83", 2);
+	m68ki_jit_32(e, offset);
+}
+
+/* mov [rbx + offset], eax */
+static void m68ki_jit_store_eax(m68ki_jit_emitter* e, uint offset)
+{
+	m68ki_jit_bytes(e, "\x89\x83", 2);
+	m68ki_jit_32(e, offset);
+}
+
+/* The flags stored next replace any that are still pending */
+static void m68ki_jit_flags_eager(m68ki_jit_emitter* e)
+{
+#if M68K_LAZY_FLAGS
+	m68ki_jit_store_cpu(e, M68KI_JIT_FLAG(flag_op), M68KI_FLAGS_EAGER);
+#else
+	(void)e;
+#endif /* M68K_LAZY_FLAGS */
+}
+
+/* Flags of a 32 bit move of the value in eax, eax is destroyed */
+static void m68ki_jit_move_flags(m68ki_jit_emitter* e)
+{
+	m68ki_jit_flags_eager(e);
+	m68ki_jit_store_eax(e, M68KI_JIT_FLAG(not_z_flag));
+	m68ki_jit_bytes(e, "\xc1\xe8\x18", 3);          /* shr eax, 24 */
+	m68ki_jit_store_eax(e, M68KI_JIT_FLAG(n_flag));
+	m68ki_jit_store_cpu(e, M68KI_JIT_FLAG(v_flag), VFLAG_CLEAR);
+	m68ki_jit_store_cpu(e, M68KI_JIT_FLAG(c_flag), CFLAG_CLEAR);
+}
+
+/* Emit the few register only instructions that are common in loops inline.
+ * They can not fault or change the flow, so they need no register snapshot
+ * and no PC check.  Returns 0 if the instruction has to call its handler.
+ */
+static int m68ki_jit_native(m68ki_jit_emitter* e, uint ir)
+{
+	uint rx = (ir >> 9) & 7;
+	uint ry = ir & 7;
+	uint quick = ((rx - 1) & 7) + 1;
+
+	if((ir & 0xf100) == 0x7000)                     /* moveq #imm, Dx */
+	{
+		uint res = MAKE_INT_8(ir & 0xff);
+
+		m68ki_jit_store_cpu(e, M68KI_JIT_DAR(rx), res);
+		m68ki_jit_flags_eager(e);
+		m68ki_jit_store_cpu(e, M68KI_JIT_FLAG(n_flag), NFLAG_32(res));
+		m68ki_jit_store_cpu(e, M68KI_JIT_FLAG(not_z_flag), res);
+		m68ki_jit_store_cpu(e, M68KI_JIT_FLAG(v_flag), VFLAG_CLEAR);
+		m68ki_jit_store_cpu(e, M68KI_JIT_FLAG(c_flag), CFLAG_CLEAR);
+		return 1;
+	}
+	switch(ir & 0xf1f8)
+	{
+		case 0x2000:                                /* move.l Dy, Dx */
+		case 0x2008:                                /* move.l Ay, Dx */
+			m68ki_jit_load_eax(e, M68KI_JIT_DAR(ir & 0xf));
+			m68ki_jit_store_eax(e, M68KI_JIT_DAR(rx));
+			m68ki_jit_move_flags(e);
+			return 1;
+		case 0x2040:                                /* movea.l Dy, Ax */
+		case 0x2048:                                /* movea.l Ay, Ax */
+			m68ki_jit_load_eax(e, M68KI_JIT_DAR(ir & 0xf));
+			m68ki_jit_store_eax(e, M68KI_JIT_DAR(8 + rx));
+			return 1;
+		case 0x5048:                                /* addq.w #q, Ay */
+		case 0x5088:                                /* addq.l #q, Ay */
+			m68ki_jit_bytes(e, "\x81\x83", 2);      /* add dword [rbx + Ay], q */
+			m68ki_jit_32(e, M68KI_JIT_DAR(8 + ry));
+			m68ki_jit_32(e, quick);
+			return 1;
+		case 0x5148:                                /* subq.w #q, Ay */
+		case 0x5188:                                /* subq.l #q, Ay */
+			m68ki_jit_bytes(e, "\x81\xab", 2);      /* sub dword [rbx + Ay], q */
+			m68ki_jit_32(e, M68KI_JIT_DAR(8 + ry));
+			m68ki_jit_32(e, quick);
+			return 1;
+	}
+	return ir == 0x4e71;                            /* nop */
+}
+
+/* Set PPC, IR and PC like the fetch of the instruction at pc and count it */
+static void m68ki_jit_fetch(m68ki_jit_emitter* e, uint pc, uint ir)
+{
+	m68ki_jit_store_cpu(e, offsetof(m68ki_cpu_core, ppc), pc);
+	m68ki_jit_store_cpu(e, offsetof(m68ki_cpu_core, ir), ir);
+	m68ki_jit_store_cpu(e, offsetof(m68ki_cpu_core, pc), pc + 2);
+	/* add dword [m68ki_block_words], 1 */
+	m68ki_jit_rax(e, &m68ki_block_words);
+	m68ki_jit_bytes(e, "\x83\x00\x01", 3);
+}
+
+/* Compile a valid trace of the given page, the code is stored in the block */
+static void m68ki_jit_compile(m68ki_block* block, uint page)
+{
+	m68ki_jit_emitter e;
+	m68ki_block_insn* insn;
+	uint8* start;
+	uint pc = block->pc;
+	uint n;
+
+	if(m68ki_jit_code == NULL && !m68ki_jit_alloc())
+	{
+		m68ki_jit_threshold = 0;
+		return;
+	}
+	if(m68ki_jit_used + block->count * M68KI_JIT_MAX_INSN + 64 > M68KI_JIT_SIZE)
+		m68ki_jit_flush();
+
+	start = e.p = m68ki_jit_code + m68ki_jit_used;
+	e.num_exits = 0;
+
+	/* push rbx, keep the stack 16 byte aligned (and the shadow space on Win64) */
+	m68ki_jit_byte(&e, 0x53);
+#if defined(_WIN32)
+	m68ki_jit_bytes(&e, "\x48\x83\xec\x20", 4);
+#endif
+	/* mov rbx, &m68ki_cpu */
+	m68ki_jit_bytes(&e, "\x48\xbb", 2);
+	{
+		uint64_t cpu = (uint64_t)(uintptr_t)&m68ki_cpu;
+		memcpy(e.p, &cpu, 8);
+		e.p += 8;
+	}
+	/* m68ki_block_words = 0, the words are charged once when leaving */
+	m68ki_jit_rax(&e, &m68ki_block_words);
+	m68ki_jit_bytes(&e, "\xc7\x00", 2);
+	m68ki_jit_32(&e, 0);
+
+	for(n = 0, insn = block->insn; n < block->count; n++, insn++)
+	{
+		uint8* mark = e.p;
+		int native;
+#if M68K_EMULATE_BUS_ERROR
+		uint i;
+#endif
+
+		m68ki_jit_fetch(&e, pc, insn->ir);
+		native = insn->handler == m68ki_opcode_handler(insn->ir) &&
+			m68ki_jit_native(&e, insn->ir);
+		if(!native)
+		{
+			e.p = mark;
+#if M68K_EMULATE_BUS_ERROR
+			/* Start over with REG_DA_SAVE = REG_DA through movdqu xmm0 */
+			for(i = 0; i < 4; i++)
+			{
+				m68ki_jit_bytes(&e, "\xf3\x0f\x6f\x83", 4);
+				m68ki_jit_32(&e, offsetof(m68ki_cpu_core, dar) + i * 16);
+				m68ki_jit_bytes(&e, "\xf3\x0f\x7f\x83", 4);
+				m68ki_jit_32(&e, offsetof(m68ki_cpu_core, dar_save) + i * 16);
+			}
+#endif
+			m68ki_jit_fetch(&e, pc, insn->ir);
+			m68ki_jit_call(&e, insn->handler);
+		}
+
+		/* sub dword [m68ki_remaining_cycles], cycles */
+		m68ki_jit_rax(&e, &m68ki_remaining_cycles);
+		m68ki_jit_bytes(&e, "\x81\x28", 2);
+		m68ki_jit_32(&e, insn->cycles);
+		if(n == block->count - 1)
+			break;
+		m68ki_jit_exit_if(&e, M68KI_JIT_JLE);
+
+		if(!native)
+		{
+			/* cmp dword [rbx + pc], next_pc */
+			m68ki_jit_bytes(&e, "\x81\xbb", 2);
+			m68ki_jit_32(&e, offsetof(m68ki_cpu_core, pc));
+			m68ki_jit_32(&e, insn->next_pc);
+			m68ki_jit_exit_if(&e, M68KI_JIT_JNE);
+			/* cmp dword [m68ki_page_gen + page], gen */
+			m68ki_jit_rax(&e, &m68ki_page_gen[page]);
+			m68ki_jit_bytes(&e, "\x81\x38", 2);
+			m68ki_jit_32(&e, block->gen);
+			m68ki_jit_exit_if(&e, M68KI_JIT_JNE);
+		}
+
+		pc = insn->next_pc;
+	}
+
+	/* Common exit */
+	for(n = 0; n < e.num_exits; n++)
+	{
+		int rel = (int)(e.p - (e.exits[n] + 4));
+		memcpy(e.exits[n], &rel, 4);
+	}
+	m68ki_jit_call(&e, m68ki_jit_charge);
+#if defined(_WIN32)
+	m68ki_jit_bytes(&e, "\x48\x83\xc4\x20", 4);
+#endif
+	m68ki_jit_byte(&e, 0x5b);
+	m68ki_jit_byte(&e, 0xc3);
+
+	m68ki_jit_used += (uint)(e.p - start);
+	block->code = (void (*)(void))start;
+}
+
+void m68k_set_jit_threshold(unsigned int threshold)
+{
+	m68ki_jit_threshold = threshold;
+	if(threshold == 0 && m68ki_jit_code != NULL)
+		m68ki_jit_flush();
+}
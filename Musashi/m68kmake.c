@@ -40,10 +40,13 @@
  * It requires an input file to function (default m68k_in.c), but you can
  * specify your own like so:
  *
- * m68kmake <output path> <input file>
+ * m68kmake <output path> <input file> [cpu]
  *
  * where output path is the path where the output files should be placed, and
- * input file is the file to use for input.
+ * input file is the file to use for input.  If cpu names one column of the
+ * opcode table (000, 010, 020, 030 or 040), only the handlers of instructions
+ * that CPU has are generated and M68KOPS_CPU_ONLY is defined to its index in
+ * m68kops.h.  All other opcodes run the illegal instruction handler.
  *
  * If you modify the input file greatly from its released form, you may have
  * to tweak the configuration section a bit since I'm using static allocation
@@ -88,6 +91,7 @@ static const char g_version[] = "4.60";
 #define EA_ALLOWED_LENGTH                11	/* Max length of ea allowed str */
 #define MAX_OPCODE_INPUT_TABLE_LENGTH  1000	/* Max length of opcode handler tbl */
 #define MAX_OPCODE_OUTPUT_TABLE_LENGTH 3000	/* Max length of opcode handler tbl */
+#define MAX_FUSION_TABLE_LENGTH          64	/* Max number of fused pairs */
 
 /* Default filenames */
 #define FILENAME_INPUT      "m68k_in.c"
@@ -109,6 +113,10 @@ static const char g_version[] = "4.60";
 #define ID_OPHANDLER_HEADER     ID_BASE "_OPCODE_HANDLER_HEADER"
 #define ID_OPHANDLER_FOOTER     ID_BASE "_OPCODE_HANDLER_FOOTER"
 #define ID_OPHANDLER_BODY       ID_BASE "_OPCODE_HANDLER_BODY"
+#define ID_FUSION_HEADER        ID_BASE "_FUSION_HEADER"
+#define ID_FUSION_FOOTER        ID_BASE "_FUSION_FOOTER"
+#define ID_FUSION_BODY          ID_BASE "_FUSION_BODY"
+#define ID_FUSION_START         ID_BASE "_FUSION_START"
 #define ID_END                  ID_BASE "_END"
 
 #define ID_OPHANDLER_NAME       ID_BASE "_OP"
@@ -217,6 +225,16 @@ typedef struct
 } replace_struct;
 
 
+/* A pair of handlers to fuse and their bodies with all directives replaced */
+typedef struct
+{
+	char first[MAX_LINE_LENGTH+1];
+	char second[MAX_LINE_LENGTH+1];
+	body_struct* first_body;
+	body_struct* second_body;
+} fusion_struct;
+
+
 /* Function Prototypes */
 void error_exit(const char* fmt, ...);
 void perror_exit(const char* fmt, ...);
@@ -231,6 +249,7 @@ opcode_struct* find_opcode(char* name, int size, char* spec_proc, char* spec_ea)
 opcode_struct* find_illegal_opcode(void);
 int extract_opcode_info(char* src, char* name, int* size, char* spec_proc, char* spec_ea);
 void add_replace_string(replace_struct* replace, char* search_str, char* replace_str);
+void replace_directives(char* output, replace_struct* replace);
 void write_body(FILE* filep, body_struct* body, replace_struct* replace);
 void get_base_name(char* base_name, opcode_struct* op);
 void write_function_name(FILE* filep, char* base_name);
@@ -245,6 +264,12 @@ void generate_opcode_cc_variants(FILE* filep, body_struct* body, replace_struct*
 void process_opcode_handlers(FILE* filep);
 void populate_table(void);
 void read_insert(char* insert);
+void populate_fusion_table(void);
+void save_fusion_bodies(char* name, body_struct* body, replace_struct* replace);
+void write_fusion_block(FILE* filep, body_struct* body, char* indent);
+void generate_fusion_handlers(FILE* filep);
+void print_fusion_table(FILE* filep);
+void print_compact_dispatch_table(FILE* filep);
 
 
 
@@ -260,6 +285,7 @@ FILE* g_input_file = NULL;
 FILE* g_prototype_file = NULL;
 FILE* g_table_file = NULL;
 
+int g_cpu_only = -1;      /* Only generate handlers for this CPU, -1 for all */
 int g_num_functions = 0;  /* Number of functions processed */
 int g_num_primitives = 0; /* Number of function primitives read */
 int g_line_number = 1;    /* Current line number */
@@ -270,6 +296,10 @@ opcode_struct g_opcode_input_table[MAX_OPCODE_INPUT_TABLE_LENGTH];
 opcode_struct g_opcode_output_table[MAX_OPCODE_OUTPUT_TABLE_LENGTH];
 int g_opcode_output_table_length = 0;
 
+/* Fused handler table */
+fusion_struct g_fusion_table[MAX_FUSION_TABLE_LENGTH];
+int g_fusion_table_length = 0;
+
 const ea_info_struct g_ea_info_table[13] =
 {/* fname    ea        mask  match */
 	{"",     "",       0x00, 0x00}, /* EA_MODE_NONE */
@@ -731,40 +761,47 @@ void add_replace_string(replace_struct* replace, char* search_str, char* replace
 	strcpy(replace->replace[replace->length++][1], replace_str);
 }
 
-/* Write a function body while replacing any selected strings */
-void write_body(FILE* filep, body_struct* body, replace_struct* replace)
+/* Replace the selected strings in one line of a function body */
+void replace_directives(char* output, replace_struct* replace)
 {
-	int i;
 	int j;
 	char* ptr;
-	char output[MAX_LINE_LENGTH+1];
 	char temp_buff[MAX_LINE_LENGTH+1];
 	int found;
 
-	for(i=0;i<body->length;i++)
+	/* Check for the base directive header */
+	if(strstr(output, ID_BASE) != NULL)
 	{
-		strcpy(output, body->body[i]);
-		/* Check for the base directive header */
-		if(strstr(output, ID_BASE) != NULL)
+		/* Search for any text we need to replace */
+		found = 0;
+		for(j=0;j<replace->length;j++)
 		{
-			/* Search for any text we need to replace */
-			found = 0;
-			for(j=0;j<replace->length;j++)
+			ptr = strstr(output, replace->replace[j][0]);
+			if(ptr)
 			{
-				ptr = strstr(output, replace->replace[j][0]);
-				if(ptr)
-				{
-					/* We found something to replace */
-					found = 1;
-					strcpy(temp_buff, ptr+strlen(replace->replace[j][0]));
-					strcpy(ptr, replace->replace[j][1]);
-					strcat(ptr, temp_buff);
-				}
+				/* We found something to replace */
+				found = 1;
+				strcpy(temp_buff, ptr+strlen(replace->replace[j][0]));
+				strcpy(ptr, replace->replace[j][1]);
+				strcat(ptr, temp_buff);
 			}
-			/* Found a directive with no matching replace string */
-			if(!found)
-				error_exit("Unknown " ID_BASE " directive [%s]", output);
 		}
+		/* Found a directive with no matching replace string */
+		if(!found)
+			error_exit("Unknown " ID_BASE " directive [%s]", output);
+	}
+}
+
+/* Write a function body while replacing any selected strings */
+void write_body(FILE* filep, body_struct* body, replace_struct* replace)
+{
+	int i;
+	char output[MAX_LINE_LENGTH+1];
+
+	for(i=0;i<body->length;i++)
+	{
+		strcpy(output, body->body[i]);
+		replace_directives(output, replace);
 		fprintf(filep, "%s\n", output);
 	}
 	fprintf(filep, "\n\n");
@@ -862,14 +899,15 @@ void set_opcode_struct(opcode_struct* src, opcode_struct* dst, int ea_mode)
 /* Generate a final opcode handler from the provided data */
 void generate_opcode_handler(FILE* filep, body_struct* body, replace_struct* replace, opcode_struct* opinfo, int ea_mode)
 {
+	char name[MAX_LINE_LENGTH+1];
 	char str[MAX_LINE_LENGTH+1];
 	opcode_struct* op = malloc(sizeof(opcode_struct));
 
 	/* Set the opcode structure and write the tables, prototypes, etc */
 	set_opcode_struct(opinfo, op, ea_mode);
-	get_base_name(str, op);
-	add_opcode_output_table_entry(op, str);
-	write_function_name(filep, str);
+	get_base_name(name, op);
+	add_opcode_output_table_entry(op, name);
+	write_function_name(filep, name);
 
 	/* Add any replace strings needed */
 	if(ea_mode != EA_MODE_NONE)
@@ -890,6 +928,7 @@ void generate_opcode_handler(FILE* filep, body_struct* body, replace_struct* rep
 
 	/* Now write the function body with the selected replace strings */
 	write_body(filep, body, replace);
+	save_fusion_bodies(name, body, replace);
 	g_num_functions++;
 	free(op);
 }
@@ -1039,6 +1078,8 @@ void process_opcode_handlers(FILE* filep)
 		opinfo = find_opcode(oper_name, oper_size, oper_spec_proc, oper_spec_ea);
 		if(opinfo == NULL)
 			error_exit("Unable to find matching table entry for %s", func_name);
+		if(g_cpu_only >= 0 && opinfo->cpus[g_cpu_only] == UNSPECIFIED_CH)
+			continue;
 
 		replace->length = 0;
 
@@ -1207,6 +1248,245 @@ void read_insert(char* insert)
 	*ptr++ = 0;
 }
 
+/* Read the list of handler pairs to fuse from the input file */
+void populate_fusion_table(void)
+{
+	char buff[MAX_LINE_LENGTH+1];
+	char* ptr;
+	fusion_struct* fusion;
+
+	buff[0] = 0;
+
+	/* Find the start of the table */
+	while(strcmp(buff, ID_FUSION_START) != 0)
+		if(fgetline(buff, MAX_LINE_LENGTH, g_input_file) < 0)
+			error_exit("(fusion_start) Premature EOF while reading fusion table");
+
+	for(;;)
+	{
+		if(fgetline(buff, MAX_LINE_LENGTH, g_input_file) < 0)
+			error_exit("Premature EOF while reading fusion table");
+		if(strlen(buff) == 0)
+			continue;
+		if(strcmp(buff, ID_INPUT_SEPARATOR) == 0)
+			break;
+		if(g_fusion_table_length >= MAX_FUSION_TABLE_LENGTH)
+			error_exit("Fusion table overflow");
+
+		/* Names of the first and the second handler without the prefix */
+		fusion = g_fusion_table + g_fusion_table_length++;
+		ptr = buff + skip_spaces(buff);
+		strcpy(fusion->first, "m68k_op_");
+		ptr += check_strsncpy(fusion->first+8, ptr, MAX_NAME_LENGTH);
+		ptr += skip_spaces(ptr);
+		strcpy(fusion->second, "m68k_op_");
+		check_strsncpy(fusion->second+8, ptr, MAX_NAME_LENGTH);
+		if(fusion->second[8] == 0)
+			error_exit("Missing second handler of fused pair %s", fusion->first);
+		fusion->first_body = fusion->second_body = NULL;
+	}
+}
+
+/* Keep the final body of a handler that is part of a fused pair */
+void save_fusion_bodies(char* name, body_struct* body, replace_struct* replace)
+{
+	body_struct* copy;
+	int i;
+	int j;
+
+	for(i=0;i<g_fusion_table_length;i++)
+	{
+		if(strcmp(g_fusion_table[i].first, name) != 0 && strcmp(g_fusion_table[i].second, name) != 0)
+			continue;
+
+		copy = malloc(sizeof(body_struct));
+		copy->length = body->length;
+		for(j=0;j<body->length;j++)
+		{
+			strcpy(copy->body[j], body->body[j]);
+			replace_directives(copy->body[j], replace);
+		}
+		if(strcmp(g_fusion_table[i].first, name) == 0)
+			g_fusion_table[i].first_body = copy;
+		else
+			g_fusion_table[i].second_body = copy;
+	}
+}
+
+/* Write the inner lines of a handler body as a block */
+void write_fusion_block(FILE* filep, body_struct* body, char* indent)
+{
+	int i;
+
+	if(strcmp(body->body[0], "{") != 0)
+		error_exit("Handler body does not start with {");
+
+	fprintf(filep, "%s{\n", indent);
+	for(i=1;i<body->length-1;i++)
+		fprintf(filep, "%s%s\n", body->body[i][0] ? indent : "", body->body[i]);
+	fprintf(filep, "%s}\n", indent);
+}
+
+/*
+ * Generate a handler for each fused pair.  It runs the first instruction and
+ * then the second one only if the CPU would have started it at this point, so
+ * the first handler must not change the flow of the program.
+ */
+void generate_fusion_handlers(FILE* filep)
+{
+	static const char* const flow[] = {"return", "m68ki_jump", "m68ki_branch", "m68ki_exception", "CPU_STOPPED"};
+	fusion_struct* fusion;
+	char str[MAX_LINE_LENGTH+1];
+	int i;
+	int j;
+	int k;
+
+	for(i=0;i<g_fusion_table_length;i++)
+	{
+		fusion = g_fusion_table + i;
+		if(fusion->first_body == NULL)
+			error_exit("Unable to find handler %s of a fused pair", fusion->first);
+		if(fusion->second_body == NULL)
+			error_exit("Unable to find handler %s of a fused pair", fusion->second);
+		for(j=0;j<fusion->first_body->length;j++)
+			for(k=0;k<(int)(sizeof(flow)/sizeof(flow[0]));k++)
+				if(strstr(fusion->first_body->body[j], flow[k]) != NULL)
+					error_exit("%s changes the program flow and can not start a fused pair", fusion->first);
+
+		sprintf(str, "m68k_fused_%s_%s", fusion->first+8, fusion->second+8);
+		write_function_name(filep, str);
+		fprintf(filep, "{\n");
+		write_fusion_block(filep, fusion->first_body, "\t");
+		fprintf(filep, "\tif(m68ki_fusion_continue())\n");
+		fprintf(filep, "\t{\n");
+		fprintf(filep, "\t\tREG_PPC = REG_PC;\n");
+		fprintf(filep, "\t\tREG_IR = m68ki_fusion_fetch();\n");
+		fprintf(filep, "\t\tUSE_CYCLES(m68ki_opcode_cycles(REG_IR));\n");
+		write_fusion_block(filep, fusion->second_body, "\t\t");
+		fprintf(filep, "\t}\n");
+		fprintf(filep, "}\n\n\n");
+		g_num_functions++;
+	}
+}
+
+/* Write an entry in the fused handler table for each pair */
+void print_fusion_table(FILE* filep)
+{
+	int i;
+
+	for(i=0;i<g_fusion_table_length;i++)
+		fprintf(filep, "\t{%-28s, %-28s, m68k_fused_%s_%s},\n",
+			g_fusion_table[i].first, g_fusion_table[i].second,
+			g_fusion_table[i].first+8, g_fusion_table[i].second+8);
+}
+
+
+/* Set the handler and cycles of an opcode like m68ki_build_opcode_table() */
+static void set_compact_entry(int* handler, unsigned char* cycles, int instr, int op)
+{
+	handler[instr] = op;
+	cycles[instr] = g_opcode_output_table[op].cycles[g_cpu_only];
+}
+
+/*
+ * Write the opcode table of the selected CPU as a 16-bit index per opcode into
+ * the distinct handler and cycle pairs.  The opcode output table must have
+ * been sorted by print_opcode_output_table() and is walked in the same way as
+ * m68ki_build_opcode_table() walks it at run time.
+ */
+void print_compact_dispatch_table(FILE* filep)
+{
+	int* handler = malloc(0x10000 * sizeof(int));
+	unsigned char* cycles = malloc(0x10000);
+	int* same = malloc(g_opcode_output_table_length * sizeof(int));
+	int* entry = malloc((g_opcode_output_table_length + 1) * 256 * sizeof(int));
+	unsigned short* index = malloc(0x10000 * sizeof(unsigned short));
+	int num_entries = 0;
+	int op = 0;
+	int instr;
+	int i;
+	int j;
+
+	for(i = 0; i < 0x10000; i++)
+	{
+		handler[i] = -1;  /* m68k_op_illegal */
+		cycles[i] = 0;
+	}
+
+	while(op < g_opcode_output_table_length && g_opcode_output_table[op].op_mask != 0xff00)
+	{
+		for(i = 0; i < 0x10000; i++)
+			if((i & g_opcode_output_table[op].op_mask) == g_opcode_output_table[op].op_match)
+				set_compact_entry(handler, cycles, i, op);
+		op++;
+	}
+	for(; op < g_opcode_output_table_length && g_opcode_output_table[op].op_mask == 0xff00; op++)
+		for(i = 0; i <= 0xff; i++)
+			set_compact_entry(handler, cycles, g_opcode_output_table[op].op_match | i, op);
+	for(; op < g_opcode_output_table_length && g_opcode_output_table[op].op_mask == 0xf1f8; op++)
+		for(i = 0; i < 8; i++)
+			for(j = 0; j < 8; j++)
+			{
+				instr = g_opcode_output_table[op].op_match | (i << 9) | j;
+				set_compact_entry(handler, cycles, instr, op);
+				/* The 68000 and 68010 take 2 cycles per bit of a shift distance */
+				if((instr & 0xf000) == 0xe000 && (!(instr & 0x20)) && g_cpu_only <= CPU_TYPE_010)
+					cycles[instr] += (((i-1)&7)+1)<<1;
+			}
+	for(; op < g_opcode_output_table_length && g_opcode_output_table[op].op_mask == 0xfff0; op++)
+		for(i = 0; i <= 0x0f; i++)
+			set_compact_entry(handler, cycles, g_opcode_output_table[op].op_match | i, op);
+	for(; op < g_opcode_output_table_length && g_opcode_output_table[op].op_mask == 0xf1ff; op++)
+		for(i = 0; i <= 0x07; i++)
+			set_compact_entry(handler, cycles, g_opcode_output_table[op].op_match | (i << 9), op);
+	for(; op < g_opcode_output_table_length && g_opcode_output_table[op].op_mask == 0xfff8; op++)
+		for(i = 0; i <= 0x07; i++)
+			set_compact_entry(handler, cycles, g_opcode_output_table[op].op_match | i, op);
+	for(; op < g_opcode_output_table_length && g_opcode_output_table[op].op_mask == 0xffff; op++)
+		set_compact_entry(handler, cycles, g_opcode_output_table[op].op_match, op);
+
+	/* Output entries sharing a handler share their pairs */
+	for(i = 0; i < g_opcode_output_table_length; i++)
+		for(same[i] = 0; same[i] < i; same[i]++)
+			if(strcmp(g_opcode_output_table[same[i]].name, g_opcode_output_table[i].name) == 0)
+				break;
+	for(i = 0; i < (g_opcode_output_table_length + 1) * 256; i++)
+		entry[i] = -1;
+
+	fprintf(filep, "#if M68K_COMPACT_DISPATCH\n\n");
+	fprintf(filep, "/* Distinct handler and cycle pairs of the opcodes */\n");
+	fprintf(filep, "const m68ki_opcode_entry m68ki_opcode_entries[] =\n{\n");
+	for(i = 0; i < 0x10000; i++)
+	{
+		int key = (handler[i] < 0 ? 0 : same[handler[i]] + 1) * 256 + cycles[i];
+
+		if(entry[key] < 0)
+		{
+			if(num_entries > 0xffff)
+				error_exit("Too many distinct opcode handlers");
+			entry[key] = num_entries++;
+			fprintf(filep, "\t{%-28s, %3d},\n", handler[i] < 0 ? "m68k_op_illegal" : g_opcode_output_table[handler[i]].name, cycles[i]);
+		}
+		index[i] = (unsigned short)entry[key];
+	}
+	fprintf(filep, "};\n\n");
+
+	fprintf(filep, "/* Entry of each opcode */\n");
+	fprintf(filep, "const uint16 m68ki_opcode_index[0x10000] =\n{\n");
+	for(i = 0; i < 0x10000; i++)
+		fprintf(filep, "%s%d,%s", i % 16 == 0 ? "\t" : "", index[i], i % 16 == 15 ? "\n" : " ");
+	fprintf(filep, "};\n\n");
+	fprintf(filep, "#endif /* M68K_COMPACT_DISPATCH */\n\n");
+
+	printf("Compact dispatch table has %d distinct entries\n", num_entries);
+
+	free(handler);
+	free(cycles);
+	free(same);
+	free(entry);
+	free(index);
+}
+
 
 
 /* ======================================================================== */
@@ -1227,6 +1507,8 @@ int main(int argc, char **argv)
 	char table_footer_insert[MAX_INSERT_LENGTH+1];
 	char ophandler_header_insert[MAX_INSERT_LENGTH+1];
 	char ophandler_footer_insert[MAX_INSERT_LENGTH+1];
+	char fusion_header_insert[MAX_INSERT_LENGTH+1];
+	char fusion_footer_insert[MAX_INSERT_LENGTH+1];
 	/* Flags if we've processed certain parts already */
 	int prototype_header_read = 0;
 	int prototype_footer_read = 0;
@@ -1234,7 +1516,10 @@ int main(int argc, char **argv)
 	int table_footer_read = 0;
 	int ophandler_header_read = 0;
 	int ophandler_footer_read = 0;
+	int fusion_header_read = 0;
+	int fusion_footer_read = 0;
 	int table_body_read = 0;
+	int fusion_body_read = 0;
 	int ophandler_body_read = 0;
 
 	printf("\n\tMusashi v%s 68000, 68008, 68010, 68EC020, 68020, 68EC030, 68030, 68EC040, 68040 emulator\n", g_version);
@@ -1252,6 +1537,16 @@ int main(int argc, char **argv)
 			strcat(output_path, "/");
 		if(argc > 2)
 			strcpy(g_input_filename, argv[2]);
+		if(argc > 3)
+		{
+			static const char* const cpu_names[NUM_CPUS] = {"000", "010", "020", "030", "040"};
+
+			for(g_cpu_only = 0; g_cpu_only < NUM_CPUS; g_cpu_only++)
+				if(strcmp(argv[3], cpu_names[g_cpu_only]) == 0)
+					break;
+			if(g_cpu_only == NUM_CPUS)
+				error_exit("Unknown CPU %s, expected 000, 010, 020, 030 or 040", argv[3]);
+		}
 	}
 
 
@@ -1285,6 +1580,8 @@ int main(int argc, char **argv)
 				error_exit("Duplicate prototype header");
 			read_insert(temp_insert);
 			fprintf(g_prototype_file, "%s\n\n", temp_insert);
+			if(g_cpu_only >= 0)
+				fprintf(g_prototype_file, "/* Only the handlers of this CPU column were generated */\n#define M68KOPS_CPU_ONLY %d\n\n", g_cpu_only);
 			prototype_header_read = 1;
 		}
 		else if(strcmp(section_id, ID_TABLE_HEADER) == 0)
@@ -1322,6 +1619,30 @@ int main(int argc, char **argv)
 			read_insert(ophandler_footer_insert);
 			ophandler_footer_read = 1;
 		}
+		else if(strcmp(section_id, ID_FUSION_HEADER) == 0)
+		{
+			if(fusion_header_read)
+				error_exit("Duplicate fusion header");
+			read_insert(fusion_header_insert);
+			fusion_header_read = 1;
+		}
+		else if(strcmp(section_id, ID_FUSION_FOOTER) == 0)
+		{
+			if(fusion_footer_read)
+				error_exit("Duplicate fusion footer");
+			read_insert(fusion_footer_insert);
+			fusion_footer_read = 1;
+		}
+		else if(strcmp(section_id, ID_FUSION_BODY) == 0)
+		{
+			if(fusion_body_read)
+				error_exit("Duplicate fusion table");
+			if(ophandler_body_read)
+				error_exit("Fusion table encountered after opcode handlers");
+
+			populate_fusion_table();
+			fusion_body_read = 1;
+		}
 		else if(strcmp(section_id, ID_TABLE_BODY) == 0)
 		{
 			if(!prototype_header_read)
@@ -1347,12 +1668,15 @@ int main(int argc, char **argv)
 				error_exit("Opcode handlers encountered before opcode handler header");
 			if(!table_body_read)
 				error_exit("Opcode handlers encountered before table body");
+			if(!fusion_body_read)
+				error_exit("Opcode handlers encountered before fusion table");
 
 			if(ophandler_body_read)
 				error_exit("Duplicate opcode handler section");
 
 			fprintf(g_table_file, "%s\n\n", ophandler_header_insert);
 			process_opcode_handlers(g_table_file);
+			generate_fusion_handlers(g_table_file);
 			fprintf(g_table_file, "%s\n\n", ophandler_footer_insert);
 
 			ophandler_body_read = 1;
@@ -1376,10 +1700,20 @@ int main(int argc, char **argv)
 				error_exit("Missing opcode handler footer");
 			if(!ophandler_body_read)
 				error_exit("Missing opcode handler body");
+			if(!fusion_header_read)
+				error_exit("Missing fusion header");
+			if(!fusion_footer_read)
+				error_exit("Missing fusion footer");
 
 			fprintf(g_table_file, "%s\n\n", table_header_insert);
 			print_opcode_output_table(g_table_file);
 			fprintf(g_table_file, "%s\n\n", table_footer_insert);
+			if(g_cpu_only >= 0)
+				print_compact_dispatch_table(g_table_file);
+
+			fprintf(g_table_file, "%s\n\n", fusion_header_insert);
+			print_fusion_table(g_table_file);
+			fprintf(g_table_file, "%s\n\n", fusion_footer_insert);
 
 			fprintf(g_prototype_file, "%s\n\n", prototype_footer_insert);
 
@@ -1396,7 +1730,7 @@ int main(int argc, char **argv)
 	fclose(g_table_file);
 	fclose(g_input_file);
 
-	printf("Generated %d opcode handlers from %d primitives\n", g_num_functions, g_num_primitives);
+	printf("Generated %d opcode handlers from %d primitives and %d fused pairs\n", g_num_functions, g_num_primitives, g_fusion_table_length);
 
 	return 0;
 }
@@ -29,12 +29,16 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include "bankboot.h"
+#include "68k-nkcemu.h"
+#include "bus.h"
+#include "mem.h"
 #include "log.h"
 
 bankboot g_bb;
 
 BYTE_68K bank_pC8_in()
 {
+  log_debug("Reading BANKBOOT register");
   return 0;
 }
 
@@ -42,10 +46,18 @@ void bank_pC8_out(BYTE_68K data)
 {
   log_debug("Disable Bankboot");
   g_bb.bb_enabled = FALSE;
+  mem_rebuild();
+}
+
+/* Register the Bankboot port */
+void bank_init()
+{
+  bus_register(BANKBOOT, bank_pC8_in, bank_pC8_out);
 }
 
 void bank_reset()
 {
   log_debug("Reset, Bankboot enabled");
   g_bb.bb_enabled = TRUE;
+  mem_rebuild();
 }
@@ -38,6 +38,7 @@ extern "C"
     BYTE_68K bank_pC8_in();
     void bank_pC8_out(BYTE_68K data);
     void bank_reset();
+    void bank_init();
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,185 @@
+/**************************************************************************************
+ *   Copyright (C) 2023,2024 by Martin Merck                                          *
+ *   martin.merck@gmx.de                                                              *
+ *                                                                                    *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy     *
+ *   of this software and associated documentation files (the "Software"), to deal    *
+ *   in the Software without restriction, including without limitation the rights     *
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell        *
+ *   copies of the Software, and to permit persons to whom the Software is            *
+ *   furnished to do so, subject to the following conditions:                         *
+ *                                                                                    *
+ *   The above copyright notice and this permission notice shall be included in all   *
+ *   copies or substantial portions of the Software.                                  *
+ *                                                                                    *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR       *
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,         * 
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE      *
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER           *
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,    *
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE    *
+ *   SOFTWARE.                                                                        *
+ *                                                                                    *
+ **************************************************************************************/
+
+/**
+ * Bus of the I/O window 0xFFFF01 - 0xFFFFFF.
+ *
+ * Every device registers the handlers for its ports when it is initialized.
+ * The CPU access is then dispatched by a lookup in the port table. The 68008
+ * only has an 8 bit data bus, so word and long accesses are split into byte
+ * accesses on consecutive ports unless a device handles the wider access.
+ */
+#include <stdio.h>
+#include "bus.h"
+#include "idle.h"
+#include "log.h"
+
+#define IO_START 0xffff00
+
+bus g_bus;
+
+void bus_register(unsigned int address, bus_in in, bus_out out)
+{
+    bus_port *port = &g_bus.ports[BUS_PORT(address)];
+    port->in = in;
+    port->out = out;
+}
+
+void bus_register_word(unsigned int address, bus_in_word in, bus_out_word out)
+{
+    bus_port *port = &g_bus.ports[BUS_PORT(address)];
+    port->in_word = in;
+    port->out_word = out;
+}
+
+void bus_register_long(unsigned int address, bus_in_long in, bus_out_long out)
+{
+    bus_port *port = &g_bus.ports[BUS_PORT(address)];
+    port->in_long = in;
+    port->out_long = out;
+}
+
+/* Mark a status port which software polls in a loop, see idle.c */
+void bus_set_pollable(unsigned int address, bool pollable)
+{
+    g_bus.ports[BUS_PORT(address)].pollable = pollable;
+}
+
+/* Handlers for ports which exist but have no function */
+BYTE_68K bus_null_in()
+{
+    return 0;
+}
+
+void bus_null_out(BYTE_68K data)
+{
+}
+
+static unsigned int bus_read_byte(unsigned int address)
+{
+    if (address <= IO_START)
+        return 0xFF;
+
+    bus_port *port = &g_bus.ports[BUS_PORT(address)];
+    port->reads++;
+    if (port->in != NULL)
+    {
+        unsigned int value = port->in();
+        if (port->pollable)
+            idle_poll(address, value);
+        else
+            idle_io_access();
+        return value;
+    }
+
+    log_debug("I/O byte read from UNKNOWN address %#010x", address);
+    return 0xFF;
+}
+
+static unsigned int bus_read_word(unsigned int address)
+{
+    bus_port *port = &g_bus.ports[BUS_PORT(address)];
+    if (address > IO_START && port->in_word != NULL)
+    {
+        port->reads++;
+        idle_io_access();
+        return port->in_word() & 0xffff;
+    }
+    return (bus_read_byte(address) << 8) | bus_read_byte((address + 1) & MEM_ADDRESS_MASK);
+}
+
+static unsigned int bus_read_long(unsigned int address)
+{
+    bus_port *port = &g_bus.ports[BUS_PORT(address)];
+    if (address > IO_START && port->in_long != NULL)
+    {
+        port->reads++;
+        idle_io_access();
+        return port->in_long();
+    }
+    return (bus_read_word(address) << 16) | bus_read_word((address + 2) & MEM_ADDRESS_MASK);
+}
+
+static void bus_write_byte(unsigned int address, unsigned int value)
+{
+    if (address <= IO_START)
+        return;
+
+    bus_port *port = &g_bus.ports[BUS_PORT(address)];
+    port->writes++;
+    idle_io_access();
+    if (port->out != NULL)
+        port->out(value & 0xff);
+    else
+        log_debug("I/O byte write to UNKNOWN address %#010x = %04x", address, value);
+}
+
+static void bus_write_word(unsigned int address, unsigned int value)
+{
+    bus_port *port = &g_bus.ports[BUS_PORT(address)];
+    if (address > IO_START && port->out_word != NULL)
+    {
+        port->writes++;
+        idle_io_access();
+        port->out_word(value & 0xffff);
+        return;
+    }
+    bus_write_byte(address, (value >> 8) & 0xff);
+    bus_write_byte((address + 1) & MEM_ADDRESS_MASK, value & 0xff);
+}
+
+static void bus_write_long(unsigned int address, unsigned int value)
+{
+    bus_port *port = &g_bus.ports[BUS_PORT(address)];
+    if (address > IO_START && port->out_long != NULL)
+    {
+        port->writes++;
+        idle_io_access();
+        port->out_long(value);
+        return;
+    }
+    bus_write_word(address, (value >> 16) & 0xffff);
+    bus_write_word((address + 2) & MEM_ADDRESS_MASK, value & 0xffff);
+}
+
+static const mem_handler handler = {
+    bus_read_byte, bus_read_word, bus_read_long,
+    bus_write_byte, bus_write_word, bus_write_long
+};
+
+/* Handler to map the bus into the last page of the memory map */
+const mem_handler *bus_handler()
+{
+    return &handler;
+}
+
+void bus_log_stats()
+{
+    for (int i = 0; i < BUS_NUM_PORTS; i++)
+    {
+        bus_port *port = &g_bus.ports[i];
+        if (port->reads != 0 || port->writes != 0)
+            log_debug("I/O port %02X: %lu reads, %lu writes", i, port->reads, port->writes);
+    }
+}
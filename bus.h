@@ -0,0 +1,79 @@
+/**************************************************************************************
+ *   Copyright (C) 2023,2024 by Martin Merck                                          *
+ *   martin.merck@gmx.de                                                              *
+ *                                                                                    *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy     *
+ *   of this software and associated documentation files (the "Software"), to deal    *
+ *   in the Software without restriction, including without limitation the rights     *
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell        *
+ *   copies of the Software, and to permit persons to whom the Software is            *
+ *   furnished to do so, subject to the following conditions:                         *
+ *                                                                                    *
+ *   The above copyright notice and this permission notice shall be included in all   *
+ *   copies or substantial portions of the Software.                                  *
+ *                                                                                    *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR       *
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,         * 
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE      *
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER           *
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,    *
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE    *
+ *   SOFTWARE.                                                                        *
+ *                                                                                    *
+ **************************************************************************************/
+
+#ifndef HEADER__BUS
+#define HEADER__BUS
+#include "nkc.h"
+#include "mem.h"
+
+#define BUS_NUM_PORTS 256
+#define BUS_PORT(ADDR) ((ADDR) & 0xff)
+
+typedef BYTE_68K (*bus_in)();
+typedef void (*bus_out)(BYTE_68K data);
+typedef int (*bus_in_word)();
+typedef void (*bus_out_word)(int data);
+typedef LONG_68K (*bus_in_long)();
+typedef void (*bus_out_long)(LONG_68K data);
+
+/*
+ * Handlers of one port in the 0xFFFFxx I/O window. Only byte handlers are
+ * required, word and long accesses are split into byte accesses if a device
+ * does not register a handler for the wider access.
+ */
+typedef struct {
+    bus_in in;
+    bus_out out;
+    bus_in_word in_word;
+    bus_out_word out_word;
+    bus_in_long in_long;
+    bus_out_long out_long;
+    bool pollable;              /* status port, reading it doesn't change the device */
+    unsigned long reads;
+    unsigned long writes;
+} bus_port;
+
+typedef struct {
+    bus_port ports[BUS_NUM_PORTS];
+} bus;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    void bus_register(unsigned int address, bus_in in, bus_out out);
+    void bus_register_word(unsigned int address, bus_in_word in, bus_out_word out);
+    void bus_register_long(unsigned int address, bus_in_long in, bus_out_long out);
+    void bus_set_pollable(unsigned int address, bool pollable);
+    const mem_handler *bus_handler();
+    BYTE_68K bus_null_in();
+    void bus_null_out(BYTE_68K data);
+    void bus_log_stats();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HEADER__BUS */
@@ -32,6 +32,8 @@
 #include <unistd.h>
 #include "log.h"
 #include "cas.h"
+#include "68k-nkcemu.h"
+#include "bus.h"
 
 cas g_cas;
 
@@ -68,6 +70,13 @@ void cas_pCB_out(BYTE_68K data)
     }
 }
 
+/* Register the ports of the CAS interface */
+void cas_init()
+{
+    bus_register(CAS_CMD, cas_pCA_in, cas_pCA_out);
+    bus_register(CAS_DATA, cas_pCB_in, cas_pCB_out);
+}
+
 void cas_reset()
 {
     if(g_cas.cas_file != NULL)
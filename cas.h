@@ -49,6 +49,7 @@ extern "C"
 	BYTE_68K cas_pCB_in();
 	void cas_pCB_out(BYTE_68K data);
 	void cas_reset();
+	void cas_init();
 	void cas_setFile(const char *filename);
 	void cas_findRecordings();
 	void cas_freeRecordings();
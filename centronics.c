@@ -29,6 +29,8 @@
 #include <stdio.h>
 #include <unistd.h>
 #include "centronics.h"
+#include "68k-nkcemu.h"
+#include "bus.h"
 #include "config.h"
 #include "util.h"
 
@@ -68,6 +70,13 @@ void cent_p49_out(BYTE_68K data)
   return;
 }
 
+/* Register the ports of the centronics interface */
+void cent_init()
+{
+  bus_register(CENT_DAT, cent_p48_in, cent_p48_out);
+  bus_register(CENT_STB, cent_p49_in, cent_p49_out);
+}
+
 void cent_reset()
 {
   if(g_cent.list_file != NULL)
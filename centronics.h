@@ -47,6 +47,7 @@ extern "C"
   BYTE_68K cent_p49_in();
   void cent_p49_out(BYTE_68K data);
   void cent_reset();
+  void cent_init();
   void cent_setFile(const char *filename);
 
 #ifdef __cplusplus
@@ -29,8 +29,11 @@
 #include <stdio.h>
 #include <unistd.h>
 #include "col256.h"
+#include "68k-nkcemu.h"
+#include "bus.h"
 #include "config.h"
 #include "log.h"
+#include "mem.h"
 
 col256 g_col;
 extern config g_config;
@@ -127,12 +130,14 @@ BYTE_68K col_pCE_in()
 
 void col_pCE_out(BYTE_68K data)
 {
-    if ((data & 0x80) != 0)
-        g_col.col_active = true;
-    else
-        g_col.col_active = false;
+    bool active = (data & 0x80) != 0;
 
     g_col.col_page = data & 0x03;
+    if (active != g_col.col_active)
+    {
+        g_col.col_active = active;
+        mem_rebuild();          // map or unmap the COL256 memory window
+    }
 }
 
 void col_reset()
@@ -140,6 +145,7 @@ void col_reset()
     g_col.col_page = 0;
     g_col.col_active = false;
     g_col.col_adr = 0;
+    mem_rebuild();
 }
 
 int col_init(void)
@@ -168,13 +174,42 @@ int col_init(void)
     }
     g_col.oldColor = 0;
 
+    g_col.col_canvas = SDL_CreateRGBSurface(SDL_SWSURFACE, 256 * g_col.col_xmag, 256 * g_col.col_ymag, 32, 0, 0, 0, 0);
+    g_col.col_texture = g_col.col_canvas == NULL ? NULL :
+                        SDL_CreateTexture(g_col.col_renderer, g_col.col_canvas->format->format, SDL_TEXTUREACCESS_STREAMING,
+                                          g_col.col_canvas->w, g_col.col_canvas->h);
+    if (!g_col.col_texture || !frame_init(&g_col.col_frame, g_col.col_canvas->w, g_col.col_canvas->h))
+    {
+        SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_ERROR, "Failed to create COL256 canvas: %s", SDL_GetError());
+        exit(1);
+    }
+    SDL_FillRect(g_col.col_canvas, NULL, SDL_MapRGB(g_col.col_canvas->format, 0, 0, 0));
+    g_col.col_changed = true;
+
+    /* 2 bits per color and 2 bits intensity added to all colors */
+    for (int data = 0; data < 256; data++)
+    {
+        int intens = ((data & 0xC0) >> 6);
+        Uint8 R = (data & 0x03) * 64 + (intens * 21);
+        Uint8 G = ((data & 0x0C) >> 2) * 64 + (intens * 21);
+        Uint8 B = ((data & 0x30) >> 4) * 64 + (intens * 21);
+        g_col.col_palette[data] = SDL_MapRGB(g_col.col_canvas->format, R, G, B);
+    }
+
+    /* register the ports of the MC6845, also at the JADOS addresses */
+    bus_register(COL_ADDR, col_pCC_in, col_pCC_out);
+    bus_register(COL_DATA, col_pCD_in, col_pCD_out);
+    bus_register(COL_PAGE, col_pCE_in, col_pCE_out);
+    bus_register(COL_JADOS_ADDR, col_pCC_in, col_pCC_out);
+    bus_register(COL_JADOS_DATA, col_pCD_in, col_pCD_out);
+    bus_register(COL_JADOS_PAGE, col_pCE_in, col_pCE_out);
+
     return SDL_GetWindowID(g_col.col_win);
 }
 
 void col_setPixel(int address, BYTE_68K data)
 {
     int x, y;
-    Uint8 R, G, B;
 
     if (!g_col.col_active)
         return;
@@ -184,21 +219,15 @@ void col_setPixel(int address, BYTE_68K data)
     x = addr % 256;
     y = addr / 256;
 
-    int intens = ((data & 0xC0) >> 6);
-    Uint8 R8 = (data & 0x03);
-    Uint8 G8 = ((data & 0x0C) >> 2);
-    Uint8 B8 = ((data & 0x30) >> 4);
-    R = R8 * 64 + (intens * 21);
-    G = G8 * 64 + (intens * 21);
-    B = B8 * 64 + (intens * 21);
-    SDL_SetRenderDrawColor(g_col.col_renderer, R, G, B, SDL_ALPHA_OPAQUE);
-    for (int i = 0; i < g_col.col_xmag; i++)
+    SDL_Surface *canvas = g_col.col_canvas;
+    Uint32 color = g_col.col_palette[data];
+    for (int j = 0; j < g_col.col_ymag; j++)
     {
-        for (int j = 0; j < g_col.col_ymag; j++)
-        {
-            SDL_RenderDrawPoint(g_col.col_renderer, x * g_col.col_xmag + i, y * g_col.col_ymag + j);
-        }
+        Uint32 *row = (Uint32 *)((Uint8 *)canvas->pixels + (y * g_col.col_ymag + j) * canvas->pitch);
+        for (int i = 0; i < g_col.col_xmag; i++)
+            row[x * g_col.col_xmag + i] = color;
     }
+    g_col.col_changed = true;
 }
 
 void col_setWord(int address, WORD_68K data)
@@ -254,7 +283,25 @@ LONG_68K col_getLong(int address)
     return res;
 }
 
+/* Hand the canvas to the main thread if it changed */
 void col_draw()
 {
-    SDL_RenderPresent(g_col.col_renderer);
+    if (!g_col.col_changed)
+        return;
+    SDL_BlitSurface(g_col.col_canvas, NULL, frame_back(&g_col.col_frame), NULL);
+    frame_publish(&g_col.col_frame, 0);
+    g_col.col_changed = false;
+}
+
+/* Show the latest frame in the window, runs on the main thread */
+void col_show()
+{
+    SDL_Surface *shown = frame_acquire(&g_col.col_frame);
+
+    if (shown != NULL)
+    {
+        SDL_UpdateTexture(g_col.col_texture, NULL, shown->pixels, shown->pitch);
+        SDL_RenderCopy(g_col.col_renderer, g_col.col_texture, NULL, NULL);
+        SDL_RenderPresent(g_col.col_renderer);
+    }
 }
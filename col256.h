@@ -26,6 +26,7 @@
 #define HEADER__COL256
 
 #include "nkc.h"
+#include "frame.h"
 
 #define COL256_HORIZ_TOT 0
 #define COL256_HORIZ_DISP 1
@@ -53,6 +54,11 @@ typedef struct {
     BYTE_68K col_mem[64 * 1024]; /* 64K Video RAM */
     SDL_Window *col_win;
     SDL_Renderer *col_renderer;
+    SDL_Texture *col_texture;
+    SDL_Surface *col_canvas;   /* picture of the video RAM, drawn by the emulation thread */
+    Uint32 col_palette[256];   /* canvas pixel of each video RAM byte */
+    bool col_changed;          /* canvas changed since the last frame */
+    frame col_frame;           /* finished frames for the main thread */
     int col_xmag;              /* Magnification in X */
     int col_ymag;              /* Magnification in Y */
     bool col_active;
@@ -79,6 +85,7 @@ extern "C"
     WORD_68K col_getWord(int address);
     LONG_68K col_getLong(int address);
     void col_draw();
+    void col_show();
 
 #ifdef __cplusplus
 }
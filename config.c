@@ -204,6 +204,8 @@ long getRomAddress(const char *key)
 
 int getKeyType(const char *key)
 {
+    if (strcmp(key, "Turbo") == 0)
+        return TURBO;
     if (strcmp(key, "CPUSpeed") == 0)
         return CPU_SPEED_MHZ;
     if (strcmp(key, "NumWaitStates") == 0)
@@ -256,6 +258,24 @@ int getKeyType(const char *key)
         return DISK_C;
     if (strcmp(key, "DriveD") == 0)
         return DISK_D;
+    if (strcmp(key, "Deterministic") == 0)
+        return DETERMINISTIC;
+    if (strcmp(key, "UhrEpoch") == 0)
+        return UHR_EPOCH;
+    if (strcmp(key, "IdleSkip") == 0)
+        return IDLE_SKIP;
+    if (strcmp(key, "BlockCache") == 0)
+        return BLOCK_CACHE;
+    if (strcmp(key, "Jit") == 0)
+        return JIT;
+    if (strcmp(key, "JitThreshold") == 0)
+        return JIT_THRESHOLD;
+    if (strcmp(key, "Lockstep") == 0)
+        return LOCKSTEP;
+    if (strcmp(key, "GdpThread") == 0)
+        return GDP_THREAD;
+    if (strcmp(key, "GdpTiming") == 0)
+        return GDP_TIMING;
 
     return CONFIG_UNKNOWN;
 }
@@ -277,6 +297,14 @@ void readConfig(const char *config_file)
     g_config.setINT = 0;            // Default to not to connect the vertical blank signal with the INT line
     g_config.setNMI = 1;            // Default to connect the INT and NMI lines together to generate a level 7 interrupt
     g_config.numWaitStates = 3;     // Default to 3 wait states
+    g_config.deterministic = 0;     // Default to take the time of the devices from the host clock
+    g_config.idleSkip = 1;          // Default to skip polling loops up to the next device event
+    g_config.blockCache = 1;        // Default to replay cached instruction traces
+    g_config.jit = 0;               // Default to not compile hot traces to host code
+    g_config.jitThreshold = 16;     // Replays of a trace before it is compiled
+    g_config.lockstep = 0;          // Default to not verify cached traces against the interpreter
+    g_config.gdpThread = 0;         // Default to rasterize the GDP64 commands on the emulation thread
+    g_config.gdpTiming = 1;         // Default to keep the GDP64 busy for the drawing time of each command
 
     /* Initialize parser */
     if (!yaml_parser_initialize(&parser))
@@ -318,6 +346,9 @@ void readConfig(const char *config_file)
             {
                 switch (type)
                 {
+                case TURBO:
+                    g_config.simSpeed = strtol(tk, NULL, 0) != 0 ? 0 : 1;
+                    break;
                 case CPU_SPEED_MHZ:
                     g_config.cpuSpeed = strtol(tk, NULL, 0);
                     break;
@@ -388,6 +419,33 @@ void readConfig(const char *config_file)
                 case DISK_D:
                     g_config.diskD = strdup(tk);
                     break;
+                case DETERMINISTIC:
+                    g_config.deterministic = strtol(tk, NULL, 0);
+                    break;
+                case UHR_EPOCH:
+                    g_config.uhrEpoch = strdup(tk);
+                    break;
+                case IDLE_SKIP:
+                    g_config.idleSkip = strtol(tk, NULL, 0);
+                    break;
+                case BLOCK_CACHE:
+                    g_config.blockCache = strtol(tk, NULL, 0);
+                    break;
+                case JIT:
+                    g_config.jit = strtol(tk, NULL, 0);
+                    break;
+                case JIT_THRESHOLD:
+                    g_config.jitThreshold = strtol(tk, NULL, 0);
+                    break;
+                case LOCKSTEP:
+                    g_config.lockstep = strtol(tk, NULL, 0);
+                    break;
+                case GDP_THREAD:
+                    g_config.gdpThread = strtol(tk, NULL, 0);
+                    break;
+                case GDP_TIMING:
+                    g_config.gdpTiming = strtol(tk, NULL, 0);
+                    break;
                 }
             }
             break;
@@ -437,6 +495,8 @@ void saveConfig(const char *config_file)
         logEmitterError(&emitter, &event);
 
     // Write Config elements
+    sprintf(value,"%u", g_config.simSpeed == 0 ? 1 : 0);
+    emitConfigEntry(&emitter, "Turbo",value);
     sprintf(value,"%u", g_config.cpuSpeed);
     emitConfigEntry(&emitter, "CPUSpeed",value);
     sprintf(value,"%u", g_config.numWaitStates);
@@ -481,6 +541,25 @@ void saveConfig(const char *config_file)
     emitConfigEntry(&emitter, "DriveC", g_config.diskC);
     emitConfigEntry(&emitter, "DriveD", g_config.diskD);
 
+    // Write emulated time settings
+    sprintf(value,"%u", g_config.deterministic);
+    emitConfigEntry(&emitter, "Deterministic",value);
+    emitConfigEntry(&emitter, "UhrEpoch", g_config.uhrEpoch);
+    sprintf(value,"%u", g_config.idleSkip);
+    emitConfigEntry(&emitter, "IdleSkip",value);
+    sprintf(value,"%u", g_config.blockCache);
+    emitConfigEntry(&emitter, "BlockCache",value);
+    sprintf(value,"%u", g_config.jit);
+    emitConfigEntry(&emitter, "Jit",value);
+    sprintf(value,"%u", g_config.jitThreshold);
+    emitConfigEntry(&emitter, "JitThreshold",value);
+    sprintf(value,"%u", g_config.lockstep);
+    emitConfigEntry(&emitter, "Lockstep",value);
+    sprintf(value,"%u", g_config.gdpThread);
+    emitConfigEntry(&emitter, "GdpThread",value);
+    sprintf(value,"%u", g_config.gdpTiming);
+    emitConfigEntry(&emitter, "GdpTiming",value);
+
     // End document
     yaml_sequence_end_event_initialize(&event);
     if (!yaml_emitter_emit(&emitter, &event))
@@ -47,6 +47,16 @@
 #define DISK_B 21
 #define DISK_C 22
 #define DISK_D 23
+#define DETERMINISTIC 24
+#define UHR_EPOCH 25
+#define TURBO 26
+#define IDLE_SKIP 27
+#define BLOCK_CACHE 28
+#define JIT 29
+#define JIT_THRESHOLD 30
+#define LOCKSTEP 31
+#define GDP_THREAD 32
+#define GDP_TIMING 33
 #define CONFIG_UNKNOWN 1000
 #define MAX_ROMS 36
 
@@ -81,6 +91,15 @@ typedef struct {
 	char * diskB;
 	char * diskC;
 	char * diskD;
+	int deterministic;
+	char * uhrEpoch;
+	int idleSkip;
+	int blockCache;
+	int jit;
+	int jitThreshold;
+	int lockstep;
+	int gdpThread;
+	int gdpTiming;
 } config;
 
 #ifdef __cplusplus
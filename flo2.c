@@ -31,6 +31,9 @@
 #include <stdbool.h>
 #include <fcntl.h>
 #include "flo2.h"
+#include "68k-nkcemu.h"
+#include "bus.h"
+#include "sched.h"
 #include "crc.h"
 #include "config.h"
 #include "log.h"
@@ -239,6 +242,20 @@ void writeTrack()
 	g_flo2.head_down = true;
 }
 
+/* Completion of a type I command */
+static void endTypeI()
+{
+	g_flo2.status &= ~STATUS_I_BUSY;
+	g_flo2.intrq = true;
+}
+
+/* Type I commands stay busy for a short time before they raise INTRQ */
+static void startTypeI()
+{
+	g_flo2.status |= STATUS_I_BUSY;
+	sched_add(SCHED_FLO2, sched_cycles(100), endTypeI);
+}
+
 BYTE_68K flo2_pC0_in()
 {
    	log_debug("Reading FLO2 Status register %02X. Clear Interrupts.", g_flo2.status);
@@ -253,6 +270,7 @@ void flo2_pC0_out(BYTE_68K data)
 	g_flo2.status = 0;
 	BYTE_68K cmd = data & (BYTE_68K) 0xF0;
 	g_flo2.intrq = false;
+	sched_cancel(SCHED_FLO2);
 	switch(cmd)
     {
     case CMD_RESTORE:
@@ -268,7 +286,7 @@ void flo2_pC0_out(BYTE_68K data)
 			g_flo2.head_down = false;
 		if( data & 0x04 )
 			runVerify();
-		g_flo2.intrq = true;
+		startTypeI();
     	return;
     case CMD_SEEK:
     	log_debug("Seek                    : TRACK: %02d %02X", g_flo2.akt_track, data & 0x0F);
@@ -284,7 +302,7 @@ void flo2_pC0_out(BYTE_68K data)
 			g_flo2.head_down = false;
 		if( data & 0x04 )
 			runVerify();
-		g_flo2.intrq = true;
+		startTypeI();
     	return;
     case CMD_STEP_NOUPD:
     	log_debug("Step no update          : TRACK: %02d %02X", g_flo2.akt_track, data & 0x0F);
@@ -312,7 +330,7 @@ void flo2_pC0_out(BYTE_68K data)
 			g_flo2.head_down = false;
 		if( data & 0x04 )
 			runVerify();
-		g_flo2.intrq = true;
+		startTypeI();
     	return;
     case CMD_STEP_UPD:
     	log_debug("Step update             : TRACK: %02d %02X", g_flo2.akt_track, data & 0x0F);
@@ -342,7 +360,7 @@ void flo2_pC0_out(BYTE_68K data)
 			g_flo2.head_down = false;
 		if( data & 0x04 )
 			runVerify();
-		g_flo2.intrq = true;
+		startTypeI();
 		return;
     case CMD_STEP_IN_NOUPD:
     	log_debug("Step in no update       : TRACK: %02d %02X", g_flo2.akt_track, data & 0x0F);
@@ -360,7 +378,7 @@ void flo2_pC0_out(BYTE_68K data)
 			g_flo2.head_down = false;
 		if( data & 0x04 )
 			runVerify();
-		g_flo2.intrq = true;
+		startTypeI();
     	return;
     case CMD_STEP_IN_UPD:
     	log_debug("Step in update          : TRACK: %02d %02X", g_flo2.akt_track, data & 0x0F);
@@ -381,7 +399,7 @@ void flo2_pC0_out(BYTE_68K data)
 			g_flo2.head_down = false;
 		if( data & 0x04 )
 			runVerify();
-		g_flo2.intrq = true;
+		startTypeI();
     	return;
     case CMD_STEP_OUT_NOUPD:
     	log_debug("Step out no update      : TRACK: %02d %02X", g_flo2.akt_track, data & 0x0F);
@@ -401,7 +419,7 @@ void flo2_pC0_out(BYTE_68K data)
 			g_flo2.head_down = false;
 		if( data & 0x04 )
 			runVerify();
-		g_flo2.intrq = true;
+		startTypeI();
     	return;
     case CMD_STEP_OUT_UPD:
     	log_debug("Step out update         : TRACK: %02d %02X", g_flo2.akt_track, data & 0x0F);
@@ -422,7 +440,7 @@ void flo2_pC0_out(BYTE_68K data)
 			g_flo2.head_down = false;
 		if( data & 0x04 )
 			runVerify();
-		g_flo2.intrq = true;
+		startTypeI();
     	return;
     case CMD_READ_SECT:
     	log_debug("Reading sector          : TRACK: %02d SECTOR:%02d %02X", g_flo2.akt_track, g_flo2.sector, data & 0x0F);
@@ -460,7 +478,6 @@ void flo2_pC0_out(BYTE_68K data)
 		g_flo2.head_down = true;
 		g_flo2.drq = true;
 //		g_flo2.intrq = true;
-		usleep(100);
     	return;
     case CMD_FORCE_INT:
     	log_debug("Force Interrupt: %02X", data & 0x0F);
@@ -596,6 +613,17 @@ void flo2_pC4_out(BYTE_68K data)
 	g_flo2.drive = data;
 }
 
+/* Register the ports of the FLO2 controller */
+void flo2_init()
+{
+    bus_register(FLO2_CMD, flo2_pC0_in, flo2_pC0_out);
+    bus_register(FLO2_TRACK, flo2_pC1_in, flo2_pC1_out);
+    bus_register(FLO2_SECT, flo2_pC2_in, flo2_pC2_out);
+    bus_register(FLO2_DATA, flo2_pC3_in, flo2_pC3_out);
+    bus_register(FLO2_ADDI, flo2_pC4_in, flo2_pC4_out);
+    bus_set_pollable(FLO2_ADDI, true);
+}
+
 void flo2_reset()
 {
 	g_flo2.status = 0;
@@ -607,6 +635,7 @@ void flo2_reset()
 	g_flo2.intrq = false;
 	g_flo2.drq = false;
 	g_flo2.writeTrack = false;
+	sched_cancel(SCHED_FLO2);
 
 	flo2_close_drives();
 	if( g_config.diskA != NULL)
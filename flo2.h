@@ -114,6 +114,7 @@ extern "C"
     BYTE_68K flo2_pC4_in(); /* Drive type special register */
     void flo2_pC4_out(BYTE_68K data);
     void flo2_reset();
+    void flo2_init();
     void flo2_close_drives();
     void flo2_open_drive(int drive_num, const char *fname);
     void flo2_close_drives();
@@ -0,0 +1,134 @@
+/**************************************************************************************
+ *   Copyright (C) 2023,2024 by Martin Merck                                          *
+ *   martin.merck@gmx.de                                                              *
+ *                                                                                    *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy     *
+ *   of this software and associated documentation files (the "Software"), to deal    *
+ *   in the Software without restriction, including without limitation the rights     *
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell        *
+ *   copies of the Software, and to permit persons to whom the Software is            *
+ *   furnished to do so, subject to the following conditions:                         *
+ *                                                                                    *
+ *   The above copyright notice and this permission notice shall be included in all   *
+ *   copies or substantial portions of the Software.                                  *
+ *                                                                                    *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR       *
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,         * 
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE      *
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER           *
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,    *
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE    *
+ *   SOFTWARE.                                                                        *
+ *                                                                                    *
+ **************************************************************************************/
+
+/**
+ * Hand over of the finished GDP64 and COL256 frames from the emulation
+ * thread to the main thread, which owns the SDL windows and presents them.
+ *
+ * The three buffers are in the format of the pages of the cards, so they
+ * are filled with plain blits.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "frame.h"
+#include "log.h"
+
+bool frame_init(frame *f, int width, int height)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        f->buffers[i] = SDL_CreateRGBSurface(SDL_SWSURFACE, width, height, 32, 0, 0, 0, 0);
+        if (f->buffers[i] == NULL)
+        {
+            log_error("Can't create frame buffer %d. SDL-Error:%s", i, SDL_GetError());
+            return false;
+        }
+    }
+    f->words = (height + 63) / 64;
+    for (int i = 0; i < 3; i++)
+    {
+        f->sequence[i] = 0;
+        f->scroll[i] = 0;
+        f->changed[i] = calloc(f->words, sizeof(Uint64));
+    }
+    for (int i = 0; i < FRAME_HISTORY; i++)
+        f->history[i] = calloc(f->words, sizeof(Uint64));
+    f->stale = calloc(f->words, sizeof(Uint64));
+    f->published = 0;
+    f->shown = 0;
+    f->previous = 0;
+    f->back = 0;
+    f->front = 1;
+    SDL_AtomicSet(&f->ready, 2);
+    return true;
+}
+
+/* Buffer for the next frame, only used by the emulation thread */
+SDL_Surface *frame_back(frame *f)
+{
+    return f->buffers[f->back];
+}
+
+/*
+ * Remember the rows the next publish changes, NULL if it changes all of them,
+ * and return the rows of the back buffer which are older than that publish.
+ * The back buffer missed the publishes since the one it holds, so these are
+ * the rows changed by all of them.
+ */
+const Uint64 *frame_prepare(frame *f, const Uint64 *changed)
+{
+    Uint32 next = f->published + 1;
+    Uint32 held = f->sequence[f->back];
+    Uint64 *rows = f->history[next % FRAME_HISTORY];
+
+    if (changed != NULL)
+        memcpy(rows, changed, f->words * sizeof(Uint64));
+    else
+        memset(rows, 0xFF, f->words * sizeof(Uint64));
+    memcpy(f->changed[f->back], rows, f->words * sizeof(Uint64));
+
+    if (held == 0 || next - held > FRAME_HISTORY)
+    {
+        memset(f->stale, 0xFF, f->words * sizeof(Uint64));
+        return f->stale;
+    }
+    memset(f->stale, 0, f->words * sizeof(Uint64));
+    for (Uint32 s = held + 1; s != next + 1; s++)
+        for (int w = 0; w < f->words; w++)
+            f->stale[w] |= f->history[s % FRAME_HISTORY][w];
+    return f->stale;
+}
+
+/* Hand the back buffer to the main thread, a frame it has not shown yet is dropped */
+void frame_publish(frame *f, int scroll)
+{
+    f->scroll[f->back] = scroll;
+    f->sequence[f->back] = ++f->published;
+    f->back = SDL_AtomicSet(&f->ready, f->back | FRAME_FRESH) & FRAME_INDEX;
+}
+
+/* Latest finished frame if there is a new one since the last call, else NULL */
+SDL_Surface *frame_acquire(frame *f)
+{
+    if ((SDL_AtomicGet(&f->ready) & FRAME_FRESH) == 0)
+        return NULL;
+    f->front = SDL_AtomicSet(&f->ready, f->front) & FRAME_INDEX;
+    f->previous = f->shown;
+    f->shown = f->sequence[f->front];
+    return f->buffers[f->front];
+}
+
+/* Rows of the acquired frame which differ from the one acquired before, NULL if it was skipped */
+const Uint64 *frame_changed(frame *f)
+{
+    if (f->previous == 0 || f->shown != f->previous + 1)
+        return NULL;
+    return f->changed[f->front];
+}
+
+/* Rows the acquired frame is to be shown moved down, the last rows wrap to the top */
+int frame_scroll(frame *f)
+{
+    return f->scroll[f->front];
+}
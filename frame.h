@@ -0,0 +1,75 @@
+/**************************************************************************************
+ *   Copyright (C) 2023,2024 by Martin Merck                                          *
+ *   martin.merck@gmx.de                                                              *
+ *                                                                                    *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy     *
+ *   of this software and associated documentation files (the "Software"), to deal    *
+ *   in the Software without restriction, including without limitation the rights     *
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell        *
+ *   copies of the Software, and to permit persons to whom the Software is            *
+ *   furnished to do so, subject to the following conditions:                         *
+ *                                                                                    *
+ *   The above copyright notice and this permission notice shall be included in all   *
+ *   copies or substantial portions of the Software.                                  *
+ *                                                                                    *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR       *
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,         * 
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE      *
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER           *
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,    *
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE    *
+ *   SOFTWARE.                                                                        *
+ *                                                                                    *
+ **************************************************************************************/
+
+#ifndef HEADER__FRAME
+#define HEADER__FRAME
+#include "nkc.h"
+
+#define FRAME_INDEX 0x03            /* buffer index in frame.ready */
+#define FRAME_FRESH 0x04            /* the ready buffer was not shown yet */
+#define FRAME_HISTORY 4             /* publishes whose changed rows are remembered */
+
+/*
+ * Triple buffer of finished frames. The emulation thread draws into back
+ * and swaps it with ready, the main thread swaps front with ready when a
+ * fresh frame is there. Neither side ever waits for the other.
+ *
+ * Each publish is numbered and carries a mask of the rows it changed, so
+ * both sides can limit their work to these rows as long as no frame was
+ * skipped in between.
+ */
+typedef struct {
+    SDL_Surface *buffers[3];
+    Uint32 sequence[3];             /* number of the publish a buffer holds, 0 if none */
+    Uint64 *changed[3];             /* rows changed by the publish a buffer holds */
+    int scroll[3];                  /* rows a buffer is shown moved down, wrapping around */
+    Uint64 *history[FRAME_HISTORY]; /* rows changed by the last publishes, emulation thread only */
+    Uint64 *stale;                  /* rows of the back buffer to redraw, emulation thread only */
+    int words;                      /* 64 bit words of a row mask */
+    Uint32 published;               /* number of the last publish */
+    Uint32 shown;                   /* number of the acquired publish, main thread only */
+    Uint32 previous;                /* number of the publish acquired before it */
+    int back;                       /* buffer the emulation thread draws into */
+    int front;                      /* buffer the main thread shows */
+    SDL_atomic_t ready;             /* latest finished buffer and FRAME_FRESH */
+} frame;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    bool frame_init(frame *f, int width, int height);
+    SDL_Surface *frame_back(frame *f);
+    const Uint64 *frame_prepare(frame *f, const Uint64 *changed);
+    void frame_publish(frame *f, int scroll);
+    SDL_Surface *frame_acquire(frame *f);
+    const Uint64 *frame_changed(frame *f);
+    int frame_scroll(frame *f);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HEADER__FRAME */
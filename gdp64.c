@@ -34,14 +34,18 @@
  * reside in this file too
  */
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <time.h>
 #include <sys/time.h>
-#include "ef9366charset.h"
 #include "gdp64.h"
+#include "68k-nkcemu.h"
+#include "bus.h"
 #include "log.h"
 #include "util.h"
 #include "config.h"
+#include "sched.h"
 #include "m68k.h"
 
 extern config g_config;
@@ -61,123 +65,14 @@ WORD_68K lineStyle[4] = {0xFFFF,  /* Line styles of EF9366 in hexadecimal repres
 
 /* global variables SDL */
 const SDL_Color bg = {0x00, 0x00, 0x00, 0xFF};
-const Uint32 bg32 = 0x000000FF;
 const SDL_Color fg = {0x10, 0xA4, 0x13, 0xFF};
-const Uint32 fg32 = 0x10A413FF;
 
-/*
-  Begin of all SDL related functions
-*/
-void DrawPixel(SDL_Surface *sc, int x, int y, Uint8 R, Uint8 G, Uint8 B)
+/* Resolve pen colour and XOR mode for the rasterizer, called whenever CTRL1 or the page register changes */
+static void selectPen()
 {
-    if (x < 0 || x > 511)
-        return; /* Pen is outside of the screen */
-    if (y < 0 || y > 255)
-        return; /* same in y direction */
-    // XOR mode active when (1.) Draw-pen is selected and (2.) XOR_EN bit is set
-    const bool xor_en = (((g_gdp.regs.seite & 0x01)!=0) && ((g_gdp.regs.ctrl1 & 0x02)!=0));
-
-    Uint32 color = SDL_MapRGB(sc->format, R, G, B);
-
-    switch (sc->format->BytesPerPixel)
-    {
-    case 1:
-    { /* vermutlich 8 Bit */
-        Uint8 *bufp;
-
-        for (int i = 0; i < g_gdp.xmag; i++)
-        {
-            for (int j = 0; j < g_gdp.ymag; j++)
-            {
-                bufp = (Uint8 *)sc->pixels + (y * g_gdp.ymag + j) * sc->pitch + (x * g_gdp.xmag + i);
-                if (xor_en) {
-                    *bufp ^= color;
-                }else{
-                    *bufp = color;
-                }
-            }
-        }
-    }
-    break;
-
-    case 2:
-    { /* vermutlich 15 Bit oder 16 Bit */
-        Uint16 *bufp;
-
-        for (int i = 0; i < g_gdp.xmag; i++)
-        {
-            for (int j = 0; j < g_gdp.ymag; j++)
-            {
-                bufp = (Uint16 *)sc->pixels + (y * g_gdp.ymag + j) * sc->pitch / 2 + (x * g_gdp.xmag + i);
-                if (xor_en) {
-                    *bufp ^= color;
-                }else{
-                    *bufp = color;
-                }
-            }
-        }
-    }
-    break;
-
-    case 3:
-    { /* langsamer 24-Bit-Modus, selten verwendet */
-        Uint8 *bufp;
-
-        for (int i = 0; i < g_gdp.xmag; i++)
-        {
-            for (int j = 0; j < g_gdp.ymag; j++)
-            {
-                bufp = (Uint8 *)sc->pixels + (y * g_gdp.ymag + j) * sc->pitch + (x * g_gdp.xmag + i) * 3;
-                bufp = (Uint8 *)sc->pixels + (y * g_gdp.ymag + j) * sc->pitch + (x * g_gdp.xmag + i);
-                if (SDL_BYTEORDER == SDL_LIL_ENDIAN)
-                {
-                    if (xor_en) {
-                        bufp[0] ^= color;
-                        bufp[1] ^= (color >> 8);
-                        bufp[2] ^= (color >> 16);
-                    }else{
-                        bufp[0] = color;
-                        bufp[1] = color >> 8;
-                        bufp[2] = color >> 16;
-                    }
-                }
-                else
-                {
-                    if (xor_en) {
-                        bufp[2] ^= color;
-                        bufp[1] ^= (color >> 8);
-                        bufp[0] ^= (color >> 16);
-                    }else{
-                        bufp[2] = color;
-                        bufp[1] = color >> 8;
-                        bufp[0] = color >> 16;
-                    }
-                }
-            }
-        }
-    }
-    break;
+    bool pen = (g_gdp.regs.ctrl1 & 0x02) != 0;
 
-    case 4:
-    { /* vermutlich 32 Bit */
-        Uint32 *bufp;
-
-        for (int i = 0; i < g_gdp.xmag; i++)
-        {
-            for (int j = 0; j < g_gdp.ymag; j++)
-            {
-                bufp = (Uint32 *)sc->pixels + (y * g_gdp.ymag + j) * sc->pitch / 4 + (x * g_gdp.xmag + i);
-                if (xor_en) {
-                    *bufp ^= color;
-                }else{
-                    *bufp = color;
-                }
-            }
-        }
-    }
-    break;
-    }
-    g_gdp.contentChanged = 1;
+    raster_set_pen(&g_gdp.raster, pen, pen && (g_gdp.regs.seite & 0x01) != 0);
 }
 
 void DrawChar(unsigned char c)
@@ -188,7 +83,6 @@ void DrawChar(unsigned char c)
     int realX = g_gdp.regs.penX;        /* x coordinate is running exactly as it's on the PC */
     int realY = 255 - g_gdp.regs.penY;  /* PC has y-coordinate 0 in the upper left corner, NKC has it in the lower left */
     unsigned char c_off = c - ' '; /* calulate down to array base */
-    int x, y;                      /* loop variables */
     int xSize = 0;
     int ySize = 0;
 
@@ -196,20 +90,6 @@ void DrawChar(unsigned char c)
         return;          /* wasn't an ASCII character or block */
     if (g_gdp.regs.ctrl1 & 1) /* is Pen down? else just calculate new coordinates */
     {
-        if (SDL_MUSTLOCK(g_gdp.pages[g_gdp.actualWritePage]))
-        {
-            if (SDL_LockSurface(g_gdp.pages[g_gdp.actualWritePage]) < 0)
-            {
-                return;
-            }
-        }
-        /* is pen in writing or deleting mode? */
-        SDL_Color pen;
-        if (g_gdp.regs.ctrl1 & 2)
-            pen = fg;
-        else
-            pen = bg;
-
         /* calculate sizing in X and Y directions */
         xSize = (g_gdp.regs.csize & 0xF0) >> 4;
         if (xSize == 0)
@@ -217,45 +97,7 @@ void DrawChar(unsigned char c)
         ySize = (g_gdp.regs.csize & 0x0F);
         if (ySize == 0)
             ySize = 16;
-        for (x = 0; x < 5; x++)
-        {
-            for (y = 0; y < 8; y++)
-            {
-                if ((charset[c_off][x] & 128 >> y) != 0)
-                {
-                    // draw pixel block, depending on magnification
-                    for (int x1 = 0; x1 < xSize; x1++)
-                    {
-                        for (int y1 = 0; y1 < ySize; y1++)
-                        {
-                            if (g_gdp.regs.ctrl2 & 8)
-                                DrawPixel(g_gdp.pages[g_gdp.actualWritePage], realX - y * ySize - y1, realY - x * xSize - x1, pen.r, pen.g, pen.b);
-                            else
-                                DrawPixel(g_gdp.pages[g_gdp.actualWritePage], realX + x * xSize + x1, realY - y * ySize - y1, pen.r, pen.g, pen.b);
-                        }
-                    }
-                }
-                if (g_gdp.regs.ctrl2 & 4)
-                {
-                    if (g_gdp.regs.ctrl2 & 8)
-                        realY--;
-                    else
-                        realX++;
-                }
-            }
-            if (g_gdp.regs.ctrl2 & 4) // tilted
-            {
-                if (g_gdp.regs.ctrl2 & 8)
-                    realY += 8;
-                else
-                    realX -= 8;
-            }
-        }
-
-        if (SDL_MUSTLOCK(g_gdp.pages[g_gdp.actualWritePage]))
-        {
-            SDL_UnlockSurface(g_gdp.pages[g_gdp.actualWritePage]);
-        }
+        raster_glyph(&g_gdp.raster, c_off, xSize, ySize, g_gdp.regs.ctrl2 & 0x0C, realX, realY);
     }
     // Now correct penX and penY
     if (g_gdp.regs.ctrl2 & 8)
@@ -269,25 +111,11 @@ void DrawBlock()
     /* draws a char at the current position of the pen */
     int realX = g_gdp.regs.penX; /* x coordinate is running exactly as it's on the PC */
     int realY = 255 - g_gdp.regs.penY; /* PC has y-coordinate 0 in the upper left corner, NKC has it in the lower left */
-    int x, y;               /* loop variables */
     int xSize = 0;
     int ySize = 0;
 
     if (g_gdp.regs.ctrl1 & 1) /* is Pen down? else just calculate new coordinates */
     {
-        if (SDL_MUSTLOCK(g_gdp.pages[g_gdp.actualWritePage]))
-        {
-            if (SDL_LockSurface(g_gdp.pages[g_gdp.actualWritePage]) < 0)
-            {
-                return;
-            }
-        }
-        /* is pen in writing or deleting mode? */
-        SDL_Color pen;
-        if (g_gdp.regs.ctrl1 & 2)
-            pen = fg;
-        else
-            pen = bg;
         /* calculate sizing in X and Y directions */
         xSize = (g_gdp.regs.csize & 0xF0) >> 4;
         ySize = (g_gdp.regs.csize & 0x0F);
@@ -295,45 +123,7 @@ void DrawBlock()
             xSize = 16;
         if (ySize == 0)
             ySize = 16;
-
-        for (x = 0; x < 4; x++)
-        {
-            for (y = 0; y < 4; y++)
-            {
-                int x1 = 0;
-                int y1 = 0;
-                // draw pixel block, depending on magnification
-                for (x1 = 0; x1 < xSize; x1++)
-                {
-                    for (y1 = 0; y1 < ySize; y1++)
-                    {
-                        if (g_gdp.regs.ctrl2 & 8)
-                            DrawPixel(g_gdp.pages[g_gdp.actualWritePage], realX - y * ySize - y1, realY - x * xSize - x1, pen.r, pen.g, pen.b);
-                        else
-                            DrawPixel(g_gdp.pages[g_gdp.actualWritePage], realX + x * xSize + x1, realY - y * ySize - y1, pen.r, pen.g, pen.b);
-                    }
-                }
-                if (g_gdp.regs.ctrl2 & 4)
-                {
-                    if (g_gdp.regs.ctrl2 & 8)
-                        realY--;
-                    else
-                        realX++;
-                }
-            }
-            if (g_gdp.regs.ctrl2 & 4) // tilted
-            {
-                if (g_gdp.regs.ctrl2 & 8)
-                    realY += 8;
-                else
-                    realX -= 8;
-            }
-        }
-
-        if (SDL_MUSTLOCK(g_gdp.pages[g_gdp.actualWritePage]))
-        {
-            SDL_UnlockSurface(g_gdp.pages[g_gdp.actualWritePage]);
-        }
+        raster_glyph(&g_gdp.raster, RASTER_BLOCK, xSize, ySize, g_gdp.regs.ctrl2 & 0x0C, realX, realY);
     }
     // Now correct penX and penY
     g_gdp.regs.penX += 4 * xSize; // char width + 1
@@ -354,44 +144,8 @@ void DrawHLine(int x1, int y, int x2)
         x1 = x2;
         x2 = h; /* triangular exchange */
     }
-    WORD_68K bit = 0x8000;   /* bit mask for line style */
     if (g_gdp.regs.ctrl1 & 1) /* is pen up? */
-    {
-        if (SDL_MUSTLOCK(g_gdp.pages[g_gdp.actualWritePage]))
-        {
-            if (SDL_LockSurface(g_gdp.pages[g_gdp.actualWritePage]) < 0)
-            {
-                return;
-            }
-        }
-        /* is pen in writing or deleting mode? */
-        SDL_Color pen;
-        SDL_Color inv;
-        if (g_gdp.regs.ctrl1 & 2)
-        {
-            pen = fg;
-            inv = bg;
-        }
-        else
-        {
-            pen = bg;
-            inv = fg;
-        }
-        for (; x1 <= x2; x1++)
-        {
-            if (style & bit)
-                DrawPixel(g_gdp.pages[g_gdp.actualWritePage], x1, y, pen.r, pen.g, pen.b);
-            else
-                DrawPixel(g_gdp.pages[g_gdp.actualWritePage], x1, y, inv.r, inv.g, inv.b);
-            bit = (bit >> 1);
-            if (bit == 0)
-                bit = 0x8000;
-        }
-        if (SDL_MUSTLOCK(g_gdp.pages[g_gdp.actualWritePage]))
-        {
-            SDL_UnlockSurface(g_gdp.pages[g_gdp.actualWritePage]);
-        }
-    }
+        raster_span(&g_gdp.raster, x1, x2, y, raster_pattern(style, x1));
 }
 
 /*
@@ -409,49 +163,14 @@ void DrawVLine(int x, int y1, int y2)
         y1 = y2;
         y2 = h; /* triangular exchange */
     }
-    WORD_68K bit = 0x8000;   /* bit mask for line style */
     if (g_gdp.regs.ctrl1 & 1) /* is pen up? */
-    {
-        if (SDL_MUSTLOCK(g_gdp.pages[g_gdp.actualWritePage]))
-        {
-            if (SDL_LockSurface(g_gdp.pages[g_gdp.actualWritePage]) < 0)
-            {
-                return;
-            }
-        }
-        /* is pen in writing or deleting mode? */
-        SDL_Color pen;
-        SDL_Color inv;
-        if (g_gdp.regs.ctrl1 & 2)
-        {
-            pen = fg;
-            inv = bg;
-        }
-        else
-        {
-            pen = bg;
-            inv = fg;
-        }
-        for (; y1 <= y2; y1++)
-        {
-            if (style & bit)
-                DrawPixel(g_gdp.pages[g_gdp.actualWritePage], x, y1, pen.r, pen.g, pen.b);
-            else
-                DrawPixel(g_gdp.pages[g_gdp.actualWritePage], x, y1, inv.r, inv.g, inv.b);
-            bit = (bit >> 1);
-            if (bit == 0)
-                bit = 0x8000;
-        }
-        if (SDL_MUSTLOCK(g_gdp.pages[g_gdp.actualWritePage]))
-        {
-            SDL_UnlockSurface(g_gdp.pages[g_gdp.actualWritePage]);
-        }
-    }
+        raster_column(&g_gdp.raster, x, y1, y2, style);
 }
 
 /*
  Draws a Line from x1,y1 to x2,y2 using the bresenham algorithm
  adopted from an implementation of
+ The pixels of a line with a gentle slope are drawn as horizontal runs.
  */
 void DrawLine(int x1, int y1, int x2, int y2)
 {
@@ -471,29 +190,8 @@ void DrawLine(int x1, int y1, int x2, int y2)
         x1 = x2;
         x2 = h;
     }
-    WORD_68K bit = 0x8000;   /* bit mask for line style */
     if (g_gdp.regs.ctrl1 & 1) /* is pen up? */
     {
-        if (SDL_MUSTLOCK(g_gdp.pages[g_gdp.actualWritePage]))
-        {
-            if (SDL_LockSurface(g_gdp.pages[g_gdp.actualWritePage]) < 0)
-            {
-                return;
-            }
-        }
-        /* is pen in writing or deleting mode? */
-        SDL_Color pen;
-        SDL_Color inv;
-        if (g_gdp.regs.ctrl1 & 2)
-        {
-            pen = fg;
-            inv = bg;
-        }
-        else
-        {
-            pen = bg;
-            inv = fg;
-        }
         /* now start bresenham */
         int dx = abs(x2 - x1);
         int dy = abs(y2 - y1);
@@ -504,17 +202,11 @@ void DrawLine(int x1, int y1, int x2, int y2)
             int two_dy = (2 * dy);
             int two_dy_dx = (2 * (dy - dx));
             int p = ((2 * dy) - dx);
+            uint64_t pattern = raster_pattern(style, x1);
 
             int x = x1;
             int y = y1;
-
-            if (style & bit)
-                DrawPixel(g_gdp.pages[g_gdp.actualWritePage], x, y, pen.r, pen.g, pen.b);
-            else
-                DrawPixel(g_gdp.pages[g_gdp.actualWritePage], x, y, inv.r, inv.g, inv.b);
-            bit = (bit >> 1);
-            if (bit == 0)
-                bit = 0x8000;
+            int start = x1;             /* first pixel of the run in row y */
 
             while (x < x2)
             {
@@ -525,18 +217,13 @@ void DrawLine(int x1, int y1, int x2, int y2)
 
                 else
                 {
+                    raster_span(&g_gdp.raster, start, x - 1, y, pattern);
+                    start = x;
                     y += inc_dec;
                     p += two_dy_dx;
                 }
-
-                if (style & bit)
-                    DrawPixel(g_gdp.pages[g_gdp.actualWritePage], x, y, pen.r, pen.g, pen.b);
-                else
-                    DrawPixel(g_gdp.pages[g_gdp.actualWritePage], x, y, inv.r, inv.g, inv.b);
-                bit = (bit >> 1);
-                if (bit == 0)
-                    bit = 0x8000;
             }
+            raster_span(&g_gdp.raster, start, x, y, pattern);
         }
         else
         {
@@ -546,11 +233,9 @@ void DrawLine(int x1, int y1, int x2, int y2)
 
             int x = x1;
             int y = y1;
+            WORD_68K bit = 0x8000;   /* bit mask for line style */
 
-            if (style & bit)
-                DrawPixel(g_gdp.pages[g_gdp.actualWritePage], x, y, pen.r, pen.g, pen.b);
-            else
-                DrawPixel(g_gdp.pages[g_gdp.actualWritePage], x, y, inv.r, inv.g, inv.b);
+            raster_pixel(&g_gdp.raster, x, y, (style & bit) != 0);
             bit = (bit >> 1);
             if (bit == 0)
                 bit = 0x8000;
@@ -568,32 +253,25 @@ void DrawLine(int x1, int y1, int x2, int y2)
                     p += two_dx_dy;
                 }
 
-                if (style & bit)
-                    DrawPixel(g_gdp.pages[g_gdp.actualWritePage], x, y, pen.r, pen.g, pen.b);
-                else
-                    DrawPixel(g_gdp.pages[g_gdp.actualWritePage], x, y, inv.r, inv.g, inv.b);
+                raster_pixel(&g_gdp.raster, x, y, (style & bit) != 0);
                 bit = (bit >> 1);
                 if (bit == 0)
                     bit = 0x8000;
             }
         }
-        if (SDL_MUSTLOCK(g_gdp.pages[g_gdp.actualWritePage]))
-        {
-            SDL_UnlockSurface(g_gdp.pages[g_gdp.actualWritePage]);
-        }
     }
 }
 
 void clearScreen()
 {
-    /* fills the SDL surface with the background color */
-    SDL_FillRect(g_gdp.pages[g_gdp.actualWritePage], NULL, SDL_MapRGB(g_gdp.pages[g_gdp.actualWritePage]->format, bg.r, bg.g, bg.b));
+    /* fills the page with the background color */
+    raster_fill(&g_gdp.raster, false);
 }
 
 void fillScreen()
 {
-    /* fills the SDL surface with the background color */
-    SDL_FillRect(g_gdp.pages[g_gdp.actualWritePage], NULL, SDL_MapRGB(g_gdp.pages[g_gdp.actualWritePage]->format, fg.r, fg.g, fg.b));
+    /* fills the page with the foreground color */
+    raster_fill(&g_gdp.raster, true);
 }
 
 /*
@@ -607,16 +285,15 @@ BYTE_68K gdp64_p60_in()
 
 void gdp64_p60_out(BYTE_68K b)
 {
+    gdp64_sync();   /* the queued commands draw on the old write page */
 //    if(g_gdp.isGuiScreen)
 //        return;
     g_gdp.actualReadPage = (b & 0x30) >> 4;
-    g_gdp.actualWritePage = (b & 0xC0) >> 6;
-//    log_debug("GDP64: Set read page to %d, write page to %d", g_gdp.actualReadPage, g_gdp.actualWritePage);
-    if (g_gdp.regs.seite != b)
-    {
-        g_gdp.contentChanged = 1;
-    }
+    g_gdp.raster.page = (b & 0xC0) >> 6;
+//    log_debug("GDP64: Set read page to %d, write page to %d", g_gdp.actualReadPage, g_gdp.raster.page);
+    /* a new read page is shown as a whole with the next frame, see gdp64_present */
     g_gdp.regs.seite = b;
+    selectPen();
 }
 
 BYTE_68K gdp64_p61_in()
@@ -628,11 +305,7 @@ void gdp64_p61_out(BYTE_68K b)
 {
 //    if(g_gdp.isGuiScreen)
 //        return;
-    if (g_gdp.regs.scroll != b)
-    {
-        g_gdp.contentChanged = 1;
-
-    }
+    /* the rows are moved when the next frame is shown, see gdp64_show */
     g_gdp.regs.scroll = b;
 }
 
@@ -664,17 +337,15 @@ BYTE_68K gdp64_p70_in()
     return g_gdp.regs.status;
 }
 
-void gdp64_p70_out(BYTE_68K b)
+/* Execute a command of the EF9366, the status register is handled by the caller */
+static void executeCommand(BYTE_68K b)
 {
     // if(b < 0x20 )
     //     log_info("GDP64: Write to port 0x70: %x", b);
-    Uint32 pen;
-    g_gdp.regs.status = (g_gdp.regs.status & 0xFB);
-    /* accept commands for the EF9366 and call the SDL implementations for them */
+    /* accept commands for the EF9366 and call the raster implementations for them */
     if (b >= 0x20 && b <= 0x7F) /* was an ASCII character */
     {
         DrawChar(b);
-        g_gdp.regs.status = (g_gdp.regs.status | 4);
         return;
     }
     /* short vector command? */
@@ -685,16 +356,9 @@ void gdp64_p70_out(BYTE_68K b)
         BYTE_68K dy = ((b & 0x18) >> 3);
         BYTE_68K dir = (b & 7);
         int i;
-        if (g_gdp.regs.ctrl1 & 2)
-            pen = fg32;
-        else
-            pen = bg32;
-
         DrawLine(g_gdp.regs.penX, 255 - g_gdp.regs.penY, g_gdp.regs.penX + dx * dirMul[dir][0], 255 - (g_gdp.regs.penY + dy * dirMul[dir][1]));
-        g_gdp.contentChanged = 1;
         g_gdp.regs.penX = g_gdp.regs.penX + dx * dirMul[dir][0];
         g_gdp.regs.penY = g_gdp.regs.penY + dy * dirMul[dir][1];
-        g_gdp.regs.status = g_gdp.regs.status | 4;
         return;
     }
     /* must be a GDP command */
@@ -702,10 +366,12 @@ void gdp64_p70_out(BYTE_68K b)
     {
     case 0: /* pen selection */
         g_gdp.regs.ctrl1 = (g_gdp.regs.ctrl1 | 2);
+        selectPen();
         break;
 
     case 1: /* eraser selection */
         g_gdp.regs.ctrl1 = (g_gdp.regs.ctrl1 & 0xFD);
+        selectPen();
         break;
 
     case 2: /* pen down */
@@ -738,7 +404,7 @@ void gdp64_p70_out(BYTE_68K b)
         g_gdp.regs.penY = 0;
         g_gdp.regs.csize = 0x11;
         g_gdp.regs.ctrl1 = 0;
-        g_gdp.regs.status = 4;
+        selectPen();
         break;
 
     case 10: /* block drawing 5x8 */
@@ -767,68 +433,40 @@ void gdp64_p70_out(BYTE_68K b)
 
     case 16: /* draw horizontal line in positive x direction */
         DrawHLine(g_gdp.regs.penX, 255 - g_gdp.regs.penY, g_gdp.regs.penX + g_gdp.regs.deltax);
-        g_gdp.contentChanged = 1;
         break;
 
     case 17: /* draw line in positive x and y direction */
-        if (g_gdp.regs.ctrl1 & 2)
-            pen = fg32;
-        else
-            pen = bg32;
-
         DrawLine(g_gdp.regs.penX, 255 - g_gdp.regs.penY, g_gdp.regs.penX + g_gdp.regs.deltax, 255 - (g_gdp.regs.penY + g_gdp.regs.deltay));
-        g_gdp.contentChanged = 1;
         g_gdp.regs.penX = g_gdp.regs.penX + g_gdp.regs.deltax;
         g_gdp.regs.penY = g_gdp.regs.penY + g_gdp.regs.deltay;
         break;
 
     case 18: /* draw vertical line in positive y direction */
         DrawVLine(g_gdp.regs.penX, 255 - g_gdp.regs.penY, 255 - (g_gdp.regs.penY + g_gdp.regs.deltay));
-        g_gdp.contentChanged = 1;
         break;
 
     case 19: /* draw line in negative x and positive y direction */
-        if (g_gdp.regs.ctrl1 & 2)
-            pen = fg32;
-        else
-            pen = bg32;
-
         DrawLine(g_gdp.regs.penX, 255 - g_gdp.regs.penY, g_gdp.regs.penX - g_gdp.regs.deltax, 255 - (g_gdp.regs.penY + g_gdp.regs.deltay));
-        g_gdp.contentChanged = 1;
         g_gdp.regs.penX = g_gdp.regs.penX - g_gdp.regs.deltax;
         g_gdp.regs.penY = g_gdp.regs.penY + g_gdp.regs.deltay;
         break;
 
     case 20: /* draw vertical line in negative y direction */
         DrawVLine(g_gdp.regs.penX, 255 - g_gdp.regs.penY, 255 - (g_gdp.regs.penY - g_gdp.regs.deltay));
-        g_gdp.contentChanged = 1;
         break;
 
     case 21: /* draw line in positive x and negative y direction */
-        if (g_gdp.regs.ctrl1 & 2)
-            pen = fg32;
-        else
-            pen = bg32;
-
         DrawLine(g_gdp.regs.penX, 255 - g_gdp.regs.penY, g_gdp.regs.penX + g_gdp.regs.deltax, 255 - (g_gdp.regs.penY - g_gdp.regs.deltay));
-        g_gdp.contentChanged = 1;
         g_gdp.regs.penX = g_gdp.regs.penX + g_gdp.regs.deltax;
         g_gdp.regs.penY = g_gdp.regs.penY - g_gdp.regs.deltay;
         break;
 
     case 22: /* draw horizontal line in negative x direction */
         DrawHLine(g_gdp.regs.penX, 255 - g_gdp.regs.penY, g_gdp.regs.penX - g_gdp.regs.deltax);
-        g_gdp.contentChanged = 1;
         break;
 
     case 23: /* draw line in negative x and positive y direction */
-        if (g_gdp.regs.ctrl1 & 2)
-            pen = fg32;
-        else
-            pen = bg32;
-
         DrawLine(g_gdp.regs.penX, 255 - g_gdp.regs.penY, g_gdp.regs.penX - g_gdp.regs.deltax, 255 - (g_gdp.regs.penY - g_gdp.regs.deltay));
-        g_gdp.contentChanged = 1;
         g_gdp.regs.penX = g_gdp.regs.penX - g_gdp.regs.deltax;
         g_gdp.regs.penY = g_gdp.regs.penY - g_gdp.regs.deltay;
         break;
@@ -836,12 +474,180 @@ void gdp64_p70_out(BYTE_68K b)
     default: /* unimplemented command, do nothing and return */
         break;
     }
+}
+
+/*
+  Raster thread: with GdpThread set, the writes to the EF9366 registers are
+  queued and executed on a thread of their own while the CPU goes on. The
+  emulation thread only waits for the queue to drain before it reads state
+  the commands change: pen position, registers, a page switch and the
+  pages at VSYNC. The status register stays with the emulation thread.
+*/
+static void executeWrite(const gdp64_write *w)
+{
+    switch (w->reg)
+    {
+    case 0x00: executeCommand(w->value); break;
+    case 0x01: gdp64_p71_out(w->value); break;
+    case 0x02: gdp64_p72_out(w->value); break;
+    case 0x03: gdp64_p73_out(w->value); break;
+    case 0x05: gdp64_p75_out(w->value); break;
+    case 0x07: gdp64_p77_out(w->value); break;
+    case 0x08: gdp64_p78_out(w->value); break;
+    case 0x09: gdp64_p79_out(w->value); break;
+    case 0x0A: gdp64_p7A_out(w->value); break;
+    case 0x0B: gdp64_p7B_out(w->value); break;
+    case GDP64_WORD | 0x02: gdp64_p72_out_word(w->value); break;
+    case GDP64_WORD | 0x08: gdp64_p78_out_word(w->value); break;
+    case GDP64_WORD | 0x0A: gdp64_p7A_out_word(w->value); break;
+    }
+}
+
+static int rasterize(void *data)
+{
+    for (;;)
+    {
+        SDL_SemWait(g_gdp.pending);
+        Uint32 tail = (Uint32)SDL_AtomicGet(&g_gdp.tail);
+        executeWrite(&g_gdp.queue[tail & (GDP64_QUEUE - 1)]);
+        SDL_AtomicAdd(&g_gdp.tail, 1);
+        if (SDL_AtomicGet(&g_gdp.waiting))
+        {
+            SDL_LockMutex(g_gdp.lock);
+            SDL_CondSignal(g_gdp.executed);
+            SDL_UnlockMutex(g_gdp.lock);
+        }
+    }
+    return 0;
+}
+
+/* Block until at most the given number of writes are left in the queue */
+static void waitQueued(Uint32 left)
+{
+    SDL_LockMutex(g_gdp.lock);
+    SDL_AtomicSet(&g_gdp.waiting, 1);
+    while (g_gdp.head - (Uint32)SDL_AtomicGet(&g_gdp.tail) > left)
+        SDL_CondWait(g_gdp.executed, g_gdp.lock);
+    SDL_AtomicSet(&g_gdp.waiting, 0);
+    SDL_UnlockMutex(g_gdp.lock);
+}
+
+static void queueWrite(BYTE_68K reg, int value)
+{
+    if (g_gdp.head - (Uint32)SDL_AtomicGet(&g_gdp.tail) >= GDP64_QUEUE)
+        waitQueued(GDP64_QUEUE - 1);    /* queue is full, the raster thread is behind */
+    g_gdp.queue[g_gdp.head & (GDP64_QUEUE - 1)].reg = reg;
+    g_gdp.queue[g_gdp.head & (GDP64_QUEUE - 1)].value = value;
+    g_gdp.head++;
+    g_gdp.queued++;
+    SDL_SemPost(g_gdp.pending);
+}
+
+/* Port handlers of the threaded mode, the raster thread calls the plain ones */
+static void queueCtrl1(BYTE_68K b) { queueWrite(0x01, b); }
+static void queueCtrl2(BYTE_68K b) { queueWrite(0x02, b); }
+static void queueCsize(BYTE_68K b) { g_gdp.timed.csize = b; queueWrite(0x03, b); }
+static void queueDeltaX(BYTE_68K b) { g_gdp.timed.deltax = b; queueWrite(0x05, b); }
+static void queueDeltaY(BYTE_68K b) { g_gdp.timed.deltay = b; queueWrite(0x07, b); }
+static void queueXMsb(BYTE_68K b) { queueWrite(0x08, b); }
+static void queueXLsb(BYTE_68K b) { queueWrite(0x09, b); }
+static void queueYMsb(BYTE_68K b) { queueWrite(0x0A, b); }
+static void queueYLsb(BYTE_68K b) { queueWrite(0x0B, b); }
+static void queueCtrl2Word(int w) { g_gdp.timed.csize = w & 0xFF; queueWrite(GDP64_WORD | 0x02, w); }
+static void queueXWord(int w) { queueWrite(GDP64_WORD | 0x08, w); }
+static void queueYWord(int w) { queueWrite(GDP64_WORD | 0x0A, w); }
+
+/* Wait until the raster thread executed all queued writes */
+void gdp64_sync()
+{
+    if (!g_gdp.threaded || (Uint32)SDL_AtomicGet(&g_gdp.tail) == g_gdp.head)
+        return;
+    g_gdp.waits++;
+    waitQueued(0);
+}
+
+void gdp64_log_stats()
+{
+    if (!g_gdp.threaded)
+        return;
+    log_info("GDP64: %lld register writes queued, %lld reads waited for the raster thread",
+             g_gdp.queued, g_gdp.waits);
+    g_gdp.queued = 0;
+    g_gdp.waits = 0;
+}
+
+/*
+  Drawing time of a command in nano seconds. The EF9366 plots one dot per
+  memory cycle: the longer delta of a vector, the scaled 5x8 or 4x4 matrix
+  of a character or block. Clearing the screen waits for one frame scan.
+  In threaded mode the registers belong to the raster thread, the time is
+  taken from the copies written by the CPU.
+*/
+static long long drawingNanos(BYTE_68K b)
+{
+    const gdp64_registers *regs = g_gdp.threaded ? &g_gdp.timed : &g_gdp.regs;
+    int xSize = (regs->csize & 0xF0) >> 4;
+    int ySize = (regs->csize & 0x0F);
+    int dots = 0;
+
+    if (xSize == 0)
+        xSize = 16;
+    if (ySize == 0)
+        ySize = 16;
+    if (b >= 128)                           /* short vector */
+        dots = ((b & 0x60) >> 5) > ((b & 0x18) >> 3) ? (b & 0x60) >> 5 : (b & 0x18) >> 3;
+    else if ((b >= 0x20 && b <= 0x7F) || b == 10)
+        dots = 5 * xSize * 8 * ySize;
+    else if (b == 11)
+        dots = 4 * xSize * 4 * ySize;
+    else if (b == 16 || b == 22)
+        dots = regs->deltax;
+    else if (b == 18 || b == 20)
+        dots = regs->deltay;
+    else if (b >= 17 && b <= 23)
+        dots = regs->deltax > regs->deltay ? regs->deltax : regs->deltay;
+    else if (b == 4 || b == 6 || b == 7 || b == 12)
+        return GDP64_CLEAR_MICROS * 1000LL;
+    return GDP64_CMD_NANOS + (long long)dots * GDP64_DOT_NANOS;
+}
+
+static void commandDone()
+{
     g_gdp.regs.status = (g_gdp.regs.status | 4);
-    return;
+}
+
+/* The ready bit stays cleared until the command would be drawn by the EF9366 */
+static void startCommand(BYTE_68K b)
+{
+    long long start = sched_current();
+
+    if (g_gdp.readyAt > start)
+        start = g_gdp.readyAt;      /* the CPU didn't wait for the last command */
+    g_gdp.readyAt = start + drawingNanos(b) * g_config.cpuSpeed / 1000;
+    sched_add(SCHED_GDP64, g_gdp.readyAt - sched_now(), commandDone);
+}
+
+void gdp64_p70_out(BYTE_68K b)
+{
+    g_gdp.regs.status = (g_gdp.regs.status & 0xFB);
+    if (b == 7) /* clear screen, set CSIZE to 1, other registers to 0 */
+    {
+        g_gdp.regs.status = 0;
+        g_gdp.timed.csize = 0x11;
+    }
+    if (g_config.gdpTiming)
+        startCommand(b);
+    if (g_gdp.threaded)
+        queueWrite(0x00, b);
+    else
+        executeCommand(b);
+    if (!g_config.gdpTiming)
+        g_gdp.regs.status = (g_gdp.regs.status | 4);
 }
 
 BYTE_68K gdp64_p71_in()
 {
+    gdp64_sync();
     /* read CTRL1 register of EF9366
      * meanings of the bits:
      * bit 0: pen position, 1=down, 0=up
@@ -860,11 +666,13 @@ void gdp64_p71_out(BYTE_68K b)
 {
     /* accept values for CTRL1 register of the EF9366 */
     g_gdp.regs.ctrl1 = b;
+    selectPen();
     return;
 }
 
 BYTE_68K gdp64_p72_in()
 {
+    gdp64_sync();
     /* read CTRL2 register of EF9366
      * meanings of the bits:
      * bit 0: type of vectors, LSB
@@ -899,6 +707,7 @@ void gdp64_p72_out_word( int b )
 
 BYTE_68K gdp64_p73_in()
 {
+    gdp64_sync();
     /* read CSIZE register of EF9366 */
     return g_gdp.regs.csize;
 }
@@ -912,6 +721,7 @@ void gdp64_p73_out(BYTE_68K b)
 
 BYTE_68K gdp64_p75_in()
 {
+    gdp64_sync();
     /* read DELTAX register of EF9366 */
     return g_gdp.regs.deltax;
 }
@@ -925,6 +735,7 @@ void gdp64_p75_out(BYTE_68K b)
 
 BYTE_68K gdp64_p77_in()
 {
+    gdp64_sync();
     /* read DELTAY register of EF9366 */
     return g_gdp.regs.deltay;
 }
@@ -938,12 +749,14 @@ void gdp64_p77_out(BYTE_68K b)
 
 BYTE_68K gdp64_p78_in()
 {
+    gdp64_sync();
     /* read X MSB register of EF9366 */
     return (BYTE_68K)((g_gdp.regs.penX & 0xFF00) >> 8); /* most significant 8 bits */
 }
 
 int gdp64_p78_in_word()
 {
+    gdp64_sync();
     /* read penX register of EF9366 as word */
     return g_gdp.regs.penX;
 }
@@ -962,6 +775,7 @@ void gdp64_p78_out_word(int b)
 
 BYTE_68K gdp64_p79_in()
 {
+    gdp64_sync();
     /* read X LSB register of EF9366 */
     return (BYTE_68K)(g_gdp.regs.penX & 0xFF);
 }
@@ -975,12 +789,14 @@ void gdp64_p79_out(BYTE_68K b)
 
 BYTE_68K gdp64_p7A_in()
 {
+    gdp64_sync();
     /* read Y MSB register of EF9366 */
     return (BYTE_68K)((g_gdp.regs.penY & 0xFF00) >> 8); /* most significant 8 bits */
 }
 
 int gdp64_p7A_in_word()
 {
+    gdp64_sync();
     /* read penY register of EF9366 as word */
     return g_gdp.regs.penY;
 }
@@ -999,6 +815,7 @@ void gdp64_p7A_out_word(int b)
 
 BYTE_68K gdp64_p7B_in()
 {
+    gdp64_sync();
     /* read Y LSB register of EF9366 */
     return (BYTE_68K)(g_gdp.regs.penY & 0xFF);
 }
@@ -1012,6 +829,7 @@ void gdp64_p7B_out(BYTE_68K b)
 
 void gdp64_save_regs()
 {
+    gdp64_sync();
     g_gdp.save_regs.status = g_gdp.regs.status;
     g_gdp.save_regs.ctrl1  = g_gdp.regs.ctrl1;
     g_gdp.save_regs.ctrl2  = g_gdp.regs.ctrl2;
@@ -1026,6 +844,8 @@ void gdp64_save_regs()
 void gdp64_restore_regs()
 {
     g_gdp.regs.status = g_gdp.save_regs.status;
+    if (!sched_pending(SCHED_GDP64))   /* the command drawn when the GUI opened is done */
+        g_gdp.regs.status = (g_gdp.regs.status | 4);
     g_gdp.regs.ctrl1  = g_gdp.save_regs.ctrl1;
     g_gdp.regs.ctrl2  = g_gdp.save_regs.ctrl2;
     g_gdp.regs.csize  = g_gdp.save_regs.csize;
@@ -1036,14 +856,15 @@ void gdp64_restore_regs()
     g_gdp.regs.seite  = g_gdp.save_regs.seite;
 
     g_gdp.actualReadPage = (g_gdp.regs.seite & 0x30) >> 4;
-    g_gdp.actualWritePage = (g_gdp.regs.seite & 0xC0) >> 6;
+    g_gdp.raster.page = (g_gdp.regs.seite & 0xC0) >> 6;
+    selectPen();
 }
 
 void gdp64_gui_draw_string(int x, int y, int size, const char * str)
 {
     g_gdp.isGuiScreen = true;
 
-    g_gdp.actualWritePage = 4;
+    g_gdp.raster.page = 4;
     g_gdp.actualReadPage = 4;
     g_gdp.regs.penX = x;
     g_gdp.regs.penY = y;
@@ -1058,11 +879,13 @@ void gdp64_gui_draw_string(int x, int y, int size, const char * str)
         if(ch >= 0x20 && ch <= 0x7F) {
             // Set Erapen
             g_gdp.regs.ctrl1 &= 0b11111101;
+            selectPen();
             DrawChar(128);              // Draw Block to erase background
             // Set Pen
             g_gdp.regs.penX = cur_x;
             g_gdp.regs.penY = cur_y;
             g_gdp.regs.ctrl1 |= 0b00000010;
+            selectPen();
             DrawChar(str[i]);           // Draw Character
         }
         if(ch == 0x0a )
@@ -1093,7 +916,7 @@ void gdp64_umrande(int x, int y, int size, int len)
 
 void gdp64_gui_input_string(int x, int y, int size, int len, char * str)
 {
-    g_gdp.actualWritePage = 4;
+    g_gdp.raster.page = 4;
     g_gdp.actualReadPage = 4;
     g_gdp.regs.penX = x;
     g_gdp.regs.penY = y;
@@ -1125,8 +948,10 @@ void gdp64_gui_blink_cursor()
                 g_gdp.regs.penY = g_gui_cursor.y;
                 g_gdp.regs.csize = g_gui_cursor.csize;
                 g_gdp.regs.ctrl1 &= 0b11111101; // Set Erapen
+                selectPen();
                 DrawChar(128);              // Erase cursor block
                 g_gdp.regs.ctrl1 |= 0b00000010;
+                selectPen();
                 g_gui_cursor.isOff = true;
             }
             else {
@@ -1167,23 +992,67 @@ int gdp64_init()
         exit(1);
     }
 
-    /* create the four pages of the EF9366  plus on GUI page */
-    for (int i = 0; i < 5; i++)
+    /* the pages are kept at the resolution of the EF9366, the texture scales them to the window */
+    if (!frame_init(&g_gdp.frame, GDP64_WIDTH, GDP64_HEIGHT))
+        exit(2);
+    SDL_PixelFormat *format = frame_back(&g_gdp.frame)->format;
+    g_gdp.texture = SDL_CreateTexture(g_gdp.renderer, format->format, SDL_TEXTUREACCESS_STREAMING, GDP64_WIDTH, GDP64_HEIGHT);
+    if (g_gdp.texture == NULL)
+    {
+        log_error("Cant't create texture for EF9366. SDL-Error:%s\n", SDL_GetError());
+        exit(2);
+    }
+    g_gdp.colors[0] = SDL_MapRGB(format, bg.r, bg.g, bg.b);
+    g_gdp.colors[1] = SDL_MapRGB(format, fg.r, fg.g, fg.b);
+
+    /* optionally rasterize on a thread of its own */
+    g_gdp.threaded = false;
+    if (g_config.gdpThread)
     {
-//        g_gdp.pages[i] = SDL_CreateRGBSurface(SDL_SWSURFACE, 512 * g_gdp.xmag, 256 * g_gdp.ymag, 32, 0, 0, 0, 0);
-        g_gdp.pages[i] = SDL_CreateRGBSurface(SDL_SWSURFACE, 512 * g_gdp.xmag, 256 * g_gdp.ymag, 32, 0, 0, 0, 0);
-        if (g_gdp.pages[i] == NULL)
+        g_gdp.pending = SDL_CreateSemaphore(0);
+        g_gdp.lock = SDL_CreateMutex();
+        g_gdp.executed = SDL_CreateCond();
+        SDL_AtomicSet(&g_gdp.waiting, 0);
+        g_gdp.thread = g_gdp.pending == NULL || g_gdp.lock == NULL || g_gdp.executed == NULL ? NULL
+                       : SDL_CreateThread(rasterize, "GDP64 raster", NULL);
+        if (g_gdp.thread == NULL)
+            log_error("Can't start the GDP64 raster thread, rasterizing on the CPU thread. SDL-Error:%s", SDL_GetError());
+        else
         {
-            log_error("Cant't create page %d for EF9366. SDL-Error:%s\n", i, SDL_GetError());
-            exit(2);
+            SDL_DetachThread(g_gdp.thread);
+            g_gdp.threaded = true;
         }
     }
+    const bool threaded = g_gdp.threaded;
+
+    /* register the ports of the GDP64 card */
+    bus_register(GDP_PAGE, gdp64_p60_in, gdp64_p60_out);
+    bus_register(GDP_SCROLL, gdp64_p61_in, gdp64_p61_out);
+    bus_register(GDP_CMD, gdp64_p70_in, gdp64_p70_out);             // Status/command register
+    bus_set_pollable(GDP_CMD, true);
+    bus_register(GDP_CMD + 1, gdp64_p71_in, threaded ? queueCtrl1 : gdp64_p71_out);     // CTRL1 register
+    bus_register(GDP_CMD + 2, gdp64_p72_in, threaded ? queueCtrl2 : gdp64_p72_out);     // CTRL2 register
+    bus_register(GDP_CMD + 3, gdp64_p73_in, threaded ? queueCsize : gdp64_p73_out);     // CSIZE register
+    bus_register(GDP_CMD + 4, bus_null_in, bus_null_out);           // NOT USED
+    bus_register(GDP_CMD + 5, gdp64_p75_in, threaded ? queueDeltaX : gdp64_p75_out);    // DELTAX register
+    bus_register(GDP_CMD + 6, bus_null_in, bus_null_out);           // NOT USED
+    bus_register(GDP_CMD + 7, gdp64_p77_in, threaded ? queueDeltaY : gdp64_p77_out);    // DELTAY register
+    bus_register(GDP_CMD + 8, gdp64_p78_in, threaded ? queueXMsb : gdp64_p78_out);      // X register MSB
+    bus_register(GDP_CMD + 9, gdp64_p79_in, threaded ? queueXLsb : gdp64_p79_out);      // X register LSB
+    bus_register(GDP_CMD + 10, gdp64_p7A_in, threaded ? queueYMsb : gdp64_p7A_out);     // Y register MSB
+    bus_register(GDP_CMD + 11, gdp64_p7B_in, threaded ? queueYLsb : gdp64_p7B_out);     // Y register LSB
+    for (int i = 12; i < 16; i++)                                   // Lightpen and NOT USED
+        bus_register(GDP_CMD + i, bus_null_in, bus_null_out);
+    bus_register_word(GDP_CMD + 2, NULL, threaded ? queueCtrl2Word : gdp64_p72_out_word);
+    bus_register_word(GDP_CMD + 8, gdp64_p78_in_word, threaded ? queueXWord : gdp64_p78_out_word);
+    bus_register_word(GDP_CMD + 10, gdp64_p7A_in_word, threaded ? queueYWord : gdp64_p7A_out_word);
 
     return SDL_GetWindowID(g_gdp.window);
 }
 
 void gdp64_reset()
 {
+    gdp64_sync();
     g_gdp.regs.status = 0x04;       /* status of the gdp, here initialized with b00000100 */
     g_gdp.regs.ctrl1 = 0x00;        /* CTRL1 register */
     g_gdp.regs.ctrl2 = 0x00;        /* CTRL2 register */
@@ -1194,15 +1063,20 @@ void gdp64_reset()
     g_gdp.regs.deltay = 0x00;       /* DELTAY register */
     g_gdp.regs.seite = 0;           /* PAGE register */
     g_gdp.regs.scroll = 0;          /* HARD-SCROLL register */
-    g_gdp.actualWritePage = 0;      /* on which page do we write at the moment? */
+    g_gdp.timed = g_gdp.regs;
+    g_gdp.readyAt = 0;
+    sched_cancel(SCHED_GDP64);
+    g_gdp.raster.page = 0;          /* on which page do we write at the moment? */
     g_gdp.actualReadPage = 0;       /* which page is shown at the moment? */
-    g_gdp.contentChanged = 0;       /* something new written? */
+    g_gdp.shownPage = -1;           /* show the whole page with the next frame */
     g_gdp.isGuiScreen = false;
+    selectPen();
     clearScreen();
 }
 
 void gdp64_clear_screen()
 {
+    gdp64_sync();
     clearScreen();
 }
 
@@ -1213,36 +1087,6 @@ void gdp64_set_vsync(BYTE_68K vs)
         if( g_gdp.isGuiScreen )
             gdp64_gui_blink_cursor();
         g_gdp.regs.status = (g_gdp.regs.status | 2);
-        /* now blit actual readed page if something has changed */
-        if (g_gdp.contentChanged == 1)
-        {
-            // Scroll Screen by g_gdp.regs.scroll pixels down
-            const unsigned int scroll_value = (unsigned int)(g_gdp.regs.scroll & 0xFE);
-            if (scroll_value!=0){
-                // Window is 256*3 = 768 in height, y-coordinates are mirrores (0,0 is top-left)
-               {
-                    // 1. Scroll upper part (scroll...top) down to 0
-                    const SDL_Rect src = {.x=0,.y=0,.w=512 * g_gdp.xmag, .h=(256 - scroll_value) * g_gdp.ymag};
-                    SDL_Rect dest      = {.x=0,.y=(scroll_value) * g_gdp.ymag,.w=512 * g_gdp.xmag, .h=(256 - scroll_value) * g_gdp.ymag};
-                    SDL_BlitSurface(g_gdp.pages[g_gdp.actualReadPage], &src, SDL_GetWindowSurface(g_gdp.window), &dest);
-                    //printf("Scroll: %u %u\r\n",scroll_value,g_gdp.ymag);
-                    //printf("rect1: y:%u, h:%u -> y:%u, h:%u\r\n",src.y, src.h, dest.y, dest.h);
-                    //fflush(stdout);
-                }
-                {
-                    // 2. Scroll lower part (0...scroll) up to top
-                    const SDL_Rect src = {.x=0,.y=(256 - scroll_value) * g_gdp.ymag,.w=512 * g_gdp.xmag, .h=scroll_value * g_gdp.ymag};
-                    SDL_Rect dest      = {.x=0,.y=0,.w=512 * g_gdp.xmag, .h=scroll_value * g_gdp.ymag};
-                    SDL_BlitSurface(g_gdp.pages[g_gdp.actualReadPage], &src, SDL_GetWindowSurface(g_gdp.window), &dest);
-                    //printf("rect2: y:%u, h:%u -> y:%u, h:%u\r\n",src.y, src.h, dest.y, dest.h);
-                    //fflush(stdout);
-                }
-            }else{
-                SDL_BlitSurface(g_gdp.pages[g_gdp.actualReadPage], NULL, SDL_GetWindowSurface(g_gdp.window), NULL);
-            }
-            SDL_RenderPresent(g_gdp.renderer);
-            g_gdp.contentChanged = 0;
-        }
     }
     else
     {
@@ -1251,6 +1095,111 @@ void gdp64_set_vsync(BYTE_68K vs)
     return;
 }
 
+/* Expand a row of a page to the pixel colors */
+static void expandRow(const uint64_t *row, Uint32 *pixels)
+{
+    for (int w = 0; w < GDP64_WORDS; w++)
+    {
+        uint64_t bits = row[w];
+        for (int i = 0; i < 64; i++)
+            *pixels++ = g_gdp.colors[(bits >> i) & 1];
+    }
+}
+
+/*
+ * Hand the actual read page to the main thread, called at VSYNC. Only the
+ * rows written since the last frame are expanded, unless the read page
+ * changed. The hard scroll register goes along with the frame, it is
+ * applied when the frame is shown.
+ */
+void gdp64_present()
+{
+    gdp64_sync();
+    const int page = g_gdp.actualReadPage;
+    const unsigned int scroll_value = (unsigned int)(g_gdp.regs.scroll & 0xFE);
+    const bool all = page != g_gdp.shownPage;
+    bool any = all || scroll_value != g_gdp.shownScroll;
+
+    for (int w = 0; w < GDP64_HEIGHT / 64; w++)
+        any = any || g_gdp.raster.dirty[page][w] != 0;
+    if (!any)
+        return;
+
+    /* the back buffer holds an older frame, bring all rows changed since then up to date */
+    SDL_Surface *back = frame_back(&g_gdp.frame);
+    const Uint64 *stale = frame_prepare(&g_gdp.frame, all ? NULL : g_gdp.raster.dirty[page]);
+    for (int y = 0; y < GDP64_HEIGHT; y++)
+    {
+        if ((stale[y >> 6] >> (y & 63)) & 1)
+            expandRow(g_gdp.raster.pages[page][y], (Uint32 *)((Uint8 *)back->pixels + y * back->pitch));
+    }
+    memset(g_gdp.raster.dirty, 0, sizeof(g_gdp.raster.dirty));
+    frame_publish(&g_gdp.frame, scroll_value);
+    g_gdp.shownPage = page;
+    g_gdp.shownScroll = scroll_value;
+}
+
+/* Show the latest frame in the window, scaled by the renderer, runs on the main thread */
+void gdp64_show()
+{
+    SDL_Surface *shown = frame_acquire(&g_gdp.frame);
+
+    if (shown != NULL)
+    {
+        /* upload the runs of changed rows, or all of them if a frame was skipped */
+        const Uint64 *rows = frame_changed(&g_gdp.frame);
+        if (rows == NULL)
+            SDL_UpdateTexture(g_gdp.texture, NULL, shown->pixels, shown->pitch);
+        else
+        {
+            int y = 0;
+            while (y < GDP64_HEIGHT)
+            {
+                int first = y;
+                while (y < GDP64_HEIGHT && ((rows[y >> 6] >> (y & 63)) & 1))
+                    y++;
+                if (y > first)
+                {
+                    SDL_Rect rect = {0, first, GDP64_WIDTH, y - first};
+                    SDL_UpdateTexture(g_gdp.texture, &rect, (Uint8 *)shown->pixels + first * shown->pitch, shown->pitch);
+                }
+                else
+                    y++;
+            }
+        }
+
+        // Scroll Screen by g_gdp.regs.scroll pixels down, the lower part (0...scroll) is wrapped to the top
+        // y-coordinates are mirrored (0,0 is top-left)
+        int scroll = frame_scroll(&g_gdp.frame);
+        if (scroll == 0)
+            SDL_RenderCopy(g_gdp.renderer, g_gdp.texture, NULL, NULL);
+        else
+        {
+            int width, height;
+            SDL_GetRendererOutputSize(g_gdp.renderer, &width, &height);
+            int split = scroll * height / GDP64_HEIGHT;
+            SDL_Rect top = {0, GDP64_HEIGHT - scroll, GDP64_WIDTH, scroll};
+            SDL_Rect topWindow = {0, 0, width, split};
+            SDL_Rect bottom = {0, 0, GDP64_WIDTH, GDP64_HEIGHT - scroll};
+            SDL_Rect bottomWindow = {0, split, width, height - split};
+            SDL_RenderCopy(g_gdp.renderer, g_gdp.texture, &top, &topWindow);
+            SDL_RenderCopy(g_gdp.renderer, g_gdp.texture, &bottom, &bottomWindow);
+        }
+        SDL_RenderPresent(g_gdp.renderer);
+    }
+}
+
+/* Show the achieved CPU speed in the window title, runs on the main thread */
+void gdp64_show_speed(double mhz, bool turbo)
+{
+    char title[80];
+
+    snprintf(title, sizeof(title), "GDP64 graphics output for NKC 68k - %.2lf MHz%s",
+             mhz, turbo ? " (Turbo)" : "");
+    SDL_SetWindowTitle(g_gdp.window, title);
+}
+
+/* Window handling of the GDP64 window, runs on the main thread */
 void gdp64_event(SDL_Event *event)
 {
    	if (event->type == SDL_MOUSEMOTION ) {
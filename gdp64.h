@@ -31,6 +31,15 @@
 #define HEADER__GDP64
 
 #include "nkc.h"
+#include "frame.h"
+#include "raster.h"
+
+#define GDP64_QUEUE 4096            /* register writes waiting for the raster thread, a power of two */
+#define GDP64_WORD  0x10            /* added to the register of a queued word write */
+
+#define GDP64_DOT_NANOS    800      /* EF9366 drawing time per dot of a vector or character matrix */
+#define GDP64_CMD_NANOS    2000     /* EF9366 time to decode a command */
+#define GDP64_CLEAR_MICROS 20000    /* clearing the screen takes one frame scan */
 
 typedef struct {
     BYTE_68K status;                /* status of the gdp */
@@ -45,6 +54,12 @@ typedef struct {
     BYTE_68K scroll;                /* HARD-SCROLL register */
 } gdp64_registers;
 
+/* Write to a register of the EF9366, queued for the raster thread */
+typedef struct {
+    BYTE_68K reg;                   /* offset from GDP_CMD, plus GDP64_WORD for word writes */
+    int value;
+} gdp64_write;
+
 typedef struct {
     int x;
     int y;
@@ -60,13 +75,29 @@ typedef struct {
     int ymag;                   /* Magnification in Y */
     gdp64_registers regs;       /* GDP-Registers      */
     gdp64_registers save_regs;  /* GDP-Registers      */
-    int actualWritePage;        /* on which page do we write at the moment? */
     int actualReadPage;         /* which page is shown at the moment? */
-    int contentChanged;         /* something new written? */
+    int shownPage;              /* read page of the last frame, -1 to show the whole page */
+    unsigned int shownScroll;   /* hard scroll of the last frame */
     bool isGuiScreen;           /* remember if GUI screen */
     SDL_Window   *window;
     SDL_Renderer *renderer;
-    SDL_Surface  *pages[5];
+    SDL_Texture  *texture;      /* read page, scaled to the window */
+    Uint32        colors[2];    /* background and foreground in the format of the frames */
+    raster        raster;       /* pages, write page and pen of the primitives */
+    gdp64_registers timed;      /* CSIZE and DELTAs as written by the CPU, for the drawing time */
+    long long     readyAt;      /* emulated cycle at which the last command is drawn */
+    frame         frame;        /* finished frames for the main thread */
+    bool          threaded;     /* the raster thread executes the register writes */
+    SDL_Thread   *thread;
+    SDL_sem      *pending;      /* counts the writes queued for the raster thread */
+    SDL_mutex    *lock;         /* guards the wait for the raster thread */
+    SDL_cond     *executed;     /* signalled after a write while the emulation thread waits */
+    SDL_atomic_t  waiting;      /* the emulation thread waits on executed */
+    Uint32        head;         /* next write queued by the emulation thread */
+    SDL_atomic_t  tail;         /* next write executed by the raster thread */
+    long long     queued;       /* writes handed to the raster thread */
+    long long     waits;        /* reads which had to wait for the raster thread */
+    gdp64_write   queue[GDP64_QUEUE];
 } gdp64;
 
 #ifdef __cplusplus
@@ -111,6 +142,11 @@ extern "C"
     void gdp64_save_regs();
     void gdp64_restore_regs();
     void gdp64_set_vsync(BYTE_68K vs);
+    void gdp64_sync();
+    void gdp64_log_stats();
+    void gdp64_present();
+    void gdp64_show();
+    void gdp64_show_speed(double mhz, bool turbo);
     void gdp64_event(SDL_Event* event);
 
 #ifdef __cplusplus
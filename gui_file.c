@@ -58,7 +58,7 @@ void file_new(nkc_directory* dir, const char * title) {
     g_file_stat.input[0] = 0x0;
 
     g_gdp.actualReadPage = 4;
-    g_gdp.actualWritePage = 4;
+    g_gdp.raster.page = 4;
     file_display(dir);
 }
 
@@ -102,7 +102,7 @@ void file_display(nkc_directory* dir) {
 
     gdp64_gui_input_string(50, 10, 0x33, 2, g_file_stat.input );
     gdp64_gui_draw_string(400, 1, 0x11, "Esc=Abbruch");
-    SDL_RaiseWindow(g_gdp.window);
+    gui_raise_gdp();
 }
 
 void file_select_event(int key) {
@@ -113,7 +113,7 @@ void file_select_event(int key) {
         g_gui.active_dialog = 0;
         gdp64_restore_regs();
         g_gdp.isGuiScreen = false;
-        SDL_RaiseWindow(g_gdp.window);
+        gui_raise_gdp();
         return;
     }    
     if( key == 0xa || key == 0xd )
@@ -212,7 +212,7 @@ void file_select_event(int key) {
                 g_gui.active_dialog = 0;
                 gdp64_restore_regs();
                 g_gdp.isGuiScreen = false;
-                SDL_RaiseWindow(g_gdp.window);
+                gui_raise_gdp();
                 return;
             }
             else
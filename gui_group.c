@@ -51,7 +51,7 @@ void group_new(nkc_array* arr, const char * title) {
     g_group_stat.input = (char *) malloc( INPUT_MAX_LENGTH );
     g_group_stat.input[0] = 0x0;
     g_gdp.actualReadPage = 4;
-    g_gdp.actualWritePage = 4;
+    g_gdp.raster.page = 4;
 
     group_display(arr);
 }
@@ -80,7 +80,7 @@ void group_display(nkc_array* arr) {
 
     gdp64_gui_input_string(50, 10, 0x33, 2, g_group_stat.input );
     gdp64_gui_draw_string(400, 1, 0x11, "Esc=Abbruch");
-    SDL_RaiseWindow(g_gdp.window);
+    gui_raise_gdp();
 }
 
 void group_select_event(int key) {
@@ -94,7 +94,7 @@ void group_select_event(int key) {
         g_gui.active_dialog = 0;
         gdp64_restore_regs();
         g_gdp.isGuiScreen = false;
-        SDL_RaiseWindow(g_gdp.window);
+        gui_raise_gdp();
         return;
     }    
 
@@ -146,7 +146,7 @@ void group_select_event(int key) {
                 g_gui.active_dialog = 0;
                 gdp64_restore_regs();
                 g_gdp.isGuiScreen = false;
-                SDL_RaiseWindow(g_gdp.window);
+                gui_raise_gdp();
                 return;
             }
             else
@@ -0,0 +1,154 @@
+/**************************************************************************************
+ *   Copyright (C) 2023,2024 by Martin Merck                                          *
+ *   martin.merck@gmx.de                                                              *
+ *                                                                                    *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy     *
+ *   of this software and associated documentation files (the "Software"), to deal    *
+ *   in the Software without restriction, including without limitation the rights     *
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell        *
+ *   copies of the Software, and to permit persons to whom the Software is            *
+ *   furnished to do so, subject to the following conditions:                         *
+ *                                                                                    *
+ *   The above copyright notice and this permission notice shall be included in all   *
+ *   copies or substantial portions of the Software.                                  *
+ *                                                                                    *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR       *
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,         * 
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE      *
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER           *
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,    *
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE    *
+ *   SOFTWARE.                                                                        *
+ *                                                                                    *
+ **************************************************************************************/
+
+/**
+ * Detection of idle loops polling a status port.
+ *
+ * Much NKC software busy waits on status ports (GDP64 ready/vsync, key
+ * strobe, FLO2 INTRQ/DRQ, SER status). If the last iteration of a loop
+ * polled the same ports with the same results, at the same instructions
+ * and with the same registers as the iteration before, without other I/O
+ * access and with the same memory writes (e.g. a return address pushed by
+ * JSR), the loop has reached a fixed point. Only a scheduled event can
+ * change the result, so the scheduler skips the emulated time up to the
+ * next event instead of executing the loop.
+ *
+ * Only ports registered with bus_set_pollable() are checked, as reading
+ * them must not change the state of the device.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "idle.h"
+#include "sched.h"
+#include "config.h"
+#include "m68k.h"
+#include "log.h"
+
+idle g_idle;
+
+extern config g_config;
+extern int g_extraSlice;
+
+void idle_init()
+{
+    g_idle.enabled = g_config.idleSkip != 0;
+    g_idle.detected = false;
+    g_idle.pos = 0;
+    g_idle.count = 0;
+    g_idle.skips = 0;
+    g_idle.skippedCycles = 0;
+}
+
+/* Any other I/O access may change a device, so the loop isn't idle */
+void idle_io_access()
+{
+    g_idle.ioAccess = true;
+}
+
+static idle_state *history(int back)
+{
+    return &g_idle.history[(g_idle.pos - 1 - back + 2 * IDLE_HISTORY) % IDLE_HISTORY];
+}
+
+static bool sameState(idle_state *a, idle_state *b)
+{
+    return a->pc == b->pc && a->address == b->address && a->value == b->value &&
+           a->writes == b->writes && !a->ioAccess && !b->ioAccess &&
+           memcmp(a->regs, b->regs, sizeof(a->regs)) == 0;
+}
+
+/* Check if the last period polls repeat the period before */
+static bool isLoop(int period)
+{
+    if (g_idle.count < 2 * period)
+        return false;
+    if (history(0)->cycle - history(period)->cycle > IDLE_MAX_LOOP_CYCLES)
+        return false;
+    for (int i = 0; i < period; i++)
+    {
+        if (!sameState(history(i), history(i + period)))
+            return false;
+    }
+    return true;
+}
+
+/* Called by the bus for each read of a pollable port */
+void idle_poll(unsigned int address, unsigned int value)
+{
+    if (!g_idle.enabled)
+        return;
+
+    idle_state *state = &g_idle.history[g_idle.pos];
+    state->cycle = sched_now() + m68k_cycles_run() + g_extraSlice;
+    state->pc = m68k_get_reg(NULL, M68K_REG_PPC);
+    state->address = address;
+    state->value = value;
+    for (int i = 0; i < 16; i++)
+        state->regs[i] = m68k_get_reg(NULL, M68K_REG_D0 + i);
+    state->regs[16] = m68k_get_reg(NULL, M68K_REG_SR);
+    state->writes = g_idle.writeHash;
+    state->ioAccess = g_idle.ioAccess;
+    g_idle.writeHash = 0;
+    g_idle.ioAccess = false;
+    g_idle.pos = (g_idle.pos + 1) % IDLE_HISTORY;
+    if (g_idle.count < IDLE_HISTORY)
+        g_idle.count++;
+
+    if (g_idle.detected)
+        return;
+    for (int period = 1; period <= IDLE_HISTORY / 2; period++)
+    {
+        if (isLoop(period))
+        {
+            // Finish the slice after this instruction
+            g_idle.detected = true;
+            m68k_modify_timeslice(-m68k_cycles_remaining());
+            return;
+        }
+    }
+}
+
+/* Check and clear if the last slice ended in an idle loop */
+bool idle_detected()
+{
+    bool detected = g_idle.detected;
+    g_idle.detected = false;
+    return detected;
+}
+
+void idle_skipped(long long cycles)
+{
+    g_idle.skips++;
+    g_idle.skippedCycles += cycles;
+    g_idle.count = 0;
+}
+
+void idle_log_stats()
+{
+    if (g_idle.skips == 0)
+        return;
+    log_info("Idle loops: %lld skipped, %lld cycles", g_idle.skips, g_idle.skippedCycles);
+    g_idle.skips = 0;
+    g_idle.skippedCycles = 0;
+}
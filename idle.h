@@ -0,0 +1,72 @@
+/**************************************************************************************
+ *   Copyright (C) 2023,2024 by Martin Merck                                          *
+ *   martin.merck@gmx.de                                                              *
+ *                                                                                    *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy     *
+ *   of this software and associated documentation files (the "Software"), to deal    *
+ *   in the Software without restriction, including without limitation the rights     *
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell        *
+ *   copies of the Software, and to permit persons to whom the Software is            *
+ *   furnished to do so, subject to the following conditions:                         *
+ *                                                                                    *
+ *   The above copyright notice and this permission notice shall be included in all   *
+ *   copies or substantial portions of the Software.                                  *
+ *                                                                                    *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR       *
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,         * 
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE      *
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER           *
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,    *
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE    *
+ *   SOFTWARE.                                                                        *
+ *                                                                                    *
+ **************************************************************************************/
+
+#ifndef HEADER__IDLE
+#define HEADER__IDLE
+#include "nkc.h"
+
+#define IDLE_NUM_REGS        17     /* D0-D7, A0-A7 and SR */
+#define IDLE_MAX_LOOP_CYCLES 1024   /* only short polling loops are skipped */
+#define IDLE_HISTORY         8      /* a loop may poll up to IDLE_HISTORY / 2 ports */
+
+/* State of the CPU when it polled a status port */
+typedef struct {
+    unsigned int pc;
+    unsigned int address;
+    unsigned int value;
+    unsigned int regs[IDLE_NUM_REGS];
+    unsigned long long writes;  /* hash of the writes since the poll before */
+    bool ioAccess;              /* other I/O access since the poll before */
+    long long cycle;
+} idle_state;
+
+typedef struct {
+    bool enabled;
+    bool detected;              /* an idle loop was found in the running slice */
+    idle_state history[IDLE_HISTORY];
+    int pos;                    /* next entry in the history */
+    int count;                  /* valid entries in the history */
+    unsigned long long writeHash; /* hash of the CPU writes since the last poll */
+    bool ioAccess;              /* other I/O access since the last poll */
+    long long skips;
+    long long skippedCycles;
+} idle;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    void idle_init();
+    void idle_poll(unsigned int address, unsigned int value);
+    void idle_io_access();
+    bool idle_detected();
+    void idle_skipped(long long cycles);
+    void idle_log_stats();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HEADER__IDLE */
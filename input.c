@@ -0,0 +1,103 @@
+/**************************************************************************************
+ *   Copyright (C) 2023,2024 by Martin Merck                                          *
+ *   martin.merck@gmx.de                                                              *
+ *                                                                                    *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy     *
+ *   of this software and associated documentation files (the "Software"), to deal    *
+ *   in the Software without restriction, including without limitation the rights     *
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell        *
+ *   copies of the Software, and to permit persons to whom the Software is            *
+ *   furnished to do so, subject to the following conditions:                         *
+ *                                                                                    *
+ *   The above copyright notice and this permission notice shall be included in all   *
+ *   copies or substantial portions of the Software.                                  *
+ *                                                                                    *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR       *
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,         * 
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE      *
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER           *
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,    *
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE    *
+ *   SOFTWARE.                                                                        *
+ *                                                                                    *
+ **************************************************************************************/
+
+/**
+ * Input events from the main thread to the emulated devices.
+ *
+ * The main thread reads the SDL events and pushes them into a single
+ * producer, single consumer ring. The emulation thread drains it when the
+ * scheduler polls the events and the devices keep the state they need
+ * (keys, joystick directions, mouse position and buttons), so an emulated
+ * port access never has to ask SDL.
+ */
+#include <stdio.h>
+#include "input.h"
+#include "log.h"
+
+input g_input;
+
+static void resetStats()
+{
+    g_input.delivered = 0;
+    g_input.latencySum = 0;
+    g_input.latencyMax = 0;
+}
+
+void input_init()
+{
+    SDL_AtomicSet(&g_input.head, 0);
+    SDL_AtomicSet(&g_input.tail, 0);
+    SDL_AtomicSet(&g_input.dropped, 0);
+    resetStats();
+}
+
+/* Queue an event for the emulation thread, runs on the main thread */
+bool input_push(const SDL_Event *event)
+{
+    int head = SDL_AtomicGet(&g_input.head);
+
+    if (head - SDL_AtomicGet(&g_input.tail) == INPUT_EVENTS)
+    {
+        SDL_AtomicAdd(&g_input.dropped, 1);
+        return false;
+    }
+    input_event *entry = &g_input.events[head & (INPUT_EVENTS - 1)];
+    entry->event = *event;
+    entry->read = SDL_GetPerformanceCounter();
+    SDL_AtomicSet(&g_input.head, head + 1);     // publishes the entry
+    return true;
+}
+
+/* Next event for the devices, runs on the emulation thread */
+bool input_pop(SDL_Event *event)
+{
+    int tail = SDL_AtomicGet(&g_input.tail);
+
+    if (tail == SDL_AtomicGet(&g_input.head))
+        return false;
+    input_event *entry = &g_input.events[tail & (INPUT_EVENTS - 1)];
+    *event = entry->event;
+
+    Uint64 latency = SDL_GetPerformanceCounter() - entry->read;
+    g_input.delivered++;
+    g_input.latencySum += latency;
+    if (latency > g_input.latencyMax)
+        g_input.latencyMax = latency;
+    SDL_AtomicSet(&g_input.tail, tail + 1);     // frees the entry
+    return true;
+}
+
+void input_log_stats()
+{
+    int dropped = SDL_AtomicSet(&g_input.dropped, 0);
+
+    if (g_input.delivered == 0 && dropped == 0)
+        return;
+
+    double ms = 1000.0 / SDL_GetPerformanceFrequency();
+    double avg = g_input.delivered ? (double)g_input.latencySum / g_input.delivered * ms : 0.0;
+    log_info("Input latency (ms): avg %.2lf max %.2lf, %lld events, %d dropped",
+             avg, g_input.latencyMax * ms, g_input.delivered, dropped);
+    resetStats();
+}
@@ -0,0 +1,61 @@
+/**************************************************************************************
+ *   Copyright (C) 2023,2024 by Martin Merck                                          *
+ *   martin.merck@gmx.de                                                              *
+ *                                                                                    *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy     *
+ *   of this software and associated documentation files (the "Software"), to deal    *
+ *   in the Software without restriction, including without limitation the rights     *
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell        *
+ *   copies of the Software, and to permit persons to whom the Software is            *
+ *   furnished to do so, subject to the following conditions:                         *
+ *                                                                                    *
+ *   The above copyright notice and this permission notice shall be included in all   *
+ *   copies or substantial portions of the Software.                                  *
+ *                                                                                    *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR       *
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,         * 
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE      *
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER           *
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,    *
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE    *
+ *   SOFTWARE.                                                                        *
+ *                                                                                    *
+ **************************************************************************************/
+
+#ifndef HEADER__INPUT
+#define HEADER__INPUT
+#include "nkc.h"
+
+#define INPUT_EVENTS 256            /* size of the ring, a power of two */
+
+/* Input event read by the main thread */
+typedef struct {
+    SDL_Event event;
+    Uint64 read;                    /* performance counter when it was read */
+} input_event;
+
+typedef struct {
+    input_event events[INPUT_EVENTS];
+    SDL_atomic_t head;              /* next entry written by the main thread */
+    SDL_atomic_t tail;              /* next entry read by the emulation thread */
+    SDL_atomic_t dropped;           /* events lost as the ring was full */
+    long long delivered;
+    Uint64 latencySum;              /* performance counter ticks from reading to delivery */
+    Uint64 latencyMax;
+} input;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    void input_init();
+    bool input_push(const SDL_Event *event);
+    bool input_pop(SDL_Event *event);
+    void input_log_stats();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HEADER__INPUT */
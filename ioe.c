@@ -33,6 +33,8 @@
 #include <stdbool.h>
 #include <sys/time.h>
 #include "ioe.h"
+#include "68k-nkcemu.h"
+#include "bus.h"
 #include "log.h"
 
 ioe g_ioe;
@@ -244,6 +246,18 @@ void ioe_event(SDL_Event* event)
     }
 }
 
+/* Register the ports of the IOE card */
+void ioe_init()
+{
+    bus_register(IOE_PORT_A, ioe_p30_in, ioe_p30_out);
+    bus_register(IOE_PORT_B, ioe_p31_in, ioe_p31_out);
+}
+
+/*
+ * Called on the emulation thread by a reset and the joystick dialogs. All
+ * SDL joystick functions take SDL_LockJoysticks(), so they may run while
+ * the main thread pumps the joystick events.
+ */
 void ioe_reset( const char *joyA, const char *joyB )
 {
 	g_ioe.porta_in = 0;
@@ -59,6 +59,7 @@ extern "C"
     BYTE_68K ioe_get_p30();
     BYTE_68K ioe_get_p31();
     void ioe_reset( const char *joyA, const char *joyB );
+    void ioe_init();
     void ioe_event(SDL_Event* event);
 
 #ifdef __cplusplus
@@ -0,0 +1,96 @@
+/**************************************************************************************
+ *   Copyright (C) 2023,2024 by Martin Merck                                          *
+ *   martin.merck@gmx.de                                                              *
+ *                                                                                    *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy     *
+ *   of this software and associated documentation files (the "Software"), to deal    *
+ *   in the Software without restriction, including without limitation the rights     *
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell        *
+ *   copies of the Software, and to permit persons to whom the Software is            *
+ *   furnished to do so, subject to the following conditions:                         *
+ *                                                                                    *
+ *   The above copyright notice and this permission notice shall be included in all   *
+ *   copies or substantial portions of the Software.                                  *
+ *                                                                                    *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR       *
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,         * 
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE      *
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER           *
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,    *
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE    *
+ *   SOFTWARE.                                                                        *
+ *                                                                                    *
+ **************************************************************************************/
+
+/**
+ * Interrupt lines of the CPU.
+ *
+ * Devices raise and drop the IPL level through irq_set(). The CPU calls
+ * irq_ack() when it services the interrupt, which clears the level like
+ * the autovector mode of Musashi did and measures the latency from
+ * raising the level, e.g. a masked VSYNC interrupt or the end of the
+ * running slice.
+ */
+#include <stdio.h>
+#include "irq.h"
+#include "sched.h"
+#include "m68k.h"
+#include "log.h"
+
+irq g_irq;
+
+static void resetStats()
+{
+    g_irq.samples = 0;
+    g_irq.latencySum = 0;
+    g_irq.latencyMax = 0;
+    g_irq.missed = 0;
+}
+
+void irq_init()
+{
+    g_irq.level = 0;
+    g_irq.raised = -1;
+    resetStats();
+}
+
+void irq_set(int level)
+{
+    if (level > g_irq.level)
+        g_irq.raised = sched_current();
+    else if (level == 0 && g_irq.raised >= 0)
+    {
+        g_irq.missed++;
+        g_irq.raised = -1;
+    }
+    g_irq.level = level;
+    m68k_set_irq(level);
+}
+
+/* Called by the CPU when it takes the interrupt, see m68kconf.h */
+int irq_ack(int level)
+{
+    if (g_irq.raised >= 0)
+    {
+        long long latency = sched_current() - g_irq.raised;
+        g_irq.samples++;
+        g_irq.latencySum += latency;
+        if (latency > g_irq.latencyMax)
+            g_irq.latencyMax = latency;
+        g_irq.raised = -1;
+    }
+    g_irq.level = 0;
+    m68k_set_irq(0);
+    return M68K_INT_ACK_AUTOVECTOR;
+}
+
+void irq_log_stats()
+{
+    if (g_irq.samples == 0 && g_irq.missed == 0)
+        return;
+
+    double avg = g_irq.samples ? (double)g_irq.latencySum / g_irq.samples : 0.0;
+    log_info("IRQ latency (cycles): avg %.1lf max %lld, %lld serviced, %lld missed",
+             avg, g_irq.latencyMax, g_irq.samples, g_irq.missed);
+    resetStats();
+}
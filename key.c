@@ -35,6 +35,8 @@
 #include <stdbool.h>
 #include "nkc.h"
 #include "key.h"
+#include "68k-nkcemu.h"
+#include "bus.h"
 #include "config.h"
 #include "util.h"
 #include "log.h"
@@ -52,7 +54,7 @@ void clipboard_reset()
         g_key.clipboardLength = 0;
         g_key.clipboardOffset = 0;
     }
-
+    bus_set_pollable(KEY_DATA, true);
 }
 
 void set_key(BYTE_68K key)
@@ -123,25 +125,33 @@ void key_event(SDL_Event* event)
 	}
     if (event->type == SDL_KEYDOWN)
     {
-		if (event->key.keysym.sym == SDLK_INSERT)
-		{
-			if (SDL_HasClipboardText() == SDL_TRUE)
-			{
-				if (g_key.clipboardText != NULL)
-				{
-					SDL_free(g_key.clipboardText);
-				}
-				g_key.clipboardText = SDL_GetClipboardText();
-				g_key.clipboardLength = strlen(g_key.clipboardText);
-				g_key.clipboardOffset = 0;
-			}
-		}
-
         g_key.keyReg68 = nkc_get_ascii(event->key);
 	}
 	return;
 }
 
+/*
+ * Paste text into the keyboard. The main thread reads the clipboard
+ * (Insert key or paste button) and passes the text over with the events.
+ */
+void key_paste(char *text)
+{
+    clipboard_reset();
+    g_key.clipboardText = text;
+    g_key.clipboardLength = strlen(text);
+    g_key.clipboardOffset = 0;
+    // Reading the data port moves through the text, so it isn't idle until the paste is done
+    bus_set_pollable(KEY_DATA, false);
+}
+
+/* Register the ports of the KEY card */
+void key_init()
+{
+    bus_register(KEY_DATA, key_p68_in, key_p68_out);
+    bus_set_pollable(KEY_DATA, true);
+    bus_register(KEY_DIP, key_p69_in, key_p69_out);
+}
+
 void key_reset()
 {
 	g_key.keyReg68 = 0x80; /* reset status to no key pressed */
@@ -54,7 +54,9 @@ extern "C"
     BYTE_68K key_p69_in();
     void key_p69_out(BYTE_68K data);
     void key_reset();
+    void key_init();
     void key_event(SDL_Event *event);
+    void key_paste(char *text);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,276 @@
+/**************************************************************************************
+ *   Copyright (C) 2023,2024 by Martin Merck                                          *
+ *   martin.merck@gmx.de                                                              *
+ *                                                                                    *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy     *
+ *   of this software and associated documentation files (the "Software"), to deal    *
+ *   in the Software without restriction, including without limitation the rights     *
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell        *
+ *   copies of the Software, and to permit persons to whom the Software is            *
+ *   furnished to do so, subject to the following conditions:                         *
+ *                                                                                    *
+ *   The above copyright notice and this permission notice shall be included in all   *
+ *   copies or substantial portions of the Software.                                  *
+ *                                                                                    *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR       *
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,         * 
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE      *
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER           *
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,    *
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE    *
+ *   SOFTWARE.                                                                        *
+ *                                                                                    *
+ **************************************************************************************/
+
+/**
+ * Lockstep verification of the trace cache and the compiled traces.
+ *
+ * Before the CPU runs a cached trace, its context is saved and all writes are
+ * logged. Afterwards the CPU goes back to the saved context and the plain
+ * interpreter runs the same cycles again, while the memory is served from a
+ * shadow copy of the RAM as it was before the trace. Registers, SR, cycles,
+ * wait states and the logged writes of both runs have to be the same. The
+ * first difference is reported and stops the emulator.
+ *
+ * Devices can not run twice, so traces which access a device are executed
+ * but not compared.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lockstep.h"
+#include "68k-nkcemu.h"
+#include "mem.h"
+#include "m68k.h"
+#include "log.h"
+
+lockstep g_lockstep;
+
+extern mem g_mem;
+extern unsigned char g_ram[];
+extern int g_extraSlice;
+
+void exit_error(char *fmt, ...);
+
+static const struct {
+    const char *name;
+    m68k_register_t reg;
+} regs[] = {
+    { "D0", M68K_REG_D0 }, { "D1", M68K_REG_D1 }, { "D2", M68K_REG_D2 }, { "D3", M68K_REG_D3 },
+    { "D4", M68K_REG_D4 }, { "D5", M68K_REG_D5 }, { "D6", M68K_REG_D6 }, { "D7", M68K_REG_D7 },
+    { "A0", M68K_REG_A0 }, { "A1", M68K_REG_A1 }, { "A2", M68K_REG_A2 }, { "A3", M68K_REG_A3 },
+    { "A4", M68K_REG_A4 }, { "A5", M68K_REG_A5 }, { "A6", M68K_REG_A6 }, { "A7", M68K_REG_A7 },
+    { "PC", M68K_REG_PC }, { "SR", M68K_REG_SR }, { "USP", M68K_REG_USP }, { "ISP", M68K_REG_ISP }
+};
+
+void lockstep_init()
+{
+    g_lockstep.shadow = malloc(MAX_RAM + 1);
+    if (g_lockstep.shadow == NULL)
+    {
+        log_error("Lockstep: no memory for the shadow RAM");
+        return;
+    }
+    memcpy(g_lockstep.shadow, g_ram, MAX_RAM + 1);
+    g_lockstep.mode = LOCKSTEP_MIRROR;
+    g_lockstep.verified = 0;
+    g_lockstep.skipped = 0;
+    m68k_set_lockstep(1);
+    log_info("Lockstep verification of the trace cache enabled");
+}
+
+void lockstep_begin()
+{
+    g_lockstep.fast.count = 0;
+    g_lockstep.fast.io = false;
+    g_lockstep.extraSlice = g_extraSlice;
+    g_lockstep.mode = LOCKSTEP_FAST;
+}
+
+/* Switch to the shadow memory for the reference run, if the trace can be compared */
+int lockstep_reference()
+{
+    if (g_lockstep.fast.io)
+        return 0;
+    g_lockstep.reference.count = 0;
+    g_lockstep.reference.io = false;
+    g_lockstep.fastExtra = g_extraSlice;
+    g_extraSlice = g_lockstep.extraSlice;
+    g_lockstep.mode = LOCKSTEP_REFERENCE;
+    return 1;
+}
+
+static bool sameWrites(lockstep_log *a, lockstep_log *b)
+{
+    if (a->count != b->count)
+        return false;
+    for (int i = 0; i < a->count; i++)
+    {
+        if (a->entries[i].address != b->entries[i].address || a->entries[i].size != b->entries[i].size ||
+            a->entries[i].value != b->entries[i].value)
+            return false;
+    }
+    return true;
+}
+
+static void logWrites(const char *name, lockstep_log *log)
+{
+    for (int i = 0; i < log->count; i++)
+        log_error("  %s write %06x.%c = %08x", name, log->entries[i].address,
+                  log->entries[i].size == 1 ? 'b' : log->entries[i].size == 2 ? 'w' : 'l', log->entries[i].value);
+}
+
+static void report(void *fast, void *reference, int fastCycles, int referenceCycles)
+{
+    char text[100];
+
+    m68k_disassemble(text, m68k_get_reg(reference, M68K_REG_PPC), M68K_CPU_TYPE_68000);
+    log_error("Lockstep: trace and interpreter differ after %06x %s", m68k_get_reg(reference, M68K_REG_PPC), text);
+    for (int i = 0; i < sizeof(regs) / sizeof(regs[0]); i++)
+    {
+        unsigned int a = m68k_get_reg(fast, regs[i].reg);
+        unsigned int b = m68k_get_reg(reference, regs[i].reg);
+        if (a != b)
+            log_error("  %-3s trace=%08x interpreter=%08x", regs[i].name, a, b);
+    }
+    if (fastCycles != referenceCycles)
+        log_error("  cycles trace=%d interpreter=%d", fastCycles, referenceCycles);
+    if (g_lockstep.fastExtra != g_extraSlice)
+        log_error("  wait states trace=%d interpreter=%d", g_lockstep.fastExtra - g_lockstep.extraSlice,
+                  g_extraSlice - g_lockstep.extraSlice);
+    if (!sameWrites(&g_lockstep.fast, &g_lockstep.reference) || g_lockstep.reference.io)
+    {
+        logWrites("trace", &g_lockstep.fast);
+        logWrites("interpreter", &g_lockstep.reference);
+        if (g_lockstep.reference.io)
+            log_error("  interpreter accessed a device");
+    }
+}
+
+void lockstep_end(void *fast, void *reference, int fastCycles, int referenceCycles)
+{
+    bool same = true;
+
+    if (fast == NULL)
+        g_lockstep.skipped++;
+    else
+    {
+        for (int i = 0; i < sizeof(regs) / sizeof(regs[0]) && same; i++)
+            same = m68k_get_reg(fast, regs[i].reg) == m68k_get_reg(reference, regs[i].reg);
+        same = same && fastCycles == referenceCycles && g_lockstep.fastExtra == g_extraSlice &&
+               !g_lockstep.reference.io && sameWrites(&g_lockstep.fast, &g_lockstep.reference);
+        if (!same)
+        {
+            report(fast, reference, fastCycles, referenceCycles);
+            exit_error("Lockstep verification failed");
+        }
+        g_lockstep.verified++;
+        g_extraSlice = g_lockstep.fastExtra;
+    }
+
+    // The shadow follows the RAM again
+    for (int i = 0; i < g_lockstep.fast.count; i++)
+    {
+        unsigned int address = g_lockstep.fast.entries[i].address;
+        for (int j = 0; j < g_lockstep.fast.entries[i].size; j++)
+            if (address + j <= MAX_RAM)
+                g_lockstep.shadow[address + j] = g_ram[address + j];
+    }
+    g_lockstep.mode = LOCKSTEP_MIRROR;
+}
+
+static void logWrite(lockstep_log *log, unsigned int address, int size, unsigned int value)
+{
+    if (log->count == LOCKSTEP_MAX_WRITES)
+    {
+        log->io = true;
+        return;
+    }
+    log->entries[log->count].address = address;
+    log->entries[log->count].size = size;
+    log->entries[log->count].value = value;
+    log->count++;
+}
+
+/* Check an access of the trace, devices can not be compared */
+void lockstep_access(unsigned int address, int size)
+{
+    if (!mem_isPlain(address) || !mem_isPlain(address + size - 1))
+        g_lockstep.fast.io = true;
+}
+
+static unsigned int shadowByte(unsigned int address)
+{
+    BYTE_68K *page = g_mem.read[MEM_PAGE(address)];
+
+    if (page == NULL)
+    {
+        g_lockstep.reference.io = true;
+        return 0xFF;
+    }
+    if (page >= g_ram && page <= g_ram + MAX_RAM)
+        return g_lockstep.shadow[page - g_ram + (address & MEM_PAGE_MASK)];
+    return page[address & MEM_PAGE_MASK];
+}
+
+/* Read of the interpreter from the shadow memory */
+unsigned int lockstep_read(unsigned int address, int size)
+{
+    unsigned int value = 0;
+
+    for (int i = 0; i < size; i++)
+        value = (value << 8) | shadowByte(address + i);
+    return value;
+}
+
+/* Write of the interpreter to the shadow memory */
+void lockstep_write_reference(unsigned int address, int size, unsigned int value)
+{
+    logWrite(&g_lockstep.reference, address, size, value);
+    for (int i = 0; i < size; i++)
+    {
+        unsigned int a = address + i;
+        if (!mem_isPlain(a))
+            g_lockstep.reference.io = true;
+        else if (mem_isRam(a) && a <= MAX_RAM)
+            g_lockstep.shadow[a] = (value >> (8 * (size - 1 - i))) & 0xff;
+    }
+}
+
+/* Called after each write of the CPU outside the interpreter run */
+void lockstep_written(unsigned int address, int size, unsigned int value)
+{
+    if (g_lockstep.mode == LOCKSTEP_FAST)
+    {
+        logWrite(&g_lockstep.fast, address, size, value);
+        lockstep_access(address, size);
+        return;
+    }
+    for (int i = 0; i < size; i++)
+        if (address + i <= MAX_RAM)
+            g_lockstep.shadow[address + i] = g_ram[address + i];
+}
+
+/* Called after the CPU wrote count items at once to plain RAM */
+void lockstep_block_written(unsigned int address, int size, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; i++)
+    {
+        unsigned int item = address + i * size;
+        unsigned int value = 0;
+
+        for (int j = 0; j < size; j++)
+            value = (value << 8) | g_mem.read[MEM_PAGE(item + j)][(item + j) & MEM_PAGE_MASK];
+        lockstep_written(item, size, value);
+    }
+}
+
+void lockstep_log_stats()
+{
+    if (g_lockstep.mode == LOCKSTEP_OFF)
+        return;
+    log_info("Lockstep: %lld traces verified, %lld with device access not compared", g_lockstep.verified,
+             g_lockstep.skipped);
+    g_lockstep.verified = 0;
+    g_lockstep.skipped = 0;
+}
@@ -0,0 +1,80 @@
+/**************************************************************************************
+ *   Copyright (C) 2023,2024 by Martin Merck                                          *
+ *   martin.merck@gmx.de                                                              *
+ *                                                                                    *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy     *
+ *   of this software and associated documentation files (the "Software"), to deal    *
+ *   in the Software without restriction, including without limitation the rights     *
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell        *
+ *   copies of the Software, and to permit persons to whom the Software is            *
+ *   furnished to do so, subject to the following conditions:                         *
+ *                                                                                    *
+ *   The above copyright notice and this permission notice shall be included in all   *
+ *   copies or substantial portions of the Software.                                  *
+ *                                                                                    *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR       *
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,         * 
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE      *
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER           *
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,    *
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE    *
+ *   SOFTWARE.                                                                        *
+ *                                                                                    *
+ **************************************************************************************/
+
+#ifndef HEADER__LOCKSTEP
+#define HEADER__LOCKSTEP
+#include <stdbool.h>
+
+#define LOCKSTEP_MAX_WRITES 512    /* writes of one trace, longer traces are not compared */
+
+/* Modes of the memory access */
+#define LOCKSTEP_OFF       0       /* no verification */
+#define LOCKSTEP_MIRROR    1       /* plain execution, writes are mirrored to the shadow memory */
+#define LOCKSTEP_FAST      2       /* a trace runs, writes are logged */
+#define LOCKSTEP_REFERENCE 3       /* the interpreter runs on the shadow memory */
+
+typedef struct {
+    unsigned int address;
+    int size;
+    unsigned int value;
+} lockstep_write;
+
+typedef struct {
+    lockstep_write entries[LOCKSTEP_MAX_WRITES];
+    int count;
+    bool io;                    /* a device was accessed or the log overflowed */
+} lockstep_log;
+
+typedef struct {
+    int mode;
+    unsigned char *shadow;      /* RAM as it was before the running trace */
+    lockstep_log fast;
+    lockstep_log reference;
+    int extraSlice;             /* g_extraSlice before the trace */
+    int fastExtra;              /* g_extraSlice after the trace */
+    long long verified;
+    long long skipped;
+} lockstep;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    void lockstep_init();
+    void lockstep_begin();
+    int lockstep_reference();
+    void lockstep_end(void *fast, void *reference, int fastCycles, int referenceCycles);
+    void lockstep_access(unsigned int address, int size);
+    unsigned int lockstep_read(unsigned int address, int size);
+    void lockstep_write_reference(unsigned int address, int size, unsigned int value);
+    void lockstep_written(unsigned int address, int size, unsigned int value);
+    void lockstep_block_written(unsigned int address, int size, unsigned int count);
+    void lockstep_log_stats();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HEADER__LOCKSTEP */
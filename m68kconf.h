@@ -68,6 +68,29 @@
 #define M68K_EMULATE_030            OPT_OFF
 #define M68K_EMULATE_040            OPT_OFF
 
+/* If ON, the core is built for the plain 68000 alone.  The CPU type, its
+ * cycle tables and the address and SR masks become constants instead of
+ * fields read on every access and m68k_set_cpu_type() ignores other types.
+ * Needs the variants above OFF.  m68kops.c may then be generated with
+ * "m68kmake <dir> m68k_in.c 000", which leaves out the handlers of the
+ * instructions the 68000 does not have.
+ */
+#define M68K_68000_ONLY             OPT_ON
+
+/* If ON, opcodes are dispatched through a 16-bit index per opcode into the
+ * table of distinct handler and cycle pairs that m68kmake generates for the
+ * CPU it was given, instead of a 64K entry jump table and 64K cycle tables.
+ * Needs M68K_68000_ONLY.
+ */
+#define M68K_COMPACT_DISPATCH       OPT_ON
+
+/* If ON, the move, logic, add, sub and cmp instructions only record their
+ * operands and result, and N, Z, V and C are computed from them when they are
+ * read, e.g. by a Bcc, Scc, MOVE from SR, an exception or m68k_get_reg().
+ * X is still set right away.
+ */
+#define M68K_LAZY_FLAGS             OPT_OFF
+
 
 /* If ON, the CPU will call m68k_read_immediate_xx() for immediate addressing
  * and m68k_read_pcrelative_xx() for PC-relative addressing.
@@ -87,8 +110,8 @@
  * If off, all interrupts will be autovectored and all interrupt requests will
  * auto-clear when the interrupt is serviced.
  */
-#define M68K_EMULATE_INT_ACK        OPT_OFF
-#define M68K_INT_ACK_CALLBACK(A)    your_int_ack_handler_function(A)
+#define M68K_EMULATE_INT_ACK        OPT_SPECIFY_HANDLER
+#define M68K_INT_ACK_CALLBACK(A)    irq_ack(A)
 
 
 /* If ON, CPU will call the breakpoint acknowledge callback when it encounters
@@ -159,8 +182,57 @@
 /* If ON, CPU will call the instruction hook callback before every
  * instruction.
  */
-#define M68K_INSTRUCTION_HOOK       OPT_SPECIFY_HANDLER
-#define M68K_INSTRUCTION_CALLBACK(pc) cpu_instr_callback(pc)
+#define M68K_INSTRUCTION_HOOK       OPT_OFF
+#define M68K_INSTRUCTION_CALLBACK(pc) your_instruction_hook_function(pc)
+
+
+/* If set to OPT_SPECIFY_HANDLER, the CPU records the decoded instructions run
+ * from a PC as a trace and replays it without fetching and decoding the
+ * opcodes again.  Traces do not cross a page of 1 << M68K_BLOCK_PAGE_BITS
+ * bytes.  The page callback is asked before a page is cached and returns a
+ * host pointer to its memory or NULL if it can not be cached; the host must
+ * call m68k_block_invalidate() when the page is written.  The fetch callback
+ * gets the number of words a replayed instruction read from the page.
+ */
+#define M68K_BLOCK_CACHE            OPT_SPECIFY_HANDLER
+#define M68K_BLOCK_PAGE_BITS        12
+#define M68K_BLOCK_CACHE_CALLBACK(A) cpu_block_page(A)
+#define M68K_BLOCK_FETCH_CALLBACK(N) cpu_fetch_skipped(N)
+
+/* If ON, traces replayed often enough are compiled to x86-64 host code, see
+ * m68k_set_jit_threshold().  Needs M68K_BLOCK_CACHE and is ignored on other
+ * hosts.
+ */
+#define M68K_JIT                    OPT_ON
+
+/* If ON, pairs of instructions listed in m68k_in.c are replayed through one
+ * fused handler generated by m68kmake.  Needs M68K_BLOCK_CACHE.
+ */
+#define M68K_FUSION                 OPT_ON
+
+/* If set to OPT_SPECIFY_HANDLER, traces made of a move (An)+,(Am)+, a move
+ * Dn,(Am)+ or a clr (Am)+ followed by a dbf back to it run their remaining
+ * iterations through one call of the copy or fill callback.  The callbacks
+ * return 0 if the host can not do them at once (e.g. I/O or overlapping
+ * ranges), then the loop runs as usual.  The copy callback stores the last
+ * item copied in LAST for the flags.
+ */
+#define M68K_BLOCK_IDIOM            OPT_SPECIFY_HANDLER
+#define M68K_BLOCK_COPY_CALLBACK(D, S, SIZE, N, LAST) cpu_block_copy(D, S, SIZE, N, LAST)
+#define M68K_BLOCK_FILL_CALLBACK(D, V, SIZE, N) cpu_block_fill(D, V, SIZE, N)
+
+/* If set to OPT_SPECIFY_HANDLER, m68k_set_lockstep() can turn on the
+ * verification of the trace cache and the compiled traces.  The CPU calls the
+ * begin callback before it runs a trace and the reference callback after it.
+ * If that returns nonzero, the host serves all further accesses from a copy
+ * of the memory as it was before the trace, the interpreter runs the same
+ * cycles from the same state and the end callback gets both contexts and the
+ * cycles they used.  Otherwise the end callback gets NULL contexts.
+ */
+#define M68K_LOCKSTEP               OPT_SPECIFY_HANDLER
+#define M68K_LOCKSTEP_BEGIN_CALLBACK() lockstep_begin()
+#define M68K_LOCKSTEP_REFERENCE_CALLBACK() lockstep_reference()
+#define M68K_LOCKSTEP_END_CALLBACK(F, R, FC, RC) lockstep_end(F, R, FC, RC)
 
 
 /* If ON, the CPU will emulate the 4-byte prefetch queue of a real 68000 */
@@ -174,6 +246,13 @@
 #define M68K_EMULATE_ADDRESS_ERROR  OPT_OFF
 
 
+/* If ON, the CPU saves D0-A7 before every instruction, so that
+ * m68k_pulse_bus_error() can undo the instruction and take the exception.
+ * If OFF, m68k_pulse_bus_error() does nothing.
+ */
+#define M68K_EMULATE_BUS_ERROR      OPT_OFF
+
+
 /* Turn ON to enable logging of illegal instruction calls.
  * M68K_LOG_FILEHANDLE must be #defined to a stdio file stream.
  * Turn on M68K_LOG_1010_1111 to log all 1010 and 1111 calls.
@@ -200,6 +279,8 @@
 
 
 #include "68k-nkcemu.h"
+#include "lockstep.h"
+#include "irq.h"
 
 #define m68k_read_memory_8(A) cpu_read_byte(A)
 #define m68k_read_memory_16(A) cpu_read_word(A)
@@ -0,0 +1,405 @@
+/**************************************************************************************
+ *   Copyright (C) 2023,2024 by Martin Merck                                          *
+ *   martin.merck@gmx.de                                                              *
+ *                                                                                    *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy     *
+ *   of this software and associated documentation files (the "Software"), to deal    *
+ *   in the Software without restriction, including without limitation the rights     *
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell        *
+ *   copies of the Software, and to permit persons to whom the Software is            *
+ *   furnished to do so, subject to the following conditions:                         *
+ *                                                                                    *
+ *   The above copyright notice and this permission notice shall be included in all   *
+ *   copies or substantial portions of the Software.                                  *
+ *                                                                                    *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR       *
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,         * 
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE      *
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER           *
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,    *
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE    *
+ *   SOFTWARE.                                                                        *
+ *                                                                                    *
+ **************************************************************************************/
+
+/**
+ * Page table based memory map of the NKC.
+ *
+ * Each 4 KB page of the address space either points straight into host memory
+ * (RAM, standard ROMs in g_ram, the Bankboot ROM in g_rom) or to a handler.
+ * The map has to be rebuilt whenever the layout changes, i.e. when Bankboot
+ * is enabled/disabled or the COL256 memory window is switched on/off.
+ */
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include "mem.h"
+#include "68k-nkcemu.h"
+#include "bankboot.h"
+#include "col256.h"
+#include "config.h"
+#include "log.h"
+#include "m68k.h"
+
+/* Read/write macros */
+#define READ_WORD_68K(BASE, ADDR) (((BASE)[ADDR] << 8) | \
+                               (BASE)[(ADDR) + 1])
+#define READ_LONG_68K(BASE, ADDR) (((BASE)[ADDR] << 24) |       \
+                               ((BASE)[(ADDR) + 1] << 16) | \
+                               ((BASE)[(ADDR) + 2] << 8) |  \
+                               (BASE)[(ADDR) + 3])
+
+#define WRITE_WORD_68K(BASE, ADDR, VAL)     \
+    (BASE)[ADDR] = ((VAL) >> 8) & 0xff; \
+    (BASE)[(ADDR) + 1] = (VAL) & 0xff
+#define WRITE_LONG_68K(BASE, ADDR, VAL)            \
+    (BASE)[ADDR] = ((VAL) >> 24) & 0xff;       \
+    (BASE)[(ADDR) + 1] = ((VAL) >> 16) & 0xff; \
+    (BASE)[(ADDR) + 2] = ((VAL) >> 8) & 0xff;  \
+    (BASE)[(ADDR) + 3] = (VAL) & 0xff
+
+#define COL_SIZE 0x4000
+
+mem g_mem;
+
+extern config g_config;
+extern bankboot g_bb;
+extern col256 g_col;
+extern unsigned char g_rom[];
+extern unsigned char g_ram[];
+extern int g_start_gp_ram;
+
+static BYTE_68K open_bus[MEM_PAGE_SIZE];    /* Unmapped pages read as 0xFF */
+static BYTE_68K sink[MEM_PAGE_SIZE];        /* Writes to ROM or unmapped pages end here */
+static const mem_handler *code_saved[MEM_NUM_PAGES]; /* Handler of a page before it held cached code */
+
+static void code_release(unsigned int address);
+
+/* RAM is hard coded here from 0-512kB, and 32kB after the system EPROMs.                 */
+/* For COL256 16kB memory is mapped to RAM from 0xCC000 to 0xD0000 or 0xEC000 to 0xF0000. */
+bool mem_isRam(unsigned int address)
+{
+    if (g_bb.bb_enabled)
+        if (address < 0x8000)
+            return false;
+    if (address >= 0x0 && address < 0x80000) // Ram für CP/M (512 K)
+        return true;
+    if ((address >= g_config.col256RAMAddr) && (address < g_config.col256RAMAddr + COL_SIZE - 1) && g_col.col_active) // Ram for Col256
+        return true;
+    if ((address >= g_start_gp_ram) && (address < g_start_gp_ram + 0x8000)) // Ram für das Grundprogramm
+        return true;
+    return false;
+}
+
+static bool isCol(unsigned int address)
+{
+    return g_col.col_active && (address >= g_config.col256RAMAddr) && (address < g_config.col256RAMAddr + COL_SIZE);
+}
+
+/*
+ * Handler for pages which contain the COL256 window or are only partly RAM.
+ * It keeps the original per address decoding of the emulator.
+ */
+static unsigned int mixed_read_byte(unsigned int address)
+{
+    if (isCol(address))
+        return col_getPixel(address);
+    if (g_bb.bb_enabled && address <= MAX_BBROM)
+        return g_rom[address];
+    if (address <= MAX_RAM)
+        return g_ram[address];
+    return 0xFF;
+}
+
+static unsigned int mixed_read_word(unsigned int address)
+{
+    if (isCol(address))
+        return col_getWord(address);
+    if (g_bb.bb_enabled && address <= MAX_BBROM)
+        return READ_WORD_68K(g_rom, address);
+    if (address <= MAX_RAM)
+        return READ_WORD_68K(g_ram, address);
+    return 0xFFFF;
+}
+
+static unsigned int mixed_read_long(unsigned int address)
+{
+    if (isCol(address))
+        return col_getLong(address);
+    if (g_bb.bb_enabled && address <= MAX_BBROM)
+        return READ_LONG_68K(g_rom, address);
+    if (address <= MAX_RAM)
+        return READ_LONG_68K(g_ram, address);
+    return 0xFFFFFFFF;
+}
+
+static void mixed_write_byte(unsigned int address, unsigned int value)
+{
+    if (isCol(address))
+        col_setPixel(address, value & 0xff);
+    if (mem_isRam(address))
+        g_ram[address] = value & 0xff;
+}
+
+static void mixed_write_word(unsigned int address, unsigned int value)
+{
+    code_release(address + 1);
+    if (mem_isRam(address))
+    {
+        if (isCol(address))
+            col_setWord(address, value);
+        WRITE_WORD_68K(g_ram, address, value);
+    }
+}
+
+static void mixed_write_long(unsigned int address, unsigned int value)
+{
+    code_release(address + 3);
+    if (mem_isRam(address))
+    {
+        if (isCol(address))
+            col_setLong(address, value);
+        else
+            WRITE_LONG_68K(g_ram, address, value);
+    }
+}
+
+static const mem_handler mixed_handler = {
+    mixed_read_byte, mixed_read_word, mixed_read_long,
+    mixed_write_byte, mixed_write_word, mixed_write_long
+};
+
+/*
+ * RAM pages the CPU has cached instructions from are write protected by
+ * clearing their write pointer. The first write drops the cached code of the
+ * page and restores the plain mapping, a word or long crossing into the next
+ * page releases that one as well.
+ */
+static void code_write_byte(unsigned int address, unsigned int value)
+{
+    code_release(address);
+    g_mem.handler[MEM_PAGE(address)]->write_byte(address, value);
+}
+
+static void code_write_word(unsigned int address, unsigned int value)
+{
+    code_release(address);
+    code_release(address + 1);
+    g_mem.handler[MEM_PAGE(address)]->write_word(address, value);
+}
+
+static void code_write_long(unsigned int address, unsigned int value)
+{
+    code_release(address);
+    code_release(address + 3);
+    g_mem.handler[MEM_PAGE(address)]->write_long(address, value);
+}
+
+static const mem_handler code_handler = {
+    mixed_read_byte, mixed_read_word, mixed_read_long,
+    code_write_byte, code_write_word, code_write_long
+};
+
+static void code_release(unsigned int address)
+{
+    int page = MEM_PAGE(address);
+
+    if (g_mem.handler[page] != &code_handler)
+        return;
+    g_mem.write[page] = g_mem.read[page];
+    g_mem.handler[page] = code_saved[page];
+    m68k_block_invalidate(address);
+}
+
+/*
+ * Called by the CPU before it caches instructions of a page, returns the memory
+ * the page is read from. Pages decoded by a handler can not be cached,
+ * writable RAM pages get write protected.
+ */
+BYTE_68K *mem_protect_code(unsigned int address)
+{
+    int page = MEM_PAGE(address);
+
+    if (g_mem.read[page] == NULL)
+        return NULL;
+    if (g_mem.handler[page] == &code_handler)
+        return g_mem.read[page];
+    if (g_mem.write[page] == NULL)
+        return NULL;
+    if (g_mem.write[page] == g_mem.read[page])
+    {
+        code_saved[page] = g_mem.handler[page];
+        g_mem.handler[page] = &code_handler;
+        g_mem.write[page] = NULL;
+    }
+    return g_mem.read[page];
+}
+
+/* True if the address is read from host memory and writes have no side effect on a device */
+bool mem_isPlain(unsigned int address)
+{
+    int page = MEM_PAGE(address);
+
+    return g_mem.read[page] != NULL && (g_mem.write[page] != NULL || g_mem.handler[page] == &code_handler);
+}
+
+/* True if all pages of the range are host memory, for writes also writable RAM */
+static bool isHostRange(unsigned int address, unsigned int length, bool write)
+{
+    if (length == 0)
+        return true;
+    if (address > MEM_ADDRESS_MASK || length > MEM_ADDRESS_MASK + 1 - address)
+        return false;
+    for (unsigned int page = MEM_PAGE(address); page <= MEM_PAGE(address + length - 1); page++)
+    {
+        if (g_mem.read[page] == NULL || (write && g_mem.write[page] != g_mem.read[page]))
+            return false;
+    }
+    return true;
+}
+
+/*
+ * Copy length bytes in ascending order like a copy loop of the CPU. Returns
+ * false without copying if a range is not host memory or the destination
+ * overlaps source bytes that would be read after they were written.
+ */
+bool mem_copy(unsigned int dst, unsigned int src, unsigned int length)
+{
+    if (dst > src && dst - src < length)
+        return false;
+    if (!isHostRange(src, length, false) || !isHostRange(dst, length, true))
+        return false;
+
+    while (length > 0)
+    {
+        unsigned int chunk = length;
+        if (chunk > MEM_PAGE_SIZE - (src & MEM_PAGE_MASK))
+            chunk = MEM_PAGE_SIZE - (src & MEM_PAGE_MASK);
+        if (chunk > MEM_PAGE_SIZE - (dst & MEM_PAGE_MASK))
+            chunk = MEM_PAGE_SIZE - (dst & MEM_PAGE_MASK);
+        memmove(g_mem.write[MEM_PAGE(dst)] + (dst & MEM_PAGE_MASK), g_mem.read[MEM_PAGE(src)] + (src & MEM_PAGE_MASK),
+                chunk);
+        dst += chunk;
+        src += chunk;
+        length -= chunk;
+    }
+    return true;
+}
+
+/* Write count items of size bytes holding value, returns false if the range is not RAM */
+bool mem_fill(unsigned int dst, unsigned int value, unsigned int size, unsigned int count)
+{
+    unsigned int length = size * count;
+    BYTE_68K pattern[4];
+    bool uniform = true;
+
+    if (size == 0 || size > 4 || count > (MEM_ADDRESS_MASK + 1) / size || !isHostRange(dst, length, true))
+        return false;
+    for (unsigned int i = 0; i < size; i++)
+    {
+        pattern[i] = (value >> (8 * (size - 1 - i))) & 0xff;
+        uniform = uniform && pattern[i] == pattern[0];
+    }
+
+    for (unsigned int done = 0; done < length;)
+    {
+        unsigned int chunk = length - done;
+        BYTE_68K *p = g_mem.write[MEM_PAGE(dst + done)] + ((dst + done) & MEM_PAGE_MASK);
+
+        if (chunk > MEM_PAGE_SIZE - ((dst + done) & MEM_PAGE_MASK))
+            chunk = MEM_PAGE_SIZE - ((dst + done) & MEM_PAGE_MASK);
+        if (uniform)
+            memset(p, pattern[0], chunk);
+        else
+        {
+            for (unsigned int i = 0; i < chunk; i++)
+                p[i] = pattern[(done + i) % size];
+        }
+        done += chunk;
+    }
+    return true;
+}
+
+/*
+ * Returns 1 if the whole page is RAM, 0 if no byte of the page is RAM and
+ * -1 if the page is mixed. mem_isRam() only changes its result at a few
+ * boundaries, so it is enough to compare the page start with these.
+ */
+static int pageIsRam(unsigned int start)
+{
+    unsigned int end = start + MEM_PAGE_SIZE - 1;
+    unsigned int bounds[] = { 0x8000, 0x80000,
+                              g_config.col256RAMAddr, g_config.col256RAMAddr + COL_SIZE - 1,
+                              g_start_gp_ram, g_start_gp_ram + 0x8000 };
+    bool first = mem_isRam(start);
+
+    for (int i = 0; i < sizeof(bounds) / sizeof(bounds[0]); i++)
+    {
+        if (bounds[i] > start && bounds[i] <= end && mem_isRam(bounds[i]) != first)
+            return -1;
+    }
+    return first ? 1 : 0;
+}
+
+void mem_init(const mem_handler *io)
+{
+    memset(open_bus, 0xFF, sizeof(open_bus));
+    g_mem.io = io;
+
+    for (int page = 0; page < MEM_NUM_PAGES; page++)
+    {
+        g_mem.read[page] = open_bus;
+        g_mem.write[page] = sink;
+        g_mem.handler[page] = NULL;
+    }
+
+    // The I/O window is in the last page
+    g_mem.read[MEM_NUM_PAGES - 1] = NULL;
+    g_mem.write[MEM_NUM_PAGES - 1] = NULL;
+    g_mem.handler[MEM_NUM_PAGES - 1] = io;
+
+    mem_rebuild();
+}
+
+/* Recalculate the pages of the 1 MB address space of the 68008 */
+void mem_rebuild()
+{
+    unsigned int colStart = g_config.col256RAMAddr;
+    unsigned int colEnd = g_config.col256RAMAddr + COL_SIZE - 1;
+
+    for (int page = 0; page <= MEM_PAGE(MAX_RAM); page++)
+    {
+        unsigned int start = page << MEM_PAGE_BITS;
+        unsigned int end = start + MEM_PAGE_SIZE - 1;
+
+        g_mem.handler[page] = &mixed_handler;
+
+        if (g_col.col_active && start <= colEnd && end >= colStart)
+        {
+            g_mem.read[page] = NULL;
+            g_mem.write[page] = NULL;
+            continue;
+        }
+
+        if (g_bb.bb_enabled && end <= MAX_BBROM)
+            g_mem.read[page] = g_rom + start;
+        else
+            g_mem.read[page] = g_ram + start;
+
+        switch (pageIsRam(start))
+        {
+        case 1:
+            g_mem.write[page] = g_ram + start;
+            break;
+        case 0:
+            g_mem.write[page] = sink;
+            break;
+        default:
+            g_mem.write[page] = NULL;
+            break;
+        }
+    }
+
+    // All write protection is gone, so is the cached code
+    m68k_block_flush();
+}
@@ -0,0 +1,78 @@
+/**************************************************************************************
+ *   Copyright (C) 2023,2024 by Martin Merck                                          *
+ *   martin.merck@gmx.de                                                              *
+ *                                                                                    *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy     *
+ *   of this software and associated documentation files (the "Software"), to deal    *
+ *   in the Software without restriction, including without limitation the rights     *
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell        *
+ *   copies of the Software, and to permit persons to whom the Software is            *
+ *   furnished to do so, subject to the following conditions:                         *
+ *                                                                                    *
+ *   The above copyright notice and this permission notice shall be included in all   *
+ *   copies or substantial portions of the Software.                                  *
+ *                                                                                    *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR       *
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,         * 
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE      *
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER           *
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,    *
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE    *
+ *   SOFTWARE.                                                                        *
+ *                                                                                    *
+ **************************************************************************************/
+
+#ifndef HEADER__MEM
+#define HEADER__MEM
+#include "nkc.h"
+
+/* The 24 bit address space of the CPU is split into 4 KB pages. */
+#define MEM_PAGE_BITS 12
+#define MEM_PAGE_SIZE (1 << MEM_PAGE_BITS)
+#define MEM_PAGE_MASK (MEM_PAGE_SIZE - 1)
+#define MEM_ADDRESS_MASK 0x00ffffff
+#define MEM_NUM_PAGES ((MEM_ADDRESS_MASK + 1) >> MEM_PAGE_BITS)
+#define MEM_PAGE(ADDR) (((ADDR) & MEM_ADDRESS_MASK) >> MEM_PAGE_BITS)
+
+/* Handler for pages which can not be accessed as plain host memory */
+typedef struct {
+    unsigned int (*read_byte)(unsigned int address);
+    unsigned int (*read_word)(unsigned int address);
+    unsigned int (*read_long)(unsigned int address);
+    void (*write_byte)(unsigned int address, unsigned int value);
+    void (*write_word)(unsigned int address, unsigned int value);
+    void (*write_long)(unsigned int address, unsigned int value);
+} mem_handler;
+
+/*
+ * A page is either backed by host memory (read/write point to the start of the
+ * page) or by a handler (read/write are NULL). Read-only pages have a read
+ * pointer and write to a sink page, so the write is dropped without a branch.
+ * RAM pages holding code cached by the CPU keep their read pointer but write
+ * through a handler until the first write.
+ */
+typedef struct {
+    BYTE_68K *read[MEM_NUM_PAGES];
+    BYTE_68K *write[MEM_NUM_PAGES];
+    const mem_handler *handler[MEM_NUM_PAGES];
+    const mem_handler *io;          /* Handler of the 0xFFFFxx I/O window */
+} mem;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    void mem_init(const mem_handler *io);
+    void mem_rebuild();
+    bool mem_isRam(unsigned int address);
+    BYTE_68K *mem_protect_code(unsigned int address);
+    bool mem_isPlain(unsigned int address);
+    bool mem_copy(unsigned int dst, unsigned int src, unsigned int length);
+    bool mem_fill(unsigned int dst, unsigned int value, unsigned int size, unsigned int count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HEADER__MEM */
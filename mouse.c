@@ -30,6 +30,8 @@
 #include <stdbool.h>
 #include "nkc.h"
 #include "mouse.h"
+#include "68k-nkcemu.h"
+#include "bus.h"
 #include "config.h"
 #include "log.h"
 
@@ -74,10 +76,8 @@ void mouse_p8A_out(BYTE_68K b)
 
 BYTE_68K mouse_p8B_in()
 {
-    int32_t x,y;
      /* return buttons of mouse */
-    Uint32 buttons = SDL_GetMouseState(&x, &y);
-    if( (buttons & SDL_BUTTON_LMASK) != 0 )
+    if( (g_mouse.mouse_state & SDL_BUTTON_LMASK) != 0 )
         g_mouse.mouse_buttons |= 1;
     else
         g_mouse.mouse_buttons &= 0xFE;
@@ -106,8 +106,8 @@ BYTE_68K mouse_p8D_in()
 void mouse_p8D_out(BYTE_68K b)
 {
     /* Store counters */
-    int x,y;
-    Uint32 buttons = SDL_GetMouseState(&x, &y);
+    int x = g_mouse.mouse_x;
+    int y = g_mouse.mouse_y;
     if( x > g_mouse.mouse_ref_x ) {
         g_mouse.mouse_right = (x - g_mouse.mouse_ref_x) / g_config.gdp64XMag;
         g_mouse.mouse_left = 0;
@@ -136,10 +136,8 @@ BYTE_68K mouse_p8E_in()
 void mouse_p8E_out(BYTE_68K b)
 {
     /* Clear counters */
-    int x,y;
-    Uint32 buttons = SDL_GetMouseState(&x, &y);
-    g_mouse.mouse_ref_x = x;
-    g_mouse.mouse_ref_y = y;
+    g_mouse.mouse_ref_x = g_mouse.mouse_x;
+    g_mouse.mouse_ref_y = g_mouse.mouse_y;
 	return;
 }
 
@@ -149,18 +147,41 @@ BYTE_68K mouse_p8F_in()
 	return g_mouse.mouse_left;
 }
 
+/* Keep the mouse state, the ports must not ask SDL from the emulation thread */
 void mouse_event_sdl(SDL_Event* event)
 {
-    // if (event->type == SDL_MOUSEMOTION)
-    // {
-	// }
-    // if (event->type == SDL_MOUSEBUTTONDOWN ||
-    //     event->type == SDL_MOUSEBUTTONUP)
-    // {
-   	// }
+    if (event->type == SDL_MOUSEMOTION)
+    {
+        g_mouse.mouse_x = event->motion.x;
+        g_mouse.mouse_y = event->motion.y;
+        g_mouse.mouse_state = event->motion.state;
+	}
+    if (event->type == SDL_MOUSEBUTTONDOWN ||
+        event->type == SDL_MOUSEBUTTONUP)
+    {
+        g_mouse.mouse_x = event->button.x;
+        g_mouse.mouse_y = event->button.y;
+        if (event->type == SDL_MOUSEBUTTONDOWN)
+            g_mouse.mouse_state |= SDL_BUTTON(event->button.button);
+        else
+            g_mouse.mouse_state &= ~SDL_BUTTON(event->button.button);
+   	}
 	return;
 }
 
+/* Register the ports of the mouse interface */
+void mouse_init()
+{
+    bus_register(MAUS_HIX, NULL, mouse_p88_out);
+    bus_register(MAUS_LOX, mouse_p89_in, mouse_p89_out);
+    bus_register(MAUS_HIY, mouse_p8A_in, mouse_p8A_out);
+    bus_register(MAUS_LOY, mouse_p8B_in, mouse_p8B_out);
+    bus_register(MAUS_UP, mouse_p8C_in, NULL);
+    bus_register(MAUS_DOWN, mouse_p8D_in, mouse_p8D_out);
+    bus_register(MAUS_RIGHT, mouse_p8E_in, mouse_p8E_out);
+    bus_register(MAUS_LEFT, mouse_p8F_in, NULL);
+}
+
 void mouse_reset()
 {
     g_mouse.io_port = 0;
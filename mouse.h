@@ -41,6 +41,9 @@ typedef struct
     uint16_t hardcopy_y;
     int32_t mouse_ref_x;
     int32_t mouse_ref_y;
+    int32_t mouse_x;            /* position and buttons from the last SDL mouse events */
+    int32_t mouse_y;
+    Uint32 mouse_state;
     uint16_t mouse_buttons;
     BYTE_68K mouse_flags;
     BYTE_68K mouse_up;
@@ -77,6 +80,7 @@ extern "C"
     BYTE_68K mouse_p8F_in();
     // void mouse_p8F_out(BYTE_68K data);      // not used
     void mouse_reset();
+    void mouse_init();
     void mouse_event_sdl(SDL_Event *event);
 
 #ifdef __cplusplus
@@ -354,14 +354,25 @@ void gui_draw(void)
     SDL_RenderPresent(g_gui.renderer);
 }
 
-void gui_event(SDL_Event* event)
+/* Window handling of the front panel, runs on the main thread */
+void gui_window_event(SDL_Event* event)
 {
-    SDL_Event* evt = event;
    	if (event->type == SDL_MOUSEMOTION ) {
         Uint32 flags = SDL_GetWindowFlags(g_gui.window);
         //if (( flags & SDL_WINDOW_MOUSE_FOCUS ) == 0)
             SDL_RaiseWindow(g_gui.window);
     }
+}
+
+/* The dialogs run on the emulation thread, the main thread raises the window */
+void gui_raise_gdp(void)
+{
+    SDL_AtomicSet(&g_gui.raiseGdp, 1);
+}
+
+void gui_event(SDL_Event* event)
+{
+    SDL_Event* evt = event;
    	if (event->type == SDL_MOUSEBUTTONDOWN ) {
 		log_debug("Button pressed %d %d",event->button.x, event->button.y);
         int button = -1;
@@ -446,23 +457,11 @@ void gui_event(SDL_Event* event)
                 break;
             case BUTTON_PASTE:
                 log_debug("Insert button pressed");
-                if (SDL_HasClipboardText() == SDL_TRUE)
-                {
-                    if (g_key.clipboardText != NULL)
-                    {
-                        SDL_free(g_key.clipboardText);
-                    }
-                    g_key.clipboardText = SDL_GetClipboardText();
-                    g_key.clipboardLength = strlen(g_key.clipboardText);
-                    g_key.clipboardOffset = 0;
-                }
+                SDL_AtomicSet(&g_gui.paste, 1);     // the main thread reads the clipboard
                 break;
             case BUTTON_TURBO:
                 log_debug("Turbo button pressed");
-                if( g_config.simSpeed == 0 )
-                    g_config.simSpeed = 1;
-                else
-                    g_config.simSpeed = 0;
+                toggle_turbo();
                 break;
             case BUTTON_INT:
                 log_debug("INT button pressed");
@@ -54,6 +54,8 @@ typedef struct {
     gui_button*     gui_buttons[GUI_NUM_BUTTONS];
     char*           current_path;
     int             active_dialog;
+    SDL_atomic_t    paste;          /* paste button pressed */
+    SDL_atomic_t    raiseGdp;       /* GDP64 window to be raised by the main thread */
 } gui;
 
 #ifdef __cplusplus
@@ -64,7 +66,9 @@ extern "C"
     void gui_quit(void);
     int  gui_init(void);
     void gui_draw(void);
+    void gui_window_event(SDL_Event* event);
     void gui_event(SDL_Event* event);
+    void gui_raise_gdp(void);
 
 #ifdef __cplusplus
 }
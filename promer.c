@@ -28,10 +28,11 @@
  */
 #include <stdio.h>
 #include <unistd.h>
-#include <sys/time.h>
 #include "nkc.h"
 #include "log.h"
 #include "promer.h"
+#include "68k-nkcemu.h"
+#include "bus.h"
 
 promer g_promer;
 
@@ -56,11 +57,9 @@ void promer_p80_out(BYTE_68K data)
 BYTE_68K promer_p81_in()
 {
   BYTE_68K status = 0x00;
-  struct timeval akttime;
 
-  gettimeofday(&akttime,NULL);
-  if(timercmp( &akttime, &g_promer.stoptime, >) )
-    status = 0x01;            // Busy
+  // The programming pulse isn't emulated, the byte is written at once
+  status = 0x01;            // Programming pulse finished
 
   return status;
 }
@@ -106,25 +105,23 @@ void promer_p82_out(BYTE_68K data)
         fflush(g_promer.prom_file);
       }
     }
-
-    struct timeval akttime;
-    gettimeofday(&akttime,NULL);
-//    timeradd(&akttime, &g_promer.progtime, &g_promer.stoptime);
   }
 }
 
-void promer_reset()
+/* Register the ports of the PROMER card */
+void promer_init()
 {
-  struct timeval akttime;
+  bus_register(PROM_DAT, promer_p80_in, promer_p80_out);
+  bus_register(PROM_A1, promer_p81_in, promer_p81_out);
+  bus_register(PROM_A2, promer_p82_in, promer_p82_out);
+}
 
+void promer_reset()
+{
   g_promer.led = false;
   g_promer.read = true;
-  g_promer.progtime.tv_sec = 0;
-  g_promer.progtime.tv_usec = 50000;
   if(g_promer.prom_file != NULL)
     fseek(g_promer.prom_file, 0, SEEK_SET);
-  gettimeofday(&akttime,NULL);
-//  timersub(&akttime, &g_promer.progtime, &g_promer.stoptime);
 }
 
 void promer_setFile(const char *filename)
@@ -36,8 +36,6 @@ typedef struct {
     int size;
     bool led;
     bool read;
-    struct timeval stoptime;
-    struct timeval progtime;
 } promer;
 
 #ifdef __cplusplus
@@ -55,6 +53,7 @@ extern "C"
     BYTE_68K promer_p82_in();
     void promer_p82_out(BYTE_68K data);
     void promer_reset();
+    void promer_init();
     void promer_setFile(const char *filename);
 
 #ifdef __cplusplus
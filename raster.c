@@ -0,0 +1,273 @@
+/**************************************************************************************
+ *   Copyright (C) 2023,2024 by Martin Merck                                          *
+ *   martin.merck@gmx.de                                                              *
+ *                                                                                    *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy     *
+ *   of this software and associated documentation files (the "Software"), to deal    *
+ *   in the Software without restriction, including without limitation the rights     *
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell        *
+ *   copies of the Software, and to permit persons to whom the Software is            *
+ *   furnished to do so, subject to the following conditions:                         *
+ *                                                                                    *
+ *   The above copyright notice and this permission notice shall be included in all   *
+ *   copies or substantial portions of the Software.                                  *
+ *                                                                                    *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR       *
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,         * 
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE      *
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER           *
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,    *
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE    *
+ *   SOFTWARE.                                                                        *
+ *                                                                                    *
+ **************************************************************************************/
+
+/**
+ * Rasterizer of the EF9366 primitives on the pages of the GDP64.
+ *
+ * The pages are plain memory with one bit per pixel, the primitives write
+ * whole words with masks. Pen colour and XOR mode are set by the card
+ * whenever its registers change. Nothing in here depends on SDL, the pages
+ * are only converted to pixels when a frame is handed to the window.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "raster.h"
+#include "ef9366charset.h"
+
+#define GLYPH_CACHE 256             /* expanded characters kept for reuse */
+
+/* Character or block expanded for one CSIZE and orientation, 128 pixels per row */
+typedef struct {
+    int key;                        /* code, CSIZE and CTRL2 bits 2/3 */
+    int dx;                         /* position of the mask relative to the pen */
+    int dy;
+    int height;
+    uint64_t *rows;                 /* 2 words per row, bit 0 is the leftmost pixel */
+    uint64_t *odd;                  /* dots hit an odd number of times, for XOR mode */
+} raster_glyph_mask;
+
+static raster_glyph_mask glyphCache[GLYPH_CACHE];
+
+/* Write the bits of mask in a word of the page */
+static inline void putBits(const raster *r, uint64_t *word, uint64_t mask, uint64_t bits)
+{
+    if (r->xor_en)
+        *word ^= mask & bits;
+    else
+        *word = (*word & ~mask) | (bits & mask);
+}
+
+/* Note rows first to last of the write page as changed for the next frame */
+static inline void markRows(raster *r, int first, int last)
+{
+    uint64_t *dirty = r->dirty[r->page];
+
+    for (int y = first; y <= last; y++)
+        dirty[y >> 6] |= (uint64_t)1 << (y & 63);
+}
+
+/* 64 bits of a 128 bit row starting at bit s, zero outside of it */
+static inline uint64_t rowBits(const uint64_t *bits, int s)
+{
+    if (s <= -64 || s >= 128)
+        return 0;
+    if (s < 0)
+        return bits[0] << -s;
+    if (s == 0)
+        return bits[0];
+    if (s < 64)
+        return (bits[0] >> s) | (bits[1] << (64 - s));
+    return bits[1] >> (s - 64);
+}
+
+/* Select the pen or the eraser and the XOR mode, called when the registers change */
+void raster_set_pen(raster *r, bool pen, bool xor_en)
+{
+    r->ink = pen ? ~(uint64_t)0 : 0;
+    r->xor_en = xor_en;
+}
+
+/* Clear or set the whole write page */
+void raster_fill(raster *r, bool set)
+{
+    memset(r->pages[r->page], set ? 0xFF : 0x00, sizeof(gdp64_page));
+    markRows(r, 0, GDP64_HEIGHT - 1);
+}
+
+/* Pixel with the pen if on, else with the inverse pen as the line styles do */
+void raster_pixel(raster *r, int x, int y, bool on)
+{
+    if (x < 0 || x > 511 || y < 0 || y > 255)
+        return; /* Pen is outside of the screen */
+    putBits(r, &r->pages[r->page][y][x >> 6], (uint64_t)1 << (x & 63), on ? r->ink : ~r->ink);
+    markRows(r, y, y);
+}
+
+/* Line style repeated over a word, bit i is the style bit of pixel i for a line starting at x */
+uint64_t raster_pattern(uint16_t style, int x)
+{
+    uint64_t reversed = 0;
+
+    for (int i = 0; i < 16; i++)
+        if (style & (0x8000 >> i))
+            reversed |= (uint64_t)1 << i;
+    reversed *= 0x0001000100010001ULL;
+    int shift = x & 15;
+    return shift ? (reversed << shift) | (reversed >> (64 - shift)) : reversed;
+}
+
+/* Horizontal run from x1 to x2 (x1 <= x2) in row y with the style pattern */
+void raster_span(raster *r, int x1, int x2, int y, uint64_t pattern)
+{
+    if (y < 0 || y > 255 || x2 < 0 || x1 > 511)
+        return;
+    if (x1 < 0)
+        x1 = 0;
+    if (x2 > 511)
+        x2 = 511;
+
+    uint64_t *row = r->pages[r->page][y];
+    uint64_t bits = r->ink ? pattern : ~pattern;
+    for (int w = x1 >> 6; w <= x2 >> 6; w++)
+    {
+        uint64_t mask = ~(uint64_t)0;
+        if (w == x1 >> 6)
+            mask &= ~(uint64_t)0 << (x1 & 63);
+        if (w == x2 >> 6)
+            mask &= ~(uint64_t)0 >> (63 - (x2 & 63));
+        putBits(r, &row[w], mask, bits);
+    }
+    markRows(r, y, y);
+}
+
+/* Vertical run from y1 to y2 (y1 <= y2) in column x, the style starts at y1 */
+void raster_column(raster *r, int x, int y1, int y2, uint16_t style)
+{
+    if (x < 0 || x > 511)
+        return;
+
+    uint64_t bit = (uint64_t)1 << (x & 63);
+    int first = y1 < 0 ? 0 : y1;
+    int last = y2 > 255 ? 255 : y2;
+    for (int y = first; y <= last; y++)
+    {
+        bool set = (style & (0x8000 >> ((y - y1) & 15))) != 0;
+        putBits(r, &r->pages[r->page][y][x >> 6], bit, set ? r->ink : ~r->ink);
+    }
+    markRows(r, first, last);
+}
+
+/*
+ * Expand a character or block like the EF9366 draws it: cols x rows dots,
+ * each CSIZE large, on the horizontal or vertical axis and tilted by one
+ * pixel per dot row. The block keeps the tilt correction of a character.
+ */
+static void expandGlyph(raster_glyph_mask *glyph, int code, int xSize, int ySize, bool vertical, bool tilted)
+{
+    int cols = code == RASTER_BLOCK ? 4 : 5;
+    int rows = code == RASTER_BLOCK ? 4 : 8;
+    int minX = 0, minY = 0, maxY = 0;
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        int realX = 0;
+        int realY = 0;
+        for (int x = 0; x < cols; x++)
+        {
+            for (int y = 0; y < rows; y++)
+            {
+                if (code == RASTER_BLOCK || (charset[code][x] & 128 >> y) != 0)
+                {
+                    for (int x1 = 0; x1 < xSize; x1++)
+                    {
+                        for (int y1 = 0; y1 < ySize; y1++)
+                        {
+                            int px = vertical ? realX - y * ySize - y1 : realX + x * xSize + x1;
+                            int py = vertical ? realY - x * xSize - x1 : realY - y * ySize - y1;
+                            if (pass == 0)
+                            {
+                                minX = px < minX ? px : minX;
+                                minY = py < minY ? py : minY;
+                                maxY = py > maxY ? py : maxY;
+                            }
+                            else
+                            {
+                                int bit = px - minX;
+                                int word = (py - minY) * 2 + (bit >> 6);
+                                glyph->rows[word] |= (uint64_t)1 << (bit & 63);
+                                glyph->odd[word] ^= (uint64_t)1 << (bit & 63);
+                            }
+                        }
+                    }
+                }
+                if (tilted)
+                {
+                    if (vertical)
+                        realY--;
+                    else
+                        realX++;
+                }
+            }
+            if (tilted)
+            {
+                if (vertical)
+                    realY += 8;
+                else
+                    realX -= 8;
+            }
+        }
+        if (pass == 0)
+        {
+            glyph->dx = minX;
+            glyph->dy = minY;
+            glyph->height = maxY - minY + 1;
+            free(glyph->rows);
+            free(glyph->odd);
+            glyph->rows = calloc(glyph->height * 2, sizeof(uint64_t));
+            glyph->odd = calloc(glyph->height * 2, sizeof(uint64_t));
+        }
+    }
+}
+
+/* Expanded character or block for a size and orientation (CTRL2 bits 2/3) */
+static raster_glyph_mask *getGlyph(int code, int xSize, int ySize, int orientation)
+{
+    int key = (code << 16) | (xSize << 10) | (ySize << 4) | orientation;
+    raster_glyph_mask *glyph = &glyphCache[(code * 31 + xSize * 112 + ySize * 7 + orientation) % GLYPH_CACHE];
+
+    if (glyph->key != key || glyph->rows == NULL)
+    {
+        expandGlyph(glyph, code, xSize, ySize, (orientation & 8) != 0, (orientation & 4) != 0);
+        glyph->key = key;
+    }
+    return glyph;
+}
+
+/* Draw the dots of a character (code 0..96) or the block at x,y, clipped to the screen */
+void raster_glyph(raster *r, int code, int xSize, int ySize, int orientation, int x, int y)
+{
+    const raster_glyph_mask *glyph = getGlyph(code, xSize, ySize, orientation);
+    int x0 = x + glyph->dx;
+    int y0 = y + glyph->dy;
+    int first = y0 < 0 ? -y0 : 0;
+    int last = y0 + glyph->height > 256 ? 256 - y0 : glyph->height;
+    int wFirst = x0 < 0 ? 0 : x0 >> 6;
+    int wLast = x0 + 127 > 511 ? 7 : (x0 + 127) >> 6;
+
+    if (first >= last || wFirst > wLast || x0 > 511)
+        return;
+    for (int row = first; row < last; row++)
+    {
+        /* cells may overlap on small sizes, XOR mode toggles such dots twice */
+        const uint64_t *bits = r->xor_en ? &glyph->odd[row * 2] : &glyph->rows[row * 2];
+        uint64_t *dest = r->pages[r->page][y0 + row];
+        for (int w = wFirst; w <= wLast; w++)
+        {
+            uint64_t mask = rowBits(bits, w * 64 - x0);
+            if (mask != 0)
+                putBits(r, &dest[w], mask, r->ink);
+        }
+    }
+    markRows(r, y0 + first, y0 + last - 1);
+}
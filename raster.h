@@ -0,0 +1,67 @@
+/**************************************************************************************
+ *   Copyright (C) 2023,2024 by Martin Merck                                          *
+ *   martin.merck@gmx.de                                                              *
+ *                                                                                    *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy     *
+ *   of this software and associated documentation files (the "Software"), to deal    *
+ *   in the Software without restriction, including without limitation the rights     *
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell        *
+ *   copies of the Software, and to permit persons to whom the Software is            *
+ *   furnished to do so, subject to the following conditions:                         *
+ *                                                                                    *
+ *   The above copyright notice and this permission notice shall be included in all   *
+ *   copies or substantial portions of the Software.                                  *
+ *                                                                                    *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR       *
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,         * 
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE      *
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER           *
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,    *
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE    *
+ *   SOFTWARE.                                                                        *
+ *                                                                                    *
+ **************************************************************************************/
+
+#ifndef HEADER__RASTER
+#define HEADER__RASTER
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define GDP64_WIDTH  512
+#define GDP64_HEIGHT 256
+#define GDP64_WORDS  (GDP64_WIDTH / 64)     /* 64 bit words in a row of a page */
+#define GDP64_PAGES  5                      /* four pages of the EF9366 plus the GUI page */
+
+#define RASTER_BLOCK 97             /* glyph code of the 4x4 block, after the characters */
+
+/* Page of the EF9366 with 1 bit per pixel, bit 0 of a word is its leftmost pixel */
+typedef uint64_t gdp64_page[GDP64_HEIGHT][GDP64_WORDS];
+
+/* Pages of the GDP64 and the pen state of the primitives drawing on them */
+typedef struct {
+    gdp64_page pages[GDP64_PAGES];
+    uint64_t dirty[GDP64_PAGES][GDP64_HEIGHT / 64];  /* rows written since the last frame */
+    int page;                       /* page the primitives draw on */
+    bool xor_en;                    /* XOR mode: (1.) Draw-pen is selected and (2.) XOR_EN bit is set */
+    uint64_t ink;                   /* all ones for the pen, zero for the eraser */
+} raster;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    void raster_set_pen(raster *r, bool pen, bool xor_en);
+    void raster_fill(raster *r, bool set);
+    void raster_pixel(raster *r, int x, int y, bool on);
+    uint64_t raster_pattern(uint16_t style, int x);
+    void raster_span(raster *r, int x1, int x2, int y, uint64_t pattern);
+    void raster_column(raster *r, int x, int y1, int y2, uint16_t style);
+    void raster_glyph(raster *r, int code, int xSize, int ySize, int orientation, int x, int y);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HEADER__RASTER */
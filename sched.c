@@ -0,0 +1,192 @@
+/**************************************************************************************
+ *   Copyright (C) 2023,2024 by Martin Merck                                          *
+ *   martin.merck@gmx.de                                                              *
+ *                                                                                    *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy     *
+ *   of this software and associated documentation files (the "Software"), to deal    *
+ *   in the Software without restriction, including without limitation the rights     *
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell        *
+ *   copies of the Software, and to permit persons to whom the Software is            *
+ *   furnished to do so, subject to the following conditions:                         *
+ *                                                                                    *
+ *   The above copyright notice and this permission notice shall be included in all   *
+ *   copies or substantial portions of the Software.                                  *
+ *                                                                                    *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR       *
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,         * 
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE      *
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER           *
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,    *
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE    *
+ *   SOFTWARE.                                                                        *
+ *                                                                                    *
+ **************************************************************************************/
+
+/**
+ * Event scheduler driven by the emulated CPU cycles.
+ *
+ * Devices schedule their timed events (VSYNC, command completion, ...) in a
+ * fixed slot. The CPU is run in chunks up to the next due event, so no time
+ * check is needed for each instruction.
+ */
+#include <stdio.h>
+#include <limits.h>
+#include "sched.h"
+#include "config.h"
+#include "m68k.h"
+#include "idle.h"
+#include "log.h"
+
+sched g_sched;
+
+extern config g_config;
+extern int g_extraSlice;
+
+static void updateNext()
+{
+    g_sched.next = LLONG_MAX;
+    for (int i = 0; i < SCHED_MAX_EVENTS; i++)
+    {
+        if (g_sched.events[i].active && g_sched.events[i].when < g_sched.next)
+            g_sched.next = g_sched.events[i].when;
+    }
+}
+
+/* Call the callbacks of all due events */
+static void dispatch()
+{
+    while (g_sched.next <= g_sched.now)
+    {
+        for (int i = 0; i < SCHED_MAX_EVENTS; i++)
+        {
+            sched_event *event = &g_sched.events[i];
+            if (event->active && event->when <= g_sched.now)
+            {
+                if (event->period != 0)
+                    event->when += event->period;
+                else
+                    event->active = false;
+                event->callback();
+            }
+        }
+        updateNext();
+    }
+}
+
+void sched_init()
+{
+    g_sched.now = 0;
+    g_sched.running = false;
+    for (int i = 0; i < SCHED_MAX_EVENTS; i++)
+        g_sched.events[i].active = false;
+    updateNext();
+}
+
+/* Schedule a one-shot event in the given number of cycles */
+void sched_add(int id, long long cycles, sched_callback callback)
+{
+    sched_event *event = &g_sched.events[id];
+    event->active = true;
+    event->when = g_sched.now + cycles;
+    event->period = 0;
+    event->callback = callback;
+    if (event->when < g_sched.next)
+        g_sched.next = event->when;
+
+    // Due before the running slice ends, stop the CPU after this instruction
+    if (g_sched.running && event->when < g_sched.end)
+    {
+        long long left = event->when - sched_current();
+        int remaining = m68k_cycles_remaining();
+        if (left < remaining)
+            m68k_modify_timeslice((int)(left > 0 ? left : 0) - remaining);
+        g_sched.end = event->when;
+    }
+}
+
+/* Schedule an event every period cycles */
+void sched_periodic(int id, long long period, sched_callback callback)
+{
+    sched_add(id, period, callback);
+    g_sched.events[id].period = period;
+}
+
+void sched_cancel(int id)
+{
+    g_sched.events[id].active = false;
+    updateNext();
+}
+
+bool sched_pending(int id)
+{
+    return g_sched.events[id].active;
+}
+
+/* Convert micro seconds to CPU cycles at the configured CPU speed */
+long long sched_cycles(long long micros)
+{
+    return micros * g_config.cpuSpeed;
+}
+
+long long sched_now()
+{
+    return g_sched.now;
+}
+
+/* Emulated cycle of the running instruction or of the event being dispatched */
+long long sched_current()
+{
+    if (g_sched.running)
+        return g_sched.now + m68k_cycles_run() + g_extraSlice;
+    return g_sched.now;
+}
+
+/*
+ * Length of the next slice, up to the next due event but at most the given
+ * cycles. Interrupts are checked when the CPU is entered, so a level raised
+ * by the event is taken without waiting for the end of a longer slice.
+ */
+long long sched_slice(long long cycles)
+{
+    long long run = g_sched.next - g_sched.now;
+    if (run < 1)
+        return 1;
+    return run < cycles ? run : cycles;
+}
+
+/*
+ * Execute the CPU for the given number of cycles and dispatch the events
+ * becoming due. Returns the number of cycles used including wait states.
+ */
+int sched_execute(int cycles)
+{
+    long long start = g_sched.now;
+    long long end = g_sched.now + cycles;
+
+    do
+    {
+        long long run = (g_sched.next < end ? g_sched.next : end) - g_sched.now;
+        if (run > 0)
+        {
+            g_sched.end = g_sched.now + run;
+            g_sched.running = true;
+            int used = m68k_execute((int)run) + g_extraSlice;
+            g_sched.running = false;
+            g_extraSlice = 0;
+            if (used == 0)              // CPU is stopped, wait for the next event
+                used = run;
+            g_sched.now += used;
+
+            // Polling loop found, nothing changes until the next event
+            long long target = g_sched.next < end ? g_sched.next : end;
+            if (idle_detected() && target > g_sched.now)
+            {
+                idle_skipped(target - g_sched.now);
+                g_sched.now = target;
+            }
+        }
+        dispatch();
+    } while (g_sched.now < end);
+
+    return (int)(g_sched.now - start);
+}
@@ -0,0 +1,77 @@
+/**************************************************************************************
+ *   Copyright (C) 2023,2024 by Martin Merck                                          *
+ *   martin.merck@gmx.de                                                              *
+ *                                                                                    *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy     *
+ *   of this software and associated documentation files (the "Software"), to deal    *
+ *   in the Software without restriction, including without limitation the rights     *
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell        *
+ *   copies of the Software, and to permit persons to whom the Software is            *
+ *   furnished to do so, subject to the following conditions:                         *
+ *                                                                                    *
+ *   The above copyright notice and this permission notice shall be included in all   *
+ *   copies or substantial portions of the Software.                                  *
+ *                                                                                    *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR       *
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,         * 
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE      *
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER           *
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,    *
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE    *
+ *   SOFTWARE.                                                                        *
+ *                                                                                    *
+ **************************************************************************************/
+
+#ifndef HEADER__SCHED
+#define HEADER__SCHED
+#include "nkc.h"
+
+/* Event slots, each device owns its slot */
+#define SCHED_VSYNC      0      /* Start of the GDP64 VSYNC pulse */
+#define SCHED_VSYNC_END  1      /* End of the GDP64 VSYNC pulse */
+#define SCHED_POLL       2      /* SDL event handling and window updates */
+#define SCHED_FLO2       3      /* Completion of a FLO2 command */
+#define SCHED_GDP64      4      /* GDP64 ready after drawing a command */
+#define SCHED_MAX_EVENTS 8
+
+#define SCHED_SLICE_MICROS 500     /* longest slice when throttled, the host clock is checked after each */
+#define SCHED_TURBO_MICROS 10000   /* longest slice at full speed */
+
+typedef void (*sched_callback)();
+
+typedef struct {
+    bool active;
+    long long when;             /* emulated cycle at which the event is due */
+    long long period;           /* cycles between periodic events, 0 for one-shot events */
+    sched_callback callback;
+} sched_event;
+
+typedef struct {
+    long long now;              /* emulated cycles since power on */
+    long long next;             /* cycle of the next due event */
+    long long end;              /* cycle at which the running slice ends */
+    bool running;               /* the CPU is executing a slice */
+    sched_event events[SCHED_MAX_EVENTS];
+} sched;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    void sched_init();
+    void sched_add(int id, long long cycles, sched_callback callback);
+    void sched_periodic(int id, long long period, sched_callback callback);
+    void sched_cancel(int id);
+    bool sched_pending(int id);
+    long long sched_cycles(long long micros);
+    long long sched_now();
+    long long sched_current();
+    long long sched_slice(long long cycles);
+    int sched_execute(int cycles);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HEADER__SCHED */
@@ -23,6 +23,8 @@
  *                                                                                    *
  **************************************************************************************/
 #include "ser.h"
+#include "68k-nkcemu.h"
+#include "bus.h"
 #include "config.h"
 
 ser g_ser;
@@ -73,6 +75,8 @@ void ser_open(const char *port_name, int baud_rate)
     {
         free(g_ser.port);
         g_ser.port = NULL;
+        log_error("SER: Failed to open port %s\n", port_name);
+        return;
     }
 
     struct termios tty;
@@ -81,6 +85,7 @@ void ser_open(const char *port_name, int baud_rate)
         close(g_ser.port->fd);
         free(g_ser.port);
         g_ser.port = NULL;
+        return;
     }
 
     cfsetospeed(&tty, baud_rate);
@@ -283,7 +288,7 @@ int serial_read(char *buffer)
     }
     return -1;
 #else
-    return read(g_ser.port->fd, buffer, length);
+    return read(g_ser.port->fd, buffer, 1L);
 #endif
 }
 
@@ -454,9 +459,12 @@ void ser_pF3_out(BYTE_68K b)
         break;
     }
 
-    ser_set_baud_rate(g_ser.brate);
-    ser_set_char_size(g_ser.char_size);
-    ser_set_stop_bits(g_ser.stop_bits);
+    if (g_ser.port != NULL)
+    {
+        ser_set_baud_rate(g_ser.brate);
+        ser_set_char_size(g_ser.char_size);
+        ser_set_stop_bits(g_ser.stop_bits);
+    }
 }
 
 /// @brief Read the control register
@@ -467,6 +475,15 @@ BYTE_68K ser_pF3_in()
     return g_ser.control;
 }
 
+/// @brief Register the ports of the SER card
+void ser_init()
+{
+    bus_register(SER_DATA, ser_pF0_in, ser_pF0_out);
+    bus_register(SER_STATUS, ser_pF1_in, ser_pF1_out);
+    bus_register(SER_CMD, ser_pF2_in, ser_pF2_out);
+    bus_register(SER_CNTL, ser_pF3_in, ser_pF3_out);
+}
+
 void ser_reset()
 {
     g_ser.receive_data = 0;
@@ -486,4 +503,7 @@ void ser_setPort(const char *portname)
     log_debug("SER: Set port to %s\n", portname);
     ser_close(g_ser.port);
     ser_open(portname, 9600);
+    // Data from a host port arrives without a scheduled event, so only
+    // the status of the card without a port can be skipped by idle.c
+    bus_set_pollable(SER_STATUS, g_ser.port == NULL);
 }
@@ -73,6 +73,7 @@ extern "C"
     BYTE_68K ser_pF3_in();
     void ser_pF3_out(BYTE_68K data);
     void ser_reset();
+    void ser_init();
     void ser_setPort(const char *portname);
 
 #ifdef __cplusplus
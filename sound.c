@@ -35,6 +35,8 @@
 #include <SDL_audio.h>
 #include "log.h"
 #include "sound.h"
+#include "68k-nkcemu.h"
+#include "bus.h"
 
 sound g_sound;
 
@@ -320,6 +322,20 @@ void audio_callback(void *userData, Uint8 *stream, int length)
     }
 }
 
+/* Register the ports of the SOUND card, also at the JADOS addresses */
+void sound_init()
+{
+    bus_register(SOUND_ADR, sound_p40_in, sound_p40_out);
+    bus_register(SOUND_DATA, sound_p41_in, sound_p41_out);
+    bus_register(SOUND_JADOS_ADR, sound_p40_in, sound_p40_out);
+    bus_register(SOUND_JADOS_DATA, sound_p41_in, sound_p41_out);
+}
+
+/*
+ * Called on the emulation thread by a reset and the sound dialog. SDL
+ * guards the audio devices with its own lock and they don't belong to the
+ * windows or the event loop of the main thread.
+ */
 void sound_reset(const char *soundDriver)
 {
     if (g_sound.audioDev != 0)
@@ -64,6 +64,7 @@ extern "C"
 	BYTE_68K sound_p41_in();
 	void sound_p41_out(BYTE_68K data);
 	void sound_reset(const char * soundDriver);
+	void sound_init();
 
 #ifdef __cplusplus
 }
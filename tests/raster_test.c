@@ -0,0 +1,147 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../raster.h"
+
+/*
+ * Checks the word based primitives of raster.c against a plain per-pixel
+ * implementation of the EF9366 drawing on random commands.
+ */
+
+extern unsigned char charset[97][5];
+
+static raster r;
+static gdp64_page ref;
+static bool refPen;
+static bool refXor;
+
+static const uint16_t styles[4] = {0xFFFF, 0xCCCC, 0xF0F0, 0xFFCC};
+
+/* Pixel with the pen, or with the inverse pen if the style bit is off */
+static void refDot(int x, int y, bool on)
+{
+    if (x < 0 || x > 511 || y < 0 || y > 255)
+        return;
+    bool pen = on ? refPen : !refPen;
+    uint64_t bit = (uint64_t)1 << (x & 63);
+    if (refXor) {
+        if (pen)
+            ref[y][x >> 6] ^= bit;
+    } else if (pen) {
+        ref[y][x >> 6] |= bit;
+    } else {
+        ref[y][x >> 6] &= ~bit;
+    }
+}
+
+static void refGlyph(int code, int xSize, int ySize, int orientation, int x, int y)
+{
+    int cols = code == RASTER_BLOCK ? 4 : 5;
+    int rows = code == RASTER_BLOCK ? 4 : 8;
+
+    for (int cx = 0; cx < cols; cx++)
+    {
+        for (int cy = 0; cy < rows; cy++)
+        {
+            if (code == RASTER_BLOCK || (charset[code][cx] & 128 >> cy) != 0)
+            {
+                for (int x1 = 0; x1 < xSize; x1++)
+                    for (int y1 = 0; y1 < ySize; y1++)
+                    {
+                        if (orientation & 8)
+                            refDot(x - cy * ySize - y1, y - cx * xSize - x1, true);
+                        else
+                            refDot(x + cx * xSize + x1, y - cy * ySize - y1, true);
+                    }
+            }
+            if (orientation & 4)
+            {
+                if (orientation & 8)
+                    y--;
+                else
+                    x++;
+            }
+        }
+        if (orientation & 4)
+        {
+            if (orientation & 8)
+                y += 8;
+            else
+                x -= 8;
+        }
+    }
+}
+
+static void refSpan(int x1, int x2, int y, uint16_t style)
+{
+    for (int x = x1; x <= x2; x++)
+        refDot(x, y, (style & (0x8000 >> ((x - x1) & 15))) != 0);
+}
+
+static void refColumn(int x, int y1, int y2, uint16_t style)
+{
+    for (int y = y1; y <= y2; y++)
+        refDot(x, y, (style & (0x8000 >> ((y - y1) & 15))) != 0);
+}
+
+int main() {
+    int failures = 0;
+
+    srand(1);
+    memset(&r, 0, sizeof(r));
+    memset(ref, 0, sizeof(ref));
+    r.page = 2;
+    for (int i = 0; i < 20000; i++)
+    {
+        refPen = rand() % 4 != 0;
+        refXor = refPen && rand() % 3 == 0;
+        raster_set_pen(&r, refPen, refXor);
+
+        int x = rand() % 700 - 90;
+        int y = rand() % 400 - 70;
+        uint16_t style = styles[rand() % 4];
+        int op = rand() % 10;
+        if (op < 5)
+        {
+            int code = rand() % 10 == 0 ? RASTER_BLOCK : rand() % 97;
+            int xSize = rand() % 4 == 0 ? rand() % 16 + 1 : rand() % 3 + 1;
+            int ySize = rand() % 4 == 0 ? rand() % 16 + 1 : rand() % 3 + 1;
+            int orientation = (rand() % 4) << 2;
+            raster_glyph(&r, code, xSize, ySize, orientation, x, y);
+            refGlyph(code, xSize, ySize, orientation, x, y);
+        }
+        else if (op < 8)
+        {
+            int x2 = x + rand() % 300;
+            raster_span(&r, x, x2, y, raster_pattern(style, x));
+            refSpan(x, x2, y, style);
+        }
+        else if (op < 9)
+        {
+            int y2 = y + rand() % 200;
+            raster_column(&r, x, y, y2, style);
+            refColumn(x, y, y2, style);
+        }
+        else
+        {
+            bool on = rand() % 2;
+            raster_pixel(&r, x, y, on);
+            refDot(x, y, on);
+        }
+
+        if (memcmp(r.pages[r.page], ref, sizeof(ref)) != 0)
+        {
+            printf("Page differs after command %d (op %d at %d,%d)\n", i, op, x, y);
+            memcpy(ref, r.pages[r.page], sizeof(ref));
+            failures++;
+        }
+        if (rand() % 500 == 0)
+        {
+            bool set = rand() % 2;
+            raster_fill(&r, set);
+            memset(ref, set ? 0xFF : 0x00, sizeof(ref));
+        }
+    }
+    printf("Raster test: %d failures\n", failures);
+    return failures != 0;
+}
@@ -0,0 +1,103 @@
+/**************************************************************************************
+ *   Copyright (C) 2023,2024 by Martin Merck                                          *
+ *   martin.merck@gmx.de                                                              *
+ *                                                                                    *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy     *
+ *   of this software and associated documentation files (the "Software"), to deal    *
+ *   in the Software without restriction, including without limitation the rights     *
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell        *
+ *   copies of the Software, and to permit persons to whom the Software is            *
+ *   furnished to do so, subject to the following conditions:                         *
+ *                                                                                    *
+ *   The above copyright notice and this permission notice shall be included in all   *
+ *   copies or substantial portions of the Software.                                  *
+ *                                                                                    *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR       *
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,         * 
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE      *
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER           *
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,    *
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE    *
+ *   SOFTWARE.                                                                        *
+ *                                                                                    *
+ **************************************************************************************/
+
+/**
+ * Throttles the emulation to the speed of the real CPU.
+ *
+ * The emulated time is kept as an absolute deadline on CLOCK_MONOTONIC.
+ * Most of the wait is spent in nkc_sleep_until(), so the host core is
+ * not pinned while emulating a slow CPU. How late the wake ups are is
+ * collected and logged together with the simulated speed.
+ */
+#include <stdio.h>
+#include "throttle.h"
+#include "util.h"
+#include "log.h"
+
+throttle g_throttle;
+
+static void resetStats()
+{
+    g_throttle.samples = 0;
+    g_throttle.jitterSum = 0;
+    g_throttle.jitterMax = 0;
+    g_throttle.late = 0;
+    g_throttle.resyncs = 0;
+}
+
+/* Start a new throttling period at the current host time */
+void throttle_init()
+{
+    clock_gettime(CLOCK_MONOTONIC, &g_throttle.deadline);
+    resetStats();
+}
+
+/* Wait until the host time has caught up with nanos more of emulated time */
+void throttle_wait(long long nanos)
+{
+    struct timespec now;
+
+    nkc_add_nanos(&g_throttle.deadline, nanos);
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    long long ahead = nkc_get_diff_nanos(&now, &g_throttle.deadline);
+    if (ahead <= 0)
+    {
+        g_throttle.late++;
+        if (-ahead > THROTTLE_RESYNC_NANOS)
+        {
+            // The host can't keep up or the emulation was paused, don't try to catch up
+            g_throttle.deadline = now;
+            g_throttle.resyncs++;
+        }
+        return;
+    }
+
+    if (ahead > THROTTLE_SPIN_NANOS)
+    {
+        struct timespec wakeup = g_throttle.deadline;
+        nkc_add_nanos(&wakeup, -THROTTLE_SPIN_NANOS);
+        nkc_sleep_until(&wakeup);
+    }
+    do
+    {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+    } while (nkc_get_diff_nanos(&g_throttle.deadline, &now) < 0);
+
+    long long jitter = nkc_get_diff_nanos(&g_throttle.deadline, &now);
+    g_throttle.samples++;
+    g_throttle.jitterSum += jitter;
+    if (jitter > g_throttle.jitterMax)
+        g_throttle.jitterMax = jitter;
+}
+
+void throttle_log_stats()
+{
+    if (g_throttle.samples == 0 && g_throttle.late == 0)
+        return;
+
+    double avg = g_throttle.samples ? (double)g_throttle.jitterSum / g_throttle.samples : 0.0;
+    log_info("Throttle jitter (us): avg %.1lf max %.1lf, %lld slices late, %lld resyncs",
+             avg / 1000.0, g_throttle.jitterMax / 1000.0, g_throttle.late, g_throttle.resyncs);
+    resetStats();
+}
@@ -0,0 +1,55 @@
+/**************************************************************************************
+ *   Copyright (C) 2023,2024 by Martin Merck                                          *
+ *   martin.merck@gmx.de                                                              *
+ *                                                                                    *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy     *
+ *   of this software and associated documentation files (the "Software"), to deal    *
+ *   in the Software without restriction, including without limitation the rights     *
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell        *
+ *   copies of the Software, and to permit persons to whom the Software is            *
+ *   furnished to do so, subject to the following conditions:                         *
+ *                                                                                    *
+ *   The above copyright notice and this permission notice shall be included in all   *
+ *   copies or substantial portions of the Software.                                  *
+ *                                                                                    *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR       *
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,         * 
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE      *
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER           *
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,    *
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE    *
+ *   SOFTWARE.                                                                        *
+ *                                                                                    *
+ **************************************************************************************/
+
+#ifndef HEADER__THROTTLE
+#define HEADER__THROTTLE
+#include <time.h>
+#include "nkc.h"
+
+#define THROTTLE_SPIN_NANOS   50000LL        /* spin for the last 50 us before a deadline */
+#define THROTTLE_RESYNC_NANOS 100000000LL    /* give up catching up when more than 100 ms behind */
+
+typedef struct {
+    struct timespec deadline;   /* host time at which the emulated time is reached */
+    long long samples;
+    long long jitterSum;        /* nanoseconds woken up after the deadline */
+    long long jitterMax;
+    long long late;             /* number of slices which were already behind */
+    long long resyncs;
+} throttle;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    void throttle_init();
+    void throttle_wait(long long nanos);
+    void throttle_log_stats();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HEADER__THROTTLE */
@@ -28,6 +28,8 @@
  * If you reset to a different date/time only a difference is calculated
  * and applied to the results. Currently this difference is not persisted 
  * between runs.
+ * In deterministic mode the clock starts at the configured UhrEpoch and
+ * advances with the emulated CPU cycles instead of the system clock.
  */
 
 #include <stdio.h>
@@ -35,9 +37,17 @@
 #include <stdlib.h> /* strtol */
 #include <stdbool.h>
 #include "uhr.h"
+#include "68k-nkcemu.h"
+#include "bus.h"
+#include "sched.h"
+#include "config.h"
 #include "log.h"
+#include "util.h"
+
+#define UHR_DEFAULT_EPOCH "2000-01-01 00:00:00"
 
 uhr g_uhr;
+extern config g_config;
 
 /*
  * Internal helpers
@@ -78,6 +88,31 @@ BYTE_68K rotateLeft(BYTE_68K x)
 	return shifted | rot_bits;
 }
 
+/* Current time of the clock without the difference set by the NKC */
+static time_t uhr_now()
+{
+	if (g_config.deterministic)
+		return g_uhr.epoch + sched_now() / (g_config.cpuSpeed * 1000000LL);
+
+	time_t rawtime;
+	return time(&rawtime);
+}
+
+/* Deterministic mode uses UTC, so the results do not depend on the host time zone */
+static struct tm *uhr_split(time_t *rawtime)
+{
+	if (g_config.deterministic)
+		return gmtime(rawtime);
+	return localtime(rawtime);
+}
+
+static time_t uhr_join(struct tm *timeinfo)
+{
+	if (g_config.deterministic)
+		return nkc_timegm(timeinfo);
+	return mktime(timeinfo);
+}
+
 const char *byte_to_binary(int x)
 {
 	static char b[9];
@@ -148,9 +183,8 @@ void uhr_pFE_out(BYTE_68K b)
 		time_t rawtime;
 		struct tm *timeinfo;
 
-		time(&rawtime);
-		rawtime += g_uhr.diffTime;
-		timeinfo = localtime(&rawtime);
+		rawtime = uhr_now() + g_uhr.diffTime;
+		timeinfo = uhr_split(&rawtime);
 		g_uhr.hour = toBCD(timeinfo->tm_hour);
 		g_uhr.minute = toBCD(timeinfo->tm_min);
 		g_uhr.second = toBCD(timeinfo->tm_sec);
@@ -158,7 +192,7 @@ void uhr_pFE_out(BYTE_68K b)
 		g_uhr.month = toBCD(timeinfo->tm_mon + 1);
 		g_uhr.year = toBCD(timeinfo->tm_year);
 		g_uhr.wday = toBCD(timeinfo->tm_wday);
-		g_uhr.aktTime = mktime(timeinfo);
+		g_uhr.aktTime = uhr_join(timeinfo);
 
 		g_uhr.bitCounter = 4; // we expect first to receive 4 bits (3 bit address and r/w mode)
 		g_uhr.enable = true;
@@ -233,18 +267,16 @@ void uhr_pFE_out(BYTE_68K b)
 				case 0:
 					g_uhr.setTime.tm_sec = val;
 					g_uhr.setTime.tm_isdst = -1;
-					g_uhr.ndrTime = mktime( &g_uhr.setTime);
 					log_debug("Setting time to %d:%d:%d - %d.%d.%d - %d",
 						 g_uhr.setTime.tm_hour, g_uhr.setTime.tm_min, g_uhr.setTime.tm_sec,
 						 g_uhr.setTime.tm_mday, g_uhr.setTime.tm_mon, g_uhr.setTime.tm_year,
 						 g_uhr.setTime.tm_wday);
-					g_uhr.ndrTime = mktime( &g_uhr.setTime);
+					g_uhr.ndrTime = uhr_join( &g_uhr.setTime);
 					if(g_uhr.ndrTime == -1) {
 						log_error("Invalid time");
 						g_uhr.ndrTime = g_uhr.aktTime;
 					}
-					time_t rawtime;
-					g_uhr.diffTime = g_uhr.ndrTime - time(&rawtime);
+					g_uhr.diffTime = g_uhr.ndrTime - uhr_now();
 					break;
 				default:
 					printf("Unexpected write ERROR\n");
@@ -258,11 +290,37 @@ void uhr_pFE_out(BYTE_68K b)
 	return; /* no output on key ports */
 }
 
+/* Register the port of the clock */
+void uhr_init()
+{
+    bus_register(UHR_DATA, uhr_pFE_in, uhr_pFE_out);
+}
+
 void uhr_reset()
 {
 	g_uhr.enable = false; 		/* disable clock chip */
 	g_uhr.taktHigh = false;
 	g_uhr.mode = -1;
 	g_uhr.diffTime = 0;
+
+	if (g_config.deterministic)
+	{
+		const char *epoch = g_config.uhrEpoch;
+		struct tm timeinfo;
+
+		if (epoch == NULL || *epoch == '\0')
+			epoch = UHR_DEFAULT_EPOCH;
+		memset(&timeinfo, 0, sizeof(timeinfo));
+		if (sscanf(epoch, "%d-%d-%d %d:%d:%d", &timeinfo.tm_year, &timeinfo.tm_mon, &timeinfo.tm_mday,
+				   &timeinfo.tm_hour, &timeinfo.tm_min, &timeinfo.tm_sec) != 6)
+		{
+			log_error("Invalid UhrEpoch %s, using %s", epoch, UHR_DEFAULT_EPOCH);
+			sscanf(UHR_DEFAULT_EPOCH, "%d-%d-%d %d:%d:%d", &timeinfo.tm_year, &timeinfo.tm_mon, &timeinfo.tm_mday,
+				   &timeinfo.tm_hour, &timeinfo.tm_min, &timeinfo.tm_sec);
+		}
+		timeinfo.tm_year -= 1900;
+		timeinfo.tm_mon -= 1;
+		g_uhr.epoch = nkc_timegm(&timeinfo);
+	}
 	return;
 }
@@ -46,6 +46,7 @@ typedef struct
     time_t diffTime;
     time_t ndrTime;
     time_t aktTime;
+    time_t epoch;               /* start time in deterministic mode */
     BYTE_68K activeByte;
 } uhr;
 
@@ -57,6 +58,7 @@ extern "C"
     BYTE_68K uhr_pFE_in();
     void uhr_pFE_out(BYTE_68K data);
     void uhr_reset();
+    void uhr_init();
 
 #ifdef __cplusplus
 }
@@ -24,6 +24,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <errno.h>
 #include <sys/time.h>
 #include "nkc.h"
 #include "log.h"
@@ -59,20 +60,44 @@ long long nkc_get_diff_nanos(struct timespec* start, struct timespec* end)
     return nsec;
 }
 
-void nkc_sleep_nanos(long long ns)
+void nkc_add_nanos(struct timespec* time, long long ns)
 {
-    long sleeploops = 0;
-    struct timespec start, end;
-    clock_gettime( CLOCK_REALTIME, &start);
-    long long elapsedNanos = 0;
-    while (elapsedNanos < ns)
-    {
-        sleeploops++;
-        clock_gettime( CLOCK_REALTIME, &end);
-        elapsedNanos = nkc_get_diff_nanos(&start, &end);
+    ns += time->tv_nsec;
+    time->tv_sec += ns / 1000000000;
+    time->tv_nsec = ns % 1000000000;
+    if (time->tv_nsec < 0) {
+        time->tv_sec -= 1;
+        time->tv_nsec += 1000000000;
     }
-    //log_info("Sleeptime: %d Sleeploops %ld", ns, sleeploops);
+}
 
+/* Sleep until the given CLOCK_MONOTONIC time is reached */
+void nkc_sleep_until(struct timespec* deadline)
+{
+#if defined(__APPLE__)
+    struct timespec now, rel;
+    clock_gettime( CLOCK_MONOTONIC, &now);
+    long long ns = nkc_get_diff_nanos(&now, deadline);
+    if (ns <= 0)
+        return;
+    rel.tv_sec = ns / 1000000000;
+    rel.tv_nsec = ns % 1000000000;
+    while (nanosleep(&rel, &rel) == -1 && errno == EINTR)
+        ;
+#else
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, deadline, NULL) == EINTR)
+        ;
+#endif
+}
+
+/* Inverse of gmtime, Windows names it _mkgmtime */
+time_t nkc_timegm(struct tm* timeinfo)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    return _mkgmtime(timeinfo);
+#else
+    return timegm(timeinfo);
+#endif
 }
 
 nkc_array* nkc_arr_new()
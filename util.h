@@ -49,7 +49,9 @@ extern "C"
 
     long nkc_get_diff_micros(struct timeval *t1, struct timeval *t2);
     long long nkc_get_diff_nanos(struct timespec* start, struct timespec* end);
-    void nkc_sleep_nanos(long long ns);
+    void nkc_add_nanos(struct timespec* time, long long ns);
+    void nkc_sleep_until(struct timespec* deadline);
+    time_t nkc_timegm(struct tm* timeinfo);
 
 	nkc_array* nkc_arr_new();
     int nkc_arr_append(nkc_array* array, void* data);